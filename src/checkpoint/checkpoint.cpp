@@ -0,0 +1,230 @@
+#include "checkpoint.h"
+#include "../common/clock.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cme::sim::checkpoint {
+
+namespace {
+
+template <typename T>
+void append(std::vector<char>& out, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+OrderRecord toRecord(const Order& order) {
+    OrderRecord rec{};
+    rec.order_id = order.order_id;
+    rec.session_uuid = order.session_uuid;
+    rec.timestamp = order.timestamp;
+    rec.price = order.price.mantissa;
+    rec.stop_price = order.stop_price.mantissa;
+    rec.security_id = order.security_id;
+    rec.smp_id = order.smp_id;
+    rec.quantity = order.quantity;
+    rec.filled_qty = order.filled_qty;
+    rec.display_qty = order.display_qty;
+    rec.shown_qty = order.shown_qty;
+    rec.min_qty = order.min_qty;
+    rec.side = static_cast<uint8_t>(order.side);
+    rec.order_type = static_cast<uint8_t>(order.order_type);
+    rec.time_in_force = static_cast<uint8_t>(order.time_in_force);
+    rec.status = static_cast<uint8_t>(order.status);
+    order.cl_ord_id.toWire(rec.cl_ord_id);
+    return rec;
+}
+
+Order toOrder(const OrderRecord& rec) {
+    Order order;
+    order.order_id = rec.order_id;
+    order.session_uuid = rec.session_uuid;
+    order.timestamp = rec.timestamp;
+    order.price = Price{rec.price};
+    order.stop_price = Price{rec.stop_price};
+    order.security_id = rec.security_id;
+    order.smp_id = rec.smp_id;
+    order.quantity = rec.quantity;
+    order.filled_qty = rec.filled_qty;
+    order.display_qty = rec.display_qty;
+    order.shown_qty = rec.shown_qty;
+    order.min_qty = rec.min_qty;
+    order.side = static_cast<Side>(rec.side);
+    order.order_type = static_cast<OrderType>(rec.order_type);
+    order.time_in_force = static_cast<TimeInForce>(rec.time_in_force);
+    order.status = static_cast<OrdStatus>(rec.status);
+    order.cl_ord_id = ClOrdId::fromWire(rec.cl_ord_id);
+    return order;
+}
+
+// Bounds-checked cursor over the mapped file
+class Cursor {
+public:
+    Cursor(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    const T* take(std::size_t count = 1) {
+        std::size_t bytes = sizeof(T) * count;
+        if (count > size_ / sizeof(T) || bytes > size_ - pos_) return nullptr;
+        const T* p = reinterpret_cast<const T*>(data_ + pos_);
+        pos_ += bytes;
+        return p;
+    }
+
+    std::size_t remaining() const { return size_ - pos_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+bool decode(const char* data, std::size_t size, Checkpoint& checkpoint, std::string& error) {
+    Cursor cursor(data, size);
+    const FileHeader* header = cursor.take<FileHeader>();
+    if (!header || std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not a checkpoint";
+        return false;
+    }
+    if (header->version != VERSION) {
+        error = "unsupported checkpoint version " + std::to_string(header->version);
+        return false;
+    }
+    if (header->file_size != size) {
+        error = "truncated (" + std::to_string(size) + " of " +
+                std::to_string(header->file_size) + " bytes)";
+        return false;
+    }
+
+    checkpoint = Checkpoint{};
+    checkpoint.next_session_uuid = header->next_session_uuid;
+    checkpoint.created_ns = header->created_ns;
+    for (uint32_t s = 0; s < header->shard_count; ++s) {
+        const ShardHeader* shard = cursor.take<ShardHeader>();
+        const BookRecord* books = shard ? cursor.take<BookRecord>(shard->book_count) : nullptr;
+        const OrderRecord* orders = books ? cursor.take<OrderRecord>(shard->order_count) : nullptr;
+        if (!orders) {
+            error = "shard " + std::to_string(s) + " runs past the end of the file";
+            return false;
+        }
+        EngineSnapshot& snap = checkpoint.engines.emplace_back();
+        snap.shard_id = shard->shard_id;
+        snap.next_order_seq = shard->next_order_seq;
+        snap.books.reserve(shard->book_count);
+        for (uint32_t i = 0; i < shard->book_count; ++i) {
+            OrderBook::State state{books[i].next_trade_id, books[i].rpt_seq,
+                                   Price{books[i].last_trade_price}};
+            snap.books.push_back({books[i].security_id, state});
+        }
+        snap.orders.reserve(shard->order_count);
+        for (uint32_t i = 0; i < shard->order_count; ++i) snap.orders.push_back(toOrder(orders[i]));
+    }
+
+    const PositionRecord* positions = cursor.take<PositionRecord>(header->position_count);
+    if (!positions || cursor.remaining() != 0) {
+        error = "position table does not end the file";
+        return false;
+    }
+    for (uint64_t i = 0; i < header->position_count; ++i) {
+        checkpoint.positions.push_back({positions[i].session_uuid, positions[i].security_id,
+                                        positions[i].net_position});
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+bool saveCheckpoint(const std::string& path, const Checkpoint& checkpoint,
+                    std::string& error) {
+    std::vector<char> out;
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.shard_count = static_cast<uint32_t>(checkpoint.engines.size());
+    header.position_count = checkpoint.positions.size();
+    header.next_session_uuid = checkpoint.next_session_uuid;
+    header.created_ns = Clock::epochNanos();
+    append(out, header);
+
+    for (const EngineSnapshot& snap : checkpoint.engines) {
+        ShardHeader shard{};
+        shard.shard_id = snap.shard_id;
+        shard.next_order_seq = snap.next_order_seq;
+        shard.book_count = static_cast<uint32_t>(snap.books.size());
+        shard.order_count = static_cast<uint32_t>(snap.orders.size());
+        append(out, shard);
+        for (const auto& book : snap.books) {
+            append(out, BookRecord{book.security_id, book.state.rpt_seq, book.state.next_trade_id,
+                                   book.state.last_trade_price.mantissa});
+        }
+        for (const Order& order : snap.orders) append(out, toRecord(order));
+    }
+    for (const Position& position : checkpoint.positions) {
+        append(out, PositionRecord{position.session_uuid, position.security_id, {},
+                                   position.net_position});
+    }
+
+    header.file_size = out.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = tmp + ": " + std::strerror(errno);
+        return false;
+    }
+    const char* data = out.data();
+    std::size_t left = out.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, data, left);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            error = tmp + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        data += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        error = path + ": empty or unreadable";
+        return false;
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    ::madvise(p, size, MADV_SEQUENTIAL);
+
+    bool ok = decode(static_cast<const char*>(p), size, checkpoint, error);
+    ::munmap(p, size);
+    if (!ok) error = path + ": " + error;
+    return ok;
+}
+
+} // namespace cme::sim::checkpoint
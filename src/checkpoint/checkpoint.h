@@ -0,0 +1,40 @@
+#pragma once
+#include "checkpoint_format.h"
+#include "../engine/full_matching_engine.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cme::sim::checkpoint {
+
+// Filled net position (+long/-short) of one session in one instrument
+struct Position {
+    uint64_t session_uuid = 0;
+    SecurityId security_id = 0;
+    int64_t net_position = 0;
+
+    bool operator==(const Position&) const = default;
+};
+
+// State of the whole exchange that survives a restart: every engine
+// shard's books, orders and counters, the session UUID allocator (resting
+// orders keep their owners' UUIDs) and risk positions. FIXP sessions live
+// only as long as their TCP connection, so their sequence numbers start
+// over with the next connection and are not part of it.
+struct Checkpoint {
+    std::vector<EngineSnapshot> engines;   // by shard index
+    uint64_t next_session_uuid = 1;
+    std::vector<Position> positions;       // of every engine shard
+    uint64_t created_ns = 0;               // set by saveCheckpoint()
+};
+
+// Write `checkpoint` to `path` (through a temporary file renamed into
+// place). False on any I/O error; `error` then says what failed.
+bool saveCheckpoint(const std::string& path, const Checkpoint& checkpoint,
+                    std::string& error);
+
+// Map `path` and decode it into `checkpoint`. False if the file cannot be
+// read or is not a complete checkpoint; `error` then says why.
+bool loadCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error);
+
+} // namespace cme::sim::checkpoint
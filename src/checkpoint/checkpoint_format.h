@@ -0,0 +1,90 @@
+#pragma once
+#include "../common/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cme::sim::checkpoint {
+
+// ---------------------------------------------------------------------------
+// On-disk layout of an exchange checkpoint.
+//
+//   FileHeader
+//   per engine shard (shard_count):
+//     ShardHeader
+//     BookRecord[book_count]         the shard's books, in layout order
+//     OrderRecord[order_count]       resting orders, book by book, each
+//                                    book's in OrderBook::forEachOrder order
+//   PositionRecord[position_count]   risk net position per session and
+//                                    instrument
+//
+// All structs are raw host-endian bytes, sized to multiples of 8 so every
+// record is aligned in the mapped file. A checkpoint is written to a
+// temporary file and renamed into place, so a reader sees a whole one or
+// the previous one.
+// ---------------------------------------------------------------------------
+
+inline constexpr char MAGIC[8] = {'C', 'M', 'E', 'C', 'K', 'P', 'T', '1'};
+inline constexpr uint32_t VERSION = 2;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t shard_count;
+    uint64_t position_count;
+    uint64_t next_session_uuid;
+    uint64_t created_ns;
+    uint64_t file_size;        // whole file, to catch truncation
+    uint8_t reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct ShardHeader {
+    uint8_t shard_id;
+    uint8_t pad[3];
+    uint32_t next_order_seq;
+    uint32_t book_count;
+    uint32_t order_count;
+};
+static_assert(sizeof(ShardHeader) == 16);
+
+struct BookRecord {
+    int32_t security_id;
+    uint32_t rpt_seq;
+    uint64_t next_trade_id;
+    int64_t last_trade_price;  // Price mantissa (NULL_VALUE if none)
+};
+static_assert(sizeof(BookRecord) == 24);
+
+struct OrderRecord {
+    uint64_t order_id;
+    uint64_t session_uuid;
+    uint64_t timestamp;
+    int64_t price;
+    int64_t stop_price;
+    int32_t security_id;
+    uint32_t smp_id;
+    int32_t quantity;
+    int32_t filled_qty;
+    int32_t display_qty;
+    int32_t shown_qty;
+    int32_t min_qty;
+    uint8_t side;
+    uint8_t order_type;
+    uint8_t time_in_force;
+    uint8_t status;
+    char cl_ord_id[ClOrdId::CAPACITY];
+    uint8_t pad[4];
+};
+static_assert(sizeof(OrderRecord) == 96);
+static_assert(std::is_trivially_copyable_v<OrderRecord>);
+
+struct PositionRecord {
+    uint64_t session_uuid;
+    int32_t security_id;
+    uint8_t pad[4];
+    int64_t net_position;
+};
+static_assert(sizeof(PositionRecord) == 24);
+
+} // namespace cme::sim::checkpoint
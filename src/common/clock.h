@@ -2,6 +2,11 @@
 
 #include <chrono>
 #include <cstdint>
+#include <thread>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
 
 namespace cme::sim {
 
@@ -49,10 +54,56 @@ public:
                 .count());
     }
 
+    // Coarse monotonic milliseconds: the kernel's tick-granular clock (a few
+    // ms resolution) on Linux, which is read without touching the TSC. Good
+    // enough for rate limits on hot paths.
+    static uint64_t coarseMillis() {
+#if defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000ULL +
+               static_cast<uint64_t>(ts.tv_nsec) / 1'000'000ULL;
+#else
+        return nanosToMillis(steadyNanos());
+#endif
+    }
+
+    // Cheapest monotonic counter there is, for latency measurement on hot
+    // paths: the CPU timestamp counter (invariant on anything this runs on)
+    // on x86-64, steadyNanos() elsewhere. Only differences mean anything;
+    // scale them with nanosPerTick().
+    static uint64_t ticks() {
+#if defined(__x86_64__)
+        return __rdtsc();
+#else
+        return steadyNanos();
+#endif
+    }
+
+    // Nanoseconds per ticks() unit, measured against the steady clock on
+    // first use (which takes ~10 ms; call it once off the hot path).
+    static double nanosPerTick() {
+        static const double ratio = calibrateTicks();
+        return ratio;
+    }
+
     // Duration helpers
     static uint64_t nanosToMillis(uint64_t nanos)  { return nanos / 1'000'000ULL; }
     static uint64_t millisToNanos(uint64_t millis)  { return millis * 1'000'000ULL; }
     static uint64_t nanosToMicros(uint64_t nanos)   { return nanos / 1'000ULL; }
+
+private:
+    static double calibrateTicks() {
+#if defined(__x86_64__)
+        uint64_t ns0 = steadyNanos();
+        uint64_t t0 = ticks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t ns1 = steadyNanos();
+        uint64_t t1 = ticks();
+        if (t1 > t0) return static_cast<double>(ns1 - ns0) / static_cast<double>(t1 - t0);
+#endif
+        return 1.0;
+    }
 };
 
 } // namespace cme::sim
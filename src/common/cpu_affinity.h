@@ -0,0 +1,26 @@
+#pragma once
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace cme::sim {
+
+// Pin the calling thread to one CPU. A negative cpu means "not pinned" and
+// succeeds trivially. Returns false if the OS refused (bad CPU index, cpuset
+// restrictions) or pinning is unsupported on this platform.
+inline bool pinCurrentThread(int cpu) {
+    if (cpu < 0) return true;
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace cme::sim
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Fenwick (binary indexed) tree over a fixed number of slots.
+//
+// Point update and prefix sum are both O(log n); used for order-statistic
+// style queries (level rank, cumulative depth) over array-indexed books.
+// ---------------------------------------------------------------------------
+template <typename T>
+class FenwickTree {
+public:
+    FenwickTree() = default;
+    explicit FenwickTree(std::size_t size) : tree_(size + 1, T{}) {}
+
+    // Reset to `size` zeroed slots.
+    void assign(std::size_t size) { tree_.assign(size + 1, T{}); }
+
+    std::size_t size() const { return tree_.empty() ? 0 : tree_.size() - 1; }
+
+    // Add `delta` to slot `index`.
+    void add(std::size_t index, T delta) {
+        for (std::size_t i = index + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i] += delta;
+        }
+    }
+
+    // Sum of slots [0, end).
+    T prefixSum(std::size_t end) const {
+        T sum{};
+        for (std::size_t i = end; i > 0; i -= i & (~i + 1)) {
+            sum += tree_[i];
+        }
+        return sum;
+    }
+
+    // Sum of slots [begin, end).
+    T rangeSum(std::size_t begin, std::size_t end) const {
+        return prefixSum(end) - prefixSum(begin);
+    }
+
+private:
+    std::vector<T> tree_;
+};
+
+} // namespace cme::sim
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+namespace cme::sim {
+
+// Spin-wait hint: lets the sibling hyperthread run and saves power without
+// giving up the core.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+enum class IdleMode : uint8_t {
+    BusySpin,   // never back off; lowest wakeup latency, burns the core
+    SpinPause,  // spin, then cpuRelax() on every idle pass
+    SpinYield,  // spin, then std::this_thread::yield()
+    Sleep       // sleep for a fixed period on every idle pass
+};
+
+inline std::optional<IdleMode> idleModeFromName(std::string_view name) {
+    if (name == "busy_spin")  return IdleMode::BusySpin;
+    if (name == "spin_pause") return IdleMode::SpinPause;
+    if (name == "spin_yield") return IdleMode::SpinYield;
+    if (name == "sleep")      return IdleMode::Sleep;
+    return std::nullopt;
+}
+
+// ---------------------------------------------------------------------------
+// What a polling loop does when a pass found no work.
+//
+// Call idle(did_work) once per loop iteration. Work resets the back-off, so
+// a busy loop never pauses; an idle loop spins for `spin_count` passes before
+// pausing or yielding. Sleep mode keeps the old fixed-sleep behaviour.
+// ---------------------------------------------------------------------------
+class IdleStrategy {
+public:
+    IdleStrategy(IdleMode mode, uint32_t spin_count, std::chrono::microseconds sleep)
+        : mode_(mode), spin_count_(spin_count), sleep_(sleep) {}
+
+    void idle(bool did_work) {
+        if (did_work) {
+            spins_ = 0;
+            return;
+        }
+        switch (mode_) {
+        case IdleMode::BusySpin:
+            break;
+        case IdleMode::SpinPause:
+            if (spins_ < spin_count_) ++spins_;
+            else cpuRelax();
+            break;
+        case IdleMode::SpinYield:
+            if (spins_ < spin_count_) ++spins_;
+            else std::this_thread::yield();
+            break;
+        case IdleMode::Sleep:
+            std::this_thread::sleep_for(sleep_);
+            break;
+        }
+    }
+
+    IdleMode mode() const { return mode_; }
+
+private:
+    IdleMode mode_;
+    uint32_t spin_count_;
+    std::chrono::microseconds sleep_;
+    uint32_t spins_ = 0;
+};
+
+} // namespace cme::sim
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Which network IO thread the caller is: 0..n-1 on IoContextPool threads
+// (set when each starts), -1 on every other thread. Lets producers pick a
+// per-IO-thread lane without passing the index through every callback.
+// ---------------------------------------------------------------------------
+inline thread_local int t_io_thread_index = -1;
+
+inline int ioThreadIndex() { return t_io_thread_index; }
+inline void setIoThreadIndex(int index) { t_io_thread_index = index; }
+
+} // namespace cme::sim
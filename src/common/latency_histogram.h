@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// HDR-style log-linear histogram of latencies.
+//
+// Each power of two is split into 16 linear sub-buckets, so any recorded
+// value is known to within ~6% at a fixed 4.7 KB footprint and record() is
+// a couple of bit operations and an increment. Values are in whatever unit
+// the caller records (Clock::ticks() on the engine thread); not thread
+// safe, keep one per recording thread and merge() for reporting.
+// ---------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1ULL << SUB_BITS;
+    static constexpr int MAX_BIT = 39;   // values >= 2^40 share the top bucket
+    static constexpr std::size_t BUCKETS = (MAX_BIT - SUB_BITS + 2) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        ++counts_[bucketOf(value)];
+        ++count_;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKETS; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() { *this = LatencyHistogram{}; }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Smallest value v such that at least `pct` percent of recordings are
+    // <= v, reported as the top of v's bucket (never above max()).
+    uint64_t percentile(double pct) const {
+        if (count_ == 0) return 0;
+        auto rank = static_cast<uint64_t>(pct / 100.0 * static_cast<double>(count_) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, count_);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(bucketTop(i), max_);
+        }
+        return max_;
+    }
+
+    static std::size_t bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<std::size_t>(value);
+        int bit = static_cast<int>(std::bit_width(value)) - 1;
+        if (bit > MAX_BIT) return BUCKETS - 1;
+        int shift = bit - SUB_BITS;
+        return static_cast<std::size_t>((bit - SUB_BITS + 1) * SUB_BUCKETS +
+                                        ((value >> shift) & (SUB_BUCKETS - 1)));
+    }
+
+    // Largest value that lands in bucket `index`
+    static uint64_t bucketTop(std::size_t index) {
+        if (index < SUB_BUCKETS) return index;
+        int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+        uint64_t low = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return low + (1ULL << shift) - 1;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+} // namespace cme::sim
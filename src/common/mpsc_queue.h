@@ -1,106 +1,152 @@
 #pragma once
 
+#include "idle_strategy.h"
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <thread>
 #include <utility>
 
 namespace cme::sim {
 
 // ---------------------------------------------------------------------------
-// Lock-free multi-producer / single-consumer queue.
+// Bounded lock-free multi-producer / single-consumer ring.
 //
-// Uses a Michael-Scott-style intrusive linked list with atomic push (CAS on
-// head) and single-consumer pop from the tail. Nodes are heap-allocated on
-// push and freed on pop -- suitable for moderate-throughput control paths
-// (e.g., gateway -> engine command submission).
+// Vyukov-style: every slot carries a sequence number that tells producers
+// and the consumer whose turn it is, so a push is one CAS on the enqueue
+// cursor plus a move into a pre-allocated slot, and a pop touches only the
+// slot and the consumer's own cursor. Nothing is allocated after
+// construction. The two cursors sit on separate cache lines.
 //
-// For the hot path (market data fan-out, order matching) prefer SPSCQueue.
+// Capacity is rounded up to a power of two. A full ring makes tryPush()
+// fail; the caller picks the policy (push() spins until there is room).
+// The consumer can drain() everything ready in one pass.
 // ---------------------------------------------------------------------------
 template <typename T>
 class MPSCQueue {
 public:
-    MPSCQueue() {
-        // Sentinel node so that head_ is never null.
-        Node* sentinel = new Node{};
-        head_.store(sentinel, std::memory_order_relaxed);
-        tail_ = sentinel;
-    }
+    static constexpr std::size_t DEFAULT_CAPACITY = 16384;
 
-    ~MPSCQueue() {
-        // Drain remaining nodes.
-        while (tryPop().has_value()) {}
-        // Free the sentinel.
-        delete tail_;
+    explicit MPSCQueue(std::size_t capacity = DEFAULT_CAPACITY)
+        : capacity_(roundUp(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(std::make_unique<Slot[]>(capacity_)) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
     }
 
     // Non-copyable, non-movable
     MPSCQueue(const MPSCQueue&) = delete;
     MPSCQueue& operator=(const MPSCQueue&) = delete;
 
-    // Push (thread-safe, multiple producers).
-    void push(const T& value) {
-        auto* node = new Node{value};
-        pushNode(node);
+    std::size_t capacity() const { return capacity_; }
+
+    // Push (thread-safe, multiple producers). Returns false, leaving
+    // `value` untouched, when the ring is full.
+    bool tryPush(T&& value) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // the consumer has not freed this slot yet
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPush(const T& value) {
+        T copy = value;
+        return tryPush(std::move(copy));
     }
 
+    // Push, spinning while the ring is full (yielding after a while, so a
+    // consumer sharing the core still gets to run)
     void push(T&& value) {
-        auto* node = new Node{std::move(value)};
-        pushNode(node);
+        for (uint32_t spins = 0; !tryPush(std::move(value)); ++spins) {
+            if (spins < 64) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
     }
 
-    template <typename... Args>
-    void emplace(Args&&... args) {
-        auto* node = new Node{T{std::forward<Args>(args)...}};
-        pushNode(node);
+    void push(const T& value) {
+        T copy = value;
+        push(std::move(copy));
     }
 
     // Pop (single consumer only). Returns std::nullopt if empty.
     std::optional<T> tryPop() {
-        Node* sentinel = tail_;
-        Node* next = sentinel->next.load(std::memory_order_acquire);
-        if (!next) {
+        Slot& slot = slots_[dequeue_pos_ & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
             return std::nullopt;
         }
-        // Advance tail past sentinel; sentinel is freed.
-        T value = std::move(next->data);
-        tail_ = next;
-        delete sentinel;
+        std::optional<T> value(std::move(slot.value));
+        release(slot);
         return value;
     }
 
+    // Hand every ready element (up to `max`) to fn(T&&), in order, freeing
+    // each slot as soon as fn returns (single consumer only).
+    template <typename Fn>
+    std::size_t drain(Fn&& fn, std::size_t max = SIZE_MAX) {
+        std::size_t n = 0;
+        while (n < max) {
+            Slot& slot = slots_[dequeue_pos_ & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) break;
+            fn(std::move(slot.value));
+            release(slot);
+            ++n;
+        }
+        return n;
+    }
+
     // Check if empty (consumer side; may race with concurrent pushes).
     bool empty() const {
-        return tail_->next.load(std::memory_order_acquire) == nullptr;
+        return slots_[dequeue_pos_ & mask_].seq.load(std::memory_order_acquire) !=
+               dequeue_pos_ + 1;
     }
 
 private:
-    struct Node {
-        T data{};
-        std::atomic<Node*> next{nullptr};
-
-        Node() = default;
-        explicit Node(const T& v) : data(v) {}
-        explicit Node(T&& v) : data(std::move(v)) {}
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
     };
 
-    void pushNode(Node* node) {
-        // Prepend to the stack (head_) -- but we actually want FIFO order, so
-        // we use the "reverse push" technique: each producer writes its node's
-        // next to the old head, then CAS head to the new node. The consumer
-        // walks next pointers from tail.
-        //
-        // Correct FIFO MPSC: producer sets node->next = nullptr, then stores
-        // into prev->next after xchg on head_.
-        node->next.store(nullptr, std::memory_order_relaxed);
-        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
-        prev->next.store(node, std::memory_order_release);
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Hand the slot back to producers; its moved-from value is overwritten
+    // by the next push
+    void release(Slot& slot) {
+        slot.seq.store(dequeue_pos_ + capacity_, std::memory_order_release);
+        ++dequeue_pos_;
     }
 
-    // head_ is the last node pushed (newest). Producers CAS on it.
-    alignas(64) std::atomic<Node*> head_{nullptr};
-    // tail_ is the sentinel before the oldest unconsumed node. Consumer only.
-    alignas(64) Node* tail_{nullptr};
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Producers CAS on enqueue_pos_; dequeue_pos_ is the consumer's alone.
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) uint64_t dequeue_pos_{0};
 };
 
 } // namespace cme::sim
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <optional>
+#include <utility>
 #include <rigtorp/SPSCQueue.h>
 
 namespace cme::sim {
@@ -56,6 +57,18 @@ public:
         queue_.pop();
     }
 
+    // Hand up to `max` ready elements to fn(T&&), in order, popping each
+    // as soon as fn returns. Returns how many there were.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn, std::size_t max) {
+        std::size_t n = 0;
+        for (T* front; n < max && (front = queue_.front()); ++n) {
+            fn(std::move(*front));
+            queue_.pop();
+        }
+        return n;
+    }
+
     // Approximate size (not guaranteed accurate under contention).
     std::size_t size() const {
         return queue_.size();
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <climits>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <type_traits>
 
 namespace cme::sim {
 
@@ -11,11 +15,62 @@ namespace cme::sim {
 // Scalar type aliases
 // ---------------------------------------------------------------------------
 using OrderId    = uint64_t;
-using ClOrdId    = std::string;
 using SecurityId = int32_t;
 using SeqNum     = uint32_t;
 using Timestamp  = uint64_t; // nanoseconds since epoch
 
+// ---------------------------------------------------------------------------
+// Client order ID (iLink 3 String20: 20 bytes, NUL-padded)
+//
+// Stored inline so orders and engine events copy it with a memcpy instead
+// of a std::string. Values longer than 20 bytes are truncated, matching the
+// wire field. Bytes after the first NUL are always zero, so equality is a
+// plain byte compare.
+// ---------------------------------------------------------------------------
+class ClOrdId {
+public:
+    static constexpr std::size_t CAPACITY = 20;
+
+    constexpr ClOrdId() = default;
+    ClOrdId(std::string_view s) { assign(s.data(), s.size()); }
+    ClOrdId(const std::string& s) { assign(s.data(), s.size()); }
+    ClOrdId(const char* s) { assign(s, s ? std::strlen(s) : 0); }
+
+    // Read a raw wire field of `len` bytes, stopping at the first NUL.
+    static ClOrdId fromWire(const char* src, std::size_t len = CAPACITY) {
+        ClOrdId id;
+        id.assign(src, strnlen(src, len));
+        return id;
+    }
+
+    // Write as a NUL-padded field of `len` bytes.
+    void toWire(char* dest, std::size_t len = CAPACITY) const {
+        std::size_t n = len < CAPACITY ? len : CAPACITY;
+        std::memcpy(dest, data_, n);
+        if (len > n) std::memset(dest + n, 0, len - n);
+    }
+
+    const char* data() const { return data_; }  // not NUL-terminated at 20
+    std::size_t size() const { return strnlen(data_, CAPACITY); }
+    bool empty() const { return data_[0] == '\0'; }
+    std::string_view view() const { return {data_, size()}; }
+    std::string str() const { return std::string(view()); }
+
+    bool operator==(const ClOrdId& o) const { return std::memcmp(data_, o.data_, CAPACITY) == 0; }
+    bool operator!=(const ClOrdId& o) const { return !(*this == o); }
+
+private:
+    char data_[CAPACITY]{};
+
+    void assign(const char* s, std::size_t n) {
+        if (n > CAPACITY) n = CAPACITY;
+        if (n) std::memcpy(data_, s, n);
+        std::memset(data_ + n, 0, CAPACITY - n);
+    }
+};
+static_assert(std::is_trivially_copyable_v<ClOrdId>);
+static_assert(sizeof(ClOrdId) == ClOrdId::CAPACITY);
+
 // ---------------------------------------------------------------------------
 // Fixed-point price (PRICENULL9: mantissa * 10^-9)
 // ---------------------------------------------------------------------------
@@ -53,6 +108,10 @@ enum class Side : uint8_t {
     Sell = 2
 };
 
+constexpr Side opposite(Side side) {
+    return side == Side::Buy ? Side::Sell : Side::Buy;
+}
+
 enum class OrderType : uint8_t {
     Market    = 1,
     Limit     = 2,
@@ -97,7 +156,9 @@ enum class MDUpdateAction : uint8_t {
 enum class MDEntryType : char {
     Bid   = '0',
     Offer = '1',
-    Trade = '2'
+    Trade = '2',
+    ImpliedBid   = 'E',
+    ImpliedOffer = 'F'
 };
 
 enum class SecurityTradingStatus : uint8_t {
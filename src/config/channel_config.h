@@ -66,16 +66,20 @@ inline std::vector<InstrumentConfig> createDefaultInstruments() {
     std::vector<InstrumentConfig> instruments;
 
     // Channel 310: ES
-    instruments.push_back({"ESH5",  1, 310, 0.25, 50.0, 12.50, 1, 10000, "202503", 0.01});
-    instruments.push_back({"ESM5",  2, 310, 0.25, 50.0, 12.50, 1, 10000, "202506", 0.01});
+    instruments.push_back({"ESH5",  1, 310, 0.25, 50.0, 12.50, 1, 10000, "202503", 0.01, "ladder"});
+    instruments.push_back({"ESM5",  2, 310, 0.25, 50.0, 12.50, 1, 10000, "202506", 0.01, "ladder"});
 
     // Channel 310: MES
     instruments.push_back({"MESH5", 3, 310, 0.25,  5.0,  1.25, 1, 10000, "202503", 0.01});
     instruments.push_back({"MESM5", 4, 310, 0.25,  5.0,  1.25, 1, 10000, "202506", 0.01});
 
+    // Channel 310: ES calendar spread (front - back)
+    instruments.push_back({"ESH5-ESM5", 17, 310, 0.05, 50.0, 2.50, 1, 10000, "202503", 0.01,
+                           "map", 4096, {"ESH5", "ESM5"}});
+
     // Channel 311: NQ
-    instruments.push_back({"NQH5",  5, 311, 0.25, 20.0,  5.00, 1, 10000, "202503", 0.01});
-    instruments.push_back({"NQM5",  6, 311, 0.25, 20.0,  5.00, 1, 10000, "202506", 0.01});
+    instruments.push_back({"NQH5",  5, 311, 0.25, 20.0,  5.00, 1, 10000, "202503", 0.01, "ladder"});
+    instruments.push_back({"NQM5",  6, 311, 0.25, 20.0,  5.00, 1, 10000, "202506", 0.01, "ladder"});
 
     // Channel 311: MNQ
     instruments.push_back({"MNQH5", 7, 311, 0.25,  2.0,  0.50, 1, 10000, "202503", 0.01});
@@ -36,6 +36,20 @@ ChannelConfig parseChannel(const YAML::Node& node) {
     return ch;
 }
 
+LiquidityConfig parseLiquidity(const YAML::Node& node) {
+    LiquidityConfig liq;
+    if (!node || !node.IsMap()) return liq;
+    if (node["enabled"])         liq.enabled = node["enabled"].as<bool>();
+    if (node["reference_price"]) liq.reference_price = node["reference_price"].as<double>();
+    if (node["depth"])           liq.depth = node["depth"].as<int>();
+    if (node["spread_ticks"])    liq.spread_ticks = node["spread_ticks"].as<int>();
+    if (node["level_ticks"])     liq.level_ticks = node["level_ticks"].as<int>();
+    if (node["qty"])             liq.qty = node["qty"].as<int32_t>();
+    if (node["requote_ms"])      liq.requote_ms = node["requote_ms"].as<int>();
+    if (node["walk_ticks"])      liq.walk_ticks = node["walk_ticks"].as<int>();
+    return liq;
+}
+
 InstrumentConfig parseInstrument(const YAML::Node& node) {
     InstrumentConfig inst;
     if (node["symbol"])                   inst.symbol = node["symbol"].as<std::string>();
@@ -46,8 +60,13 @@ InstrumentConfig parseInstrument(const YAML::Node& node) {
     if (node["min_price_increment_amount"]) inst.min_price_increment_amount = node["min_price_increment_amount"].as<double>();
     if (node["min_trade_vol"])            inst.min_trade_vol = node["min_trade_vol"].as<int32_t>();
     if (node["max_trade_vol"])            inst.max_trade_vol = node["max_trade_vol"].as<int32_t>();
+    if (node["max_position"])             inst.max_position = node["max_position"].as<int64_t>();
     if (node["maturity_month_year"])      inst.maturity_month_year = node["maturity_month_year"].as<std::string>();
     if (node["display_factor"])           inst.display_factor = node["display_factor"].as<double>();
+    if (node["book_type"])                inst.book_type = node["book_type"].as<std::string>();
+    if (node["ladder_ticks"])             inst.ladder_ticks = node["ladder_ticks"].as<int32_t>();
+    if (node["legs"])                     inst.legs = node["legs"].as<std::vector<std::string>>();
+    if (node["liquidity"])                inst.liquidity = parseLiquidity(node["liquidity"]);
     return inst;
 }
 
@@ -69,15 +88,69 @@ EngineConfig parseEngine(const YAML::Node& node) {
     if (node["pcap_path"])                 eng.pcap_path = node["pcap_path"].as<std::string>();
     if (node["synthetic_fill_probability"]) eng.synthetic_fill_probability = node["synthetic_fill_probability"].as<double>();
     if (node["synthetic_fill_latency_ns"])  eng.synthetic_fill_latency_ns = node["synthetic_fill_latency_ns"].as<uint64_t>();
+    if (node["md_book_depth"])             eng.md_book_depth = node["md_book_depth"].as<int>();
+    if (node["shard_by_channel"])          eng.shard_by_channel = node["shard_by_channel"].as<bool>();
+    if (node["idle_strategy"])             eng.idle_strategy = node["idle_strategy"].as<std::string>();
+    if (node["idle_spin_count"])           eng.idle_spin_count = node["idle_spin_count"].as<uint32_t>();
+    if (node["idle_sleep_us"])             eng.idle_sleep_us = node["idle_sleep_us"].as<int>();
+    if (node["smp_mode"])                  eng.smp_mode = node["smp_mode"].as<std::string>();
+    if (node["implied_depth"])             eng.implied_depth = node["implied_depth"].as<int>();
+    if (node["command_queue_capacity"])    eng.command_queue_capacity = node["command_queue_capacity"].as<int>();
+    if (node["queue_full_policy"])         eng.queue_full_policy = node["queue_full_policy"].as<std::string>();
     return eng;
 }
 
+// Accepts either a single CPU or a list (one per thread).
+std::vector<int> parseCpuList(const YAML::Node& node) {
+    if (node.IsSequence()) return node.as<std::vector<int>>();
+    return {node.as<int>()};
+}
+
+CpuAffinityConfig parseCpuAffinity(const YAML::Node& node) {
+    CpuAffinityConfig aff;
+    if (!node || !node.IsMap()) return aff;
+    if (node["engine"])      aff.engine = parseCpuList(node["engine"]);
+    if (node["io"])          aff.io = parseCpuList(node["io"]);
+    if (node["market_data"]) aff.market_data = node["market_data"].as<int>();
+    if (node["timer"])       aff.timer = node["timer"].as<int>();
+    return aff;
+}
+
+JournalConfig parseJournal(const YAML::Node& node) {
+    JournalConfig journal;
+    if (!node || !node.IsMap()) return journal;
+    if (node["enabled"])        journal.enabled = node["enabled"].as<bool>();
+    if (node["path"])           journal.path = node["path"].as<std::string>();
+    if (node["queue_capacity"]) journal.queue_capacity = node["queue_capacity"].as<int>();
+    if (node["cpu"])            journal.cpu = node["cpu"].as<int>();
+    return journal;
+}
+
+CheckpointConfig parseCheckpoint(const YAML::Node& node) {
+    CheckpointConfig checkpoint;
+    if (!node || !node.IsMap()) return checkpoint;
+    if (node["enabled"])          checkpoint.enabled = node["enabled"].as<bool>();
+    if (node["path"])             checkpoint.path = node["path"].as<std::string>();
+    if (node["load_on_start"])    checkpoint.load_on_start = node["load_on_start"].as<bool>();
+    if (node["save_on_shutdown"]) checkpoint.save_on_shutdown = node["save_on_shutdown"].as<bool>();
+    return checkpoint;
+}
+
+LatencyConfig parseLatency(const YAML::Node& node) {
+    LatencyConfig latency;
+    if (!node || !node.IsMap()) return latency;
+    if (node["enabled"])           latency.enabled = node["enabled"].as<bool>();
+    if (node["report_interval_s"]) latency.report_interval_s = node["report_interval_s"].as<int>();
+    return latency;
+}
+
 RiskConfig parseRisk(const YAML::Node& node) {
     RiskConfig risk;
     if (!node || !node.IsMap()) return risk;
     if (node["max_order_qty"])           risk.max_order_qty = node["max_order_qty"].as<int32_t>();
     if (node["max_price_deviation_pct"]) risk.max_price_deviation_pct = node["max_price_deviation_pct"].as<double>();
     if (node["max_orders_per_second"])   risk.max_orders_per_second = node["max_orders_per_second"].as<int32_t>();
+    if (node["max_order_burst"])         risk.max_order_burst = node["max_order_burst"].as<int32_t>();
     if (node["max_position_per_session"]) risk.max_position_per_session = node["max_position_per_session"].as<int64_t>();
     return risk;
 }
@@ -90,6 +163,7 @@ SessionConfig parseSession(const YAML::Node& node) {
     if (node["keep_alive_interval_ms"]) sess.keep_alive_interval_ms = node["keep_alive_interval_ms"].as<uint32_t>();
     if (node["max_sessions"])           sess.max_sessions = node["max_sessions"].as<int>();
     if (node["retransmit_buffer_size"]) sess.retransmit_buffer_size = node["retransmit_buffer_size"].as<int>();
+    if (node["cancel_on_disconnect"])   sess.cancel_on_disconnect = node["cancel_on_disconnect"].as<bool>();
     return sess;
 }
 
@@ -121,6 +195,71 @@ void validateConfig(const ExchangeConfig& config) {
     if (config.engine.synthetic_fill_probability < 0.0 || config.engine.synthetic_fill_probability > 1.0) {
         throw ConfigValidationError("synthetic_fill_probability must be between 0.0 and 1.0");
     }
+    if (config.engine.md_book_depth < 0 || config.engine.md_book_depth > 255) {
+        throw ConfigValidationError("md_book_depth must be between 0 and 255");
+    }
+    if (config.engine.shard_by_channel && config.channels.size() > 256) {
+        throw ConfigValidationError("shard_by_channel supports at most 256 channels");
+    }
+    const auto& idle = config.engine.idle_strategy;
+    if (idle != "busy_spin" && idle != "spin_pause" && idle != "spin_yield" && idle != "sleep") {
+        throw ConfigValidationError(
+            "engine.idle_strategy must be 'busy_spin', 'spin_pause', 'spin_yield' or 'sleep', got: " + idle);
+    }
+    if (config.engine.idle_sleep_us < 0) {
+        throw ConfigValidationError("idle_sleep_us must be non-negative");
+    }
+    const auto& smp = config.engine.smp_mode;
+    if (smp != "none" && smp != "cancel_resting" && smp != "cancel_aggressor" && smp != "cancel_both") {
+        throw ConfigValidationError(
+            "engine.smp_mode must be 'none', 'cancel_resting', 'cancel_aggressor' or 'cancel_both', got: " + smp);
+    }
+    if (config.engine.implied_depth < 1 || config.engine.implied_depth > 10) {
+        throw ConfigValidationError("implied_depth must be between 1 and 10");
+    }
+    // Implied levels are refreshed from the legs' published BookUpdates
+    if (config.engine.md_book_depth > 0 && config.engine.implied_depth > config.engine.md_book_depth) {
+        throw ConfigValidationError("implied_depth cannot exceed md_book_depth");
+    }
+    if (config.engine.command_queue_capacity < 2 ||
+        config.engine.command_queue_capacity > (1 << 24)) {
+        throw ConfigValidationError("command_queue_capacity must be between 2 and 16777216");
+    }
+    if (config.engine.queue_full_policy != "reject" && config.engine.queue_full_policy != "spin") {
+        throw ConfigValidationError("queue_full_policy must be 'reject' or 'spin', got: " +
+                                    config.engine.queue_full_policy);
+    }
+
+    // Validate CPU affinity (-1 = not pinned)
+    auto checkCpu = [](int cpu) {
+        if (cpu < -1) {
+            throw ConfigValidationError("cpu_affinity entries must be -1 or a CPU index, got: " +
+                                        std::to_string(cpu));
+        }
+    };
+    for (int cpu : config.cpu_affinity.engine) checkCpu(cpu);
+    for (int cpu : config.cpu_affinity.io) checkCpu(cpu);
+    checkCpu(config.cpu_affinity.market_data);
+    checkCpu(config.cpu_affinity.timer);
+    checkCpu(config.journal.cpu);
+
+    // Validate journal
+    if (config.journal.enabled && config.journal.path.empty()) {
+        throw ConfigValidationError("journal.path is required when the journal is enabled");
+    }
+    if (config.journal.queue_capacity <= 0) {
+        throw ConfigValidationError("journal.queue_capacity must be positive");
+    }
+
+    // Validate checkpoint
+    if (config.checkpoint.enabled && config.checkpoint.path.empty()) {
+        throw ConfigValidationError("checkpoint.path is required when checkpoints are enabled");
+    }
+
+    // Validate latency reporting
+    if (config.latency.report_interval_s < 0) {
+        throw ConfigValidationError("latency.report_interval_s must be non-negative");
+    }
 
     // Validate risk limits
     if (config.risk.max_order_qty <= 0) {
@@ -132,6 +271,12 @@ void validateConfig(const ExchangeConfig& config) {
     if (config.risk.max_orders_per_second <= 0) {
         throw ConfigValidationError("max_orders_per_second must be positive");
     }
+    if (config.risk.max_order_burst < 0) {
+        throw ConfigValidationError("max_order_burst must be non-negative");
+    }
+    if (config.risk.max_position_per_session <= 0) {
+        throw ConfigValidationError("max_position_per_session must be positive");
+    }
 
     // Validate session config
     if (config.session.max_sessions <= 0) {
@@ -183,6 +328,32 @@ void validateConfig(const ExchangeConfig& config) {
         if (inst.max_trade_vol < inst.min_trade_vol) {
             throw ConfigValidationError("max_trade_vol must be >= min_trade_vol for " + inst.symbol);
         }
+        if (inst.max_position < 0) {
+            throw ConfigValidationError("max_position must be non-negative for " + inst.symbol);
+        }
+        if (inst.book_type != "map" && inst.book_type != "ladder") {
+            throw ConfigValidationError("book_type must be 'map' or 'ladder' for " + inst.symbol +
+                                        ", got: " + inst.book_type);
+        }
+        if (inst.ladder_ticks <= 0) {
+            throw ConfigValidationError("ladder_ticks must be positive for " + inst.symbol);
+        }
+        if (inst.liquidity.enabled) {
+            const LiquidityConfig& liq = inst.liquidity;
+            if (liq.depth <= 0 || liq.qty <= 0) {
+                throw ConfigValidationError("liquidity depth and qty must be positive for " + inst.symbol);
+            }
+            if (liq.spread_ticks < 1 || liq.level_ticks < 1) {
+                throw ConfigValidationError("liquidity spread_ticks and level_ticks must be at least 1 for " +
+                                            inst.symbol);
+            }
+            if (liq.requote_ms <= 0) {
+                throw ConfigValidationError("liquidity requote_ms must be positive for " + inst.symbol);
+            }
+            if (liq.walk_ticks < 0) {
+                throw ConfigValidationError("liquidity walk_ticks must be non-negative for " + inst.symbol);
+            }
+        }
         // Verify instrument's channel_id exists
         if (channel_ids.find(inst.channel_id) == channel_ids.end() && !config.channels.empty()) {
             throw ConfigValidationError("Instrument " + inst.symbol + " references unknown channel_id " +
@@ -190,6 +361,29 @@ void validateConfig(const ExchangeConfig& config) {
         }
     }
 
+    // Validate spread legs: two distinct outrights on the spread's channel,
+    // so the spread and its legs always share an engine shard
+    for (const auto& inst : config.instruments) {
+        if (inst.legs.empty()) continue;
+        if (inst.legs.size() != 2 || inst.legs[0] == inst.legs[1]) {
+            throw ConfigValidationError("Spread " + inst.symbol + " must list two different legs");
+        }
+        for (const auto& leg_symbol : inst.legs) {
+            auto leg = std::find_if(config.instruments.begin(), config.instruments.end(),
+                                    [&](const InstrumentConfig& ic) { return ic.symbol == leg_symbol; });
+            if (leg == config.instruments.end()) {
+                throw ConfigValidationError("Spread " + inst.symbol + " references unknown leg " + leg_symbol);
+            }
+            if (!leg->legs.empty()) {
+                throw ConfigValidationError("Spread " + inst.symbol + " leg " + leg_symbol + " is itself a spread");
+            }
+            if (leg->channel_id != inst.channel_id) {
+                throw ConfigValidationError("Spread " + inst.symbol + " leg " + leg_symbol +
+                                            " must be on channel " + std::to_string(inst.channel_id));
+            }
+        }
+    }
+
     // Validate log level
     static const std::set<std::string> valid_levels = {"trace", "debug", "info", "warn", "error", "critical", "off"};
     if (valid_levels.find(config.log_level) == valid_levels.end()) {
@@ -222,6 +416,22 @@ ExchangeConfig loadConfig(const std::string& path) {
         config.session = parseSession(root["session"]);
     }
 
+    if (root["cpu_affinity"]) {
+        config.cpu_affinity = parseCpuAffinity(root["cpu_affinity"]);
+    }
+
+    if (root["journal"]) {
+        config.journal = parseJournal(root["journal"]);
+    }
+
+    if (root["checkpoint"]) {
+        config.checkpoint = parseCheckpoint(root["checkpoint"]);
+    }
+
+    if (root["latency"]) {
+        config.latency = parseLatency(root["latency"]);
+    }
+
     if (root["log_level"]) {
         config.log_level = root["log_level"].as<std::string>();
     }
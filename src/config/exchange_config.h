@@ -29,6 +29,18 @@ struct ChannelConfig {
     std::vector<std::string> symbols;
 };
 
+// Built-in market maker quoting one instrument (engine side, no FIXP session)
+struct LiquidityConfig {
+    bool enabled = false;
+    double reference_price = 0.0; // mid the ladder is built around
+    int depth = 5;                // levels per side
+    int spread_ticks = 1;         // best bid to best ask
+    int level_ticks = 1;          // between consecutive levels
+    int32_t qty = 10;             // per level
+    int requote_ms = 100;
+    int walk_ticks = 0;           // max random move of the reference per requote
+};
+
 struct InstrumentConfig {
     std::string symbol;
     int32_t security_id = 0;
@@ -40,6 +52,12 @@ struct InstrumentConfig {
     int32_t max_trade_vol = 10000;
     std::string maturity_month_year; // e.g. "202503"
     double display_factor = 0.01;
+    std::string book_type = "map";   // "map" or "ladder" (tick-indexed levels)
+    int32_t ladder_ticks = 4096;     // initial ladder window per side, in ticks
+    std::vector<std::string> legs{}; // calendar spread: {front, back} symbols,
+                                     // priced front - back; empty = outright
+    LiquidityConfig liquidity{};
+    int64_t max_position = 0;        // per-session position limit; 0 = risk default
 };
 
 struct EngineConfig {
@@ -47,13 +65,23 @@ struct EngineConfig {
     std::string pcap_path; // for synthetic mode
     double synthetic_fill_probability = 1.0;
     uint64_t synthetic_fill_latency_ns = 1000;
+    int md_book_depth = 10; // book levels published on MDP; 0 = unlimited
+    bool shard_by_channel = false; // one engine thread + book shard per channel
+    std::string idle_strategy = "sleep"; // busy_spin, spin_pause, spin_yield, sleep
+    uint32_t idle_spin_count = 10000;    // idle passes before pause/yield
+    int idle_sleep_us = 10;              // sleep per idle pass ("sleep" only)
+    std::string smp_mode = "none"; // none, cancel_resting, cancel_aggressor, cancel_both
+    int implied_depth = 2;         // implied levels per side derived for spreads and legs
+    int command_queue_capacity = 16384;        // per engine shard, rounded up to a power of 2
+    std::string queue_full_policy = "reject";  // "reject" (throttle response) or "spin"
 };
 
 struct RiskConfig {
     int32_t max_order_qty = 10000;
-    double max_price_deviation_pct = 10.0; // from last trade
-    int32_t max_orders_per_second = 1000;
-    int64_t max_position_per_session = 50000;
+    double max_price_deviation_pct = 10.0; // band around the last trade (outrights)
+    int32_t max_orders_per_second = 1000;  // sustained, per session
+    int32_t max_order_burst = 0;           // back to back; 0 = max_orders_per_second
+    int64_t max_position_per_session = 50000;  // per instrument, open orders included
 };
 
 struct SessionConfig {
@@ -62,6 +90,40 @@ struct SessionConfig {
     uint32_t keep_alive_interval_ms = 30000;
     int max_sessions = 100;
     int retransmit_buffer_size = 10000;
+    bool cancel_on_disconnect = true;  // cancel a session's resting orders when its TCP connection drops
+};
+
+// Binary journal of the commands each engine shard runs, for replay
+// (tools/journal_replay). One file per shard: <path>/shard-<n>.journal
+struct JournalConfig {
+    bool enabled = false;
+    std::string path = "journal";     // directory, created if missing
+    int queue_capacity = 65536;       // records in flight per shard
+    int cpu = -1;                     // writer threads' CPU; -1 = not pinned
+};
+
+// Checkpoint of books, engine counters, session UUIDs and risk positions,
+// loaded at startup and written at shutdown for a warm restart
+struct CheckpointConfig {
+    bool enabled = false;
+    std::string path = "checkpoint/exchange.ckpt";
+    bool load_on_start = true;        // a missing file means a cold start
+    bool save_on_shutdown = true;
+};
+
+// Engine-thread latency histograms (queue wait, match, exec-report encode)
+// per instrument and command type, logged periodically and at shutdown
+struct LatencyConfig {
+    bool enabled = false;
+    int report_interval_s = 60;       // 0 = only at shutdown
+};
+
+// CPU each thread group is pinned to; -1 (or a missing entry) = not pinned.
+struct CpuAffinityConfig {
+    std::vector<int> engine;   // one entry per engine thread (shard)
+    std::vector<int> io;       // one entry per IO pool thread
+    int market_data = -1;      // MDP io, snapshot and instrument-def threads
+    int timer = -1;            // session keepalive timer
 };
 
 struct ExchangeConfig {
@@ -71,6 +133,10 @@ struct ExchangeConfig {
     EngineConfig engine;
     RiskConfig risk;
     SessionConfig session;
+    CpuAffinityConfig cpu_affinity;
+    JournalConfig journal;
+    CheckpointConfig checkpoint;
+    LatencyConfig latency;
     std::string log_level = "info";
 };
 
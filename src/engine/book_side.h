@@ -0,0 +1,190 @@
+#pragma once
+#include "price_level.h"
+#include "price_ladder.h"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace cme::sim {
+
+// Storage used for the price levels of an OrderBook.
+enum class BookBackend : uint8_t {
+    Map,         // std::map keyed by price; works for any price
+    TickLadder   // contiguous tick-indexed array (see PriceLadder)
+};
+
+// What happens when an aggressor would trade with a resting order from the
+// same SMP group (Order::smp_id).
+enum class SmpMode : uint8_t {
+    None,             // self-matching allowed
+    CancelResting,    // cancel the resting order, keep sweeping (CME "oldest")
+    CancelAggressor,  // cancel the aggressor's remainder (CME "newest")
+    CancelBoth
+};
+
+struct BookConfig {
+    BookBackend backend = BookBackend::Map;
+    int64_t tick_mantissa = 0;          // required for TickLadder
+    std::size_t ladder_ticks = 4096;    // initial ladder window per side
+    int max_published_depth = 0;        // 0 = unlimited; deeper levels get no BookUpdate
+    SmpMode smp_mode = SmpMode::None;
+    bool index_orders = true;           // keep an OrderId -> Order* map for
+                                        // cancel/modify by id; off when the
+                                        // owner resolves ids itself
+};
+
+// ---------------------------------------------------------------------------
+// One side of an order book: price levels ordered best-first, backed either
+// by a std::map or by a PriceLadder. Iteration yields
+// std::pair<const Price, PriceLevel> in priority order for both backends.
+// ---------------------------------------------------------------------------
+template <Side S>
+class BookSide {
+    using Compare = std::conditional_t<S == Side::Buy, std::greater<Price>, std::less<Price>>;
+    using Map = std::map<Price, PriceLevel, Compare>;
+    using Ladder = PriceLadder<S>;
+
+public:
+    using value_type = std::pair<const Price, PriceLevel>;
+
+    class const_iterator {
+    public:
+        using value_type = BookSide::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+
+        reference operator*() const { return ladder_ ? ladder_->slot(idx_) : *it_; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            if (ladder_) idx_ = ladder_->nextWorse(idx_);
+            else ++it_;
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+
+        bool operator==(const const_iterator& o) const {
+            return ladder_ ? idx_ == o.idx_ : it_ == o.it_;
+        }
+
+    private:
+        friend class BookSide;
+        explicit const_iterator(typename Map::const_iterator it) : it_(it) {}
+        const_iterator(const Ladder* ladder, int idx) : ladder_(ladder), idx_(idx) {}
+
+        typename Map::const_iterator it_{};
+        const Ladder* ladder_ = nullptr;
+        int idx_ = Ladder::NONE;
+    };
+
+    explicit BookSide(const BookConfig& config) {
+        if (config.backend == BookBackend::TickLadder) {
+            ladder_.emplace(config.tick_mantissa, config.ladder_ticks);
+        }
+    }
+
+    // Whether a level at this price can be stored (always true for the map).
+    bool accepts(Price price) const {
+        return ladder_ ? ladder_->accepts(price) : true;
+    }
+
+    PriceLevel* best() {
+        if (ladder_) return ladder_->best();
+        return map_.empty() ? nullptr : &map_.begin()->second;
+    }
+
+    PriceLevel* find(Price price) {
+        if (ladder_) return ladder_->find(price);
+        auto it = map_.find(price);
+        return it == map_.end() ? nullptr : &it->second;
+    }
+
+    // Find or create the level at `price`. Returns {level, created}.
+    std::pair<PriceLevel*, bool> insert(Price price) {
+        if (ladder_) return ladder_->insert(price);
+        auto [it, inserted] = map_.try_emplace(price);
+        if (inserted) it->second.price = price;
+        return {&it->second, inserted};
+    }
+
+    // Remove an empty level.
+    void erase(PriceLevel* level) {
+        if (ladder_) {
+            ladder_->erase(level);
+        } else {
+            Price price = level->price;
+            map_.erase(price);
+        }
+    }
+
+    // 1-based rank of the level at `price` (existing or not), counting only
+    // levels strictly better. Returns 0 once the rank exceeds `max_depth`
+    // (when non-zero); the map walk stops there instead of scanning the side.
+    int rank(Price price, int max_depth) const {
+        if (ladder_) {
+            int r = 1 + ladder_->countBetter(price);
+            return (max_depth > 0 && r > max_depth) ? 0 : r;
+        }
+        int r = 1;
+        for (const auto& [p, level] : map_) {
+            if (!isBetter(p, price)) break;
+            if (max_depth > 0 && r >= max_depth) return 0;
+            ++r;
+        }
+        return r;
+    }
+
+    // Report a change in executable quantity at `price`. The ladder keeps a
+    // cumulative depth tree; the map sums levels on demand instead.
+    void addDepth(Price price, int64_t delta) {
+        if (ladder_) ladder_->addDepth(price, delta);
+    }
+
+    // True if the levels a taker with this `limit` can reach (every level
+    // when `limit` is null) hold at least `needed` executable quantity.
+    // O(log n) on the ladder; the map walks levels until satisfied.
+    bool hasDepth(Price limit, Quantity needed) const {
+        if (ladder_) {
+            int64_t depth = limit.isNull() ? ladder_->depthTotal() : ladder_->depthThrough(limit);
+            return depth >= needed;
+        }
+        int64_t depth = 0;
+        for (const auto& [p, level] : map_) {
+            if (!limit.isNull() && isBetter(limit, p)) break;
+            depth += int64_t{level.total_quantity} + level.hidden_quantity;
+            if (depth >= needed) return true;
+        }
+        return depth >= needed;
+    }
+
+    int size() const { return ladder_ ? ladder_->size() : static_cast<int>(map_.size()); }
+    bool empty() const { return size() == 0; }
+
+    const_iterator begin() const {
+        if (ladder_) return const_iterator(&*ladder_, ladder_->bestIndex());
+        return const_iterator(map_.begin());
+    }
+    const_iterator end() const {
+        if (ladder_) return const_iterator(&*ladder_, Ladder::NONE);
+        return const_iterator(map_.end());
+    }
+
+    BookBackend backend() const { return ladder_ ? BookBackend::TickLadder : BookBackend::Map; }
+
+    // True if price `a` has priority over price `b` on this side.
+    static bool isBetter(Price a, Price b) { return Compare{}(a, b); }
+
+private:
+    Map map_;
+    std::optional<Ladder> ladder_;
+};
+
+} // namespace cme::sim
@@ -0,0 +1,57 @@
+#include "book_snapshot_source.h"
+
+namespace cme::sim {
+
+bool BookSnapshotSource::request(SecurityId security_id, Image& out) {
+    const OrderBook* book = engine_.getOrderBook(security_id);
+    if (!book) return false;
+
+    std::lock_guard<std::mutex> requester(requester_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!closed_) {
+        done_ = false;
+        pending_.store(security_id, std::memory_order_relaxed);
+        served_.wait_for(lock, WAIT, [this] { return done_ || closed_; });
+        if (done_) {
+            out = std::move(image_);
+            return true;
+        }
+        pending_.store(0, std::memory_order_relaxed);
+        if (!closed_) return false;
+    }
+    copyBook(*book, out);
+    return true;
+}
+
+void BookSnapshotSource::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    served_.notify_all();
+}
+
+void BookSnapshotSource::fulfil() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The requester may have given up since serve() looked
+    SecurityId security_id = pending_.exchange(0, std::memory_order_relaxed);
+    if (security_id == 0) return;
+    if (const OrderBook* book = engine_.getOrderBook(security_id)) copyBook(*book, image_);
+    done_ = true;
+    served_.notify_one();
+}
+
+void BookSnapshotSource::copyBook(const OrderBook& book, Image& out) {
+    out.bids.clear();
+    out.asks.clear();
+    out.bid_counts.clear();
+    out.ask_counts.clear();
+    for (const auto& [price, level] : book.bidLevels()) {
+        out.bids.emplace_back(price, level.total_quantity);
+        out.bid_counts.push_back(level.order_count);
+    }
+    for (const auto& [price, level] : book.askLevels()) {
+        out.asks.emplace_back(price, level.total_quantity);
+        out.ask_counts.push_back(level.order_count);
+    }
+}
+
+} // namespace cme::sim
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../common/types.h"
+#include "full_matching_engine.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Copies of one engine shard's books for the market data snapshot cycler.
+//
+// A book belongs to its engine thread, and a ladder book can reallocate its
+// slots in the middle of a command, so no other thread walks one. The
+// cycler asks for a copy instead: request() posts the security ID and
+// waits while the engine thread builds the copy between batches in
+// serve(). When nobody is asking, serve() costs one relaxed load. Once the
+// engine thread has stopped (close()), request() copies the book itself.
+// ---------------------------------------------------------------------------
+class BookSnapshotSource {
+public:
+    struct Image {
+        std::vector<std::pair<Price, Quantity>> bids;
+        std::vector<std::pair<Price, Quantity>> asks;
+        std::vector<int> bid_counts;
+        std::vector<int> ask_counts;
+    };
+
+    // How long request() waits for the engine thread
+    static constexpr std::chrono::milliseconds WAIT{100};
+
+    explicit BookSnapshotSource(const FullMatchingEngine& engine) : engine_(engine) {}
+
+    BookSnapshotSource(const BookSnapshotSource&) = delete;
+    BookSnapshotSource& operator=(const BookSnapshotSource&) = delete;
+
+    bool hasBook(SecurityId security_id) const {
+        return engine_.getOrderBook(security_id) != nullptr;
+    }
+
+    // Any thread: copy the book into `out`. False if this shard has no
+    // such book or its engine thread did not answer in time.
+    bool request(SecurityId security_id, Image& out);
+
+    // Engine thread, between batches
+    void serve() {
+        if (pending_.load(std::memory_order_relaxed) != 0) fulfil();
+    }
+
+    // The engine thread has stopped serving; later requests read the book
+    // directly
+    void close();
+
+private:
+    void fulfil();
+    static void copyBook(const OrderBook& book, Image& out);
+
+    const FullMatchingEngine& engine_;
+    std::mutex requester_mutex_;      // one request in flight at a time
+    std::mutex mutex_;                // guards the fields below
+    std::condition_variable served_;
+    std::atomic<SecurityId> pending_{0};
+    bool done_ = false;
+    bool closed_ = false;
+    Image image_;
+};
+
+} // namespace cme::sim
@@ -1,10 +1,55 @@
 #pragma once
 #include "../common/types.h"
-#include <string>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 
 namespace cme::sim {
 
+// ---------------------------------------------------------------------------
+// Engine events
+//
+// Every alternative is a fixed-size, trivially copyable record (ClOrdIds
+// are inline, reject reasons are codes), so an EngineEvent can be memcpy'd
+// between pipeline stages without touching the heap.
+// ---------------------------------------------------------------------------
+
+// Why the engine refused an order or a cancel/replace. Text for logs via
+// rejectReasonText(); the wire carries reject_reason_code instead.
+enum class RejectReason : uint8_t {
+    None = 0,
+    UnknownSecurity,
+    OrderNotFound,
+    PriceOffTickLadder,
+    FokNotFillable,
+    OrderCapacityExhausted,
+    PreTradeRisk,
+    InvalidStopPrice,
+    MinQtyNotFillable,
+    Throttled,
+    PriceBand,
+    PositionLimit
+};
+
+constexpr std::string_view rejectReasonText(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::None:                   return "";
+        case RejectReason::UnknownSecurity:        return "Unknown security ID";
+        case RejectReason::OrderNotFound:          return "Order not found";
+        case RejectReason::PriceOffTickLadder:     return "Price not on instrument tick ladder";
+        case RejectReason::FokNotFillable:         return "FOK order cannot be fully filled";
+        case RejectReason::OrderCapacityExhausted: return "Order capacity exhausted";
+        case RejectReason::PreTradeRisk:           return "Pre-trade risk check failed";
+        case RejectReason::InvalidStopPrice:       return "Stop price missing or already reached";
+        case RejectReason::MinQtyNotFillable:      return "Minimum quantity cannot be filled";
+        case RejectReason::Throttled:              return "Engine queue full; resubmit";
+        case RejectReason::PriceBand:              return "Price outside the band around the last trade";
+        case RejectReason::PositionLimit:          return "Worst-case position would exceed the limit";
+    }
+    return "Unknown reject reason";
+}
+
 struct OrderAccepted {
     OrderId order_id;
     ClOrdId cl_ord_id;
@@ -20,7 +65,7 @@ struct OrderAccepted {
 struct OrderRejected {
     ClOrdId cl_ord_id;
     uint64_t session_uuid;
-    std::string reason;
+    RejectReason reason = RejectReason::None;
     uint16_t reject_reason_code = 0;
 };
 
@@ -73,7 +118,7 @@ struct OrderCancelRejected {
     ClOrdId cl_ord_id;
     uint64_t session_uuid;
     uint16_t reject_reason_code = 0;
-    std::string reason;
+    RejectReason reason = RejectReason::None;
 };
 
 struct BookUpdate {
@@ -85,6 +130,20 @@ struct BookUpdate {
     MDUpdateAction update_action;
     int price_level_index;  // 1-based
     uint32_t rpt_seq;
+    bool implied = false;   // implied level (see ImpliedEngine), not resting orders
+};
+
+// A resting stop was elected by a trade and is now working as a limit or
+// market order (order_type is the post-election type).
+struct OrderTriggered {
+    OrderId order_id;
+    ClOrdId cl_ord_id;
+    uint64_t session_uuid;
+    SecurityId security_id;
+    Side side;
+    Price stop_price;
+    Price trigger_price;  // last trade price that elected the stop
+    OrderType order_type;
 };
 
 using EngineEvent = std::variant<
@@ -94,7 +153,11 @@ using EngineEvent = std::variant<
     OrderCancelled,
     OrderModified,
     OrderCancelRejected,
-    BookUpdate
+    BookUpdate,
+    OrderTriggered
 >;
 
+static_assert(std::is_trivially_copyable_v<EngineEvent>,
+              "EngineEvent must stay memcpy-able between pipeline stages");
+
 } // namespace cme::sim
@@ -0,0 +1,52 @@
+#pragma once
+#include "engine_event.h"
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Append-only buffer the engine writes events into.
+//
+// The caller owns the sink and reuses it across commands: clear() keeps the
+// capacity, so once warmed up a command emits its events without allocating.
+// Engines only ever append, so a caller can share one sink between several
+// commands and pick out each command's events with since().
+// ---------------------------------------------------------------------------
+class EventSink {
+public:
+    explicit EventSink(std::size_t reserve = 64) { events_.reserve(reserve); }
+
+    template <typename E>
+    void emit(E&& event) { events_.emplace_back(std::forward<E>(event)); }
+
+    void clear() { events_.clear(); }
+
+    std::size_t size() const { return events_.size(); }
+    bool empty() const { return events_.empty(); }
+    const EngineEvent& operator[](std::size_t i) const { return events_[i]; }
+
+    // Events appended at or after position `first`
+    std::span<const EngineEvent> since(std::size_t first) const {
+        return std::span<const EngineEvent>(events_).subspan(first);
+    }
+
+    // The `count` events starting at position `first`
+    std::span<const EngineEvent> range(std::size_t first, std::size_t count) const {
+        return std::span<const EngineEvent>(events_).subspan(first, count);
+    }
+
+    const std::vector<EngineEvent>& events() const { return events_; }
+    auto begin() const { return events_.begin(); }
+    auto end() const { return events_.end(); }
+
+    // Hand the buffer over (used by the vector-returning adapters).
+    std::vector<EngineEvent> take() { return std::exchange(events_, {}); }
+
+private:
+    std::vector<EngineEvent> events_;
+};
+
+} // namespace cme::sim
@@ -1,121 +1,304 @@
 #include "full_matching_engine.h"
+#include <algorithm>
 #include <chrono>
 
 namespace cme::sim {
 
-FullMatchingEngine::FullMatchingEngine() = default;
-
-void FullMatchingEngine::addInstrument(SecurityId security_id) {
-    order_books_.try_emplace(security_id, security_id);
+FullMatchingEngine::FullMatchingEngine(uint8_t shard_id, int implied_depth)
+    : implied_(implied_depth)
+    , shard_id_(shard_id) {
+    layout_.shard_id = shard_id;
+    layout_.implied_depth = implied_depth;
 }
 
-std::vector<EngineEvent> FullMatchingEngine::submitOrder(std::unique_ptr<Order> order) {
-    // Assign order ID and timestamp
-    order->order_id = next_order_id_++;
-    order->timestamp = static_cast<Timestamp>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count());
+FullMatchingEngine::FullMatchingEngine(const EngineLayout& layout)
+    : FullMatchingEngine(layout.shard_id, layout.implied_depth) {
+    for (const auto& [security_id, config] : layout.instruments) addInstrument(security_id, config);
+    for (const auto& spread : layout.spreads) addSpread(spread.spread_id, spread.front_id, spread.back_id);
+}
 
-    SecurityId sec_id = order->security_id;
+void FullMatchingEngine::addInstrument(SecurityId security_id, const BookConfig& config) {
+    // Orders are resolved through the pool, so the book needs no id index
+    BookConfig book_config = config;
+    book_config.index_orders = false;
+    if (order_books_.try_emplace(security_id, security_id, book_config).second) {
+        layout_.instruments.emplace_back(security_id, config);
+    }
+}
 
-    // Find the order book
-    auto book_it = order_books_.find(sec_id);
-    if (book_it == order_books_.end()) {
-        std::vector<EngineEvent> events;
-        events.emplace_back(OrderRejected{
-            order->cl_ord_id,
-            order->session_uuid,
-            "Unknown security ID",
-            0
-        });
-        return events;
+bool FullMatchingEngine::addSpread(SecurityId spread_id, SecurityId front_id, SecurityId back_id) {
+    auto spread = order_books_.find(spread_id);
+    auto front = order_books_.find(front_id);
+    auto back = order_books_.find(back_id);
+    if (spread == order_books_.end() || front == order_books_.end() || back == order_books_.end()) {
+        return false;
     }
+    // unordered_map never moves its values, so the implied engine can keep
+    // pointers to the books
+    implied_.addSpread(spread->second, front->second, back->second);
+    layout_.spreads.push_back({spread_id, front_id, back_id});
+    return true;
+}
 
-    OrderId oid = order->order_id;
-    Order* raw_ptr = order.get();
+void FullMatchingEngine::submitOrder(const Order& order, EventSink& events) {
+    std::size_t first = events.size();
+    submitTo(findBook(order.security_id), order, events);
+    if (!implied_.empty()) implied_.update(events, first);
+}
 
-    // Take ownership
-    owned_orders_[oid] = std::move(order);
-    order_to_security_[oid] = sec_id;
+void FullMatchingEngine::cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid, EventSink& events) {
+    // Resolve the handle embedded in the ID; the resting order knows its book
+    Order* order = order_pool_.find(order_id);
+    std::size_t first = events.size();
+    cancelIn(findBook(order ? order->security_id : security_id), order, order_id, session_uuid, events);
+    if (!implied_.empty()) implied_.update(events, first);
+}
+
+void FullMatchingEngine::modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) {
+    Order* order = order_pool_.find(order_id);
+    std::size_t first = events.size();
+    modifyIn(findBook(order ? order->security_id : security_id), order, order_id,
+             new_price, new_qty, new_cl_ord_id, events);
+    if (!implied_.empty()) implied_.update(events, first);
+}
+
+void FullMatchingEngine::massCancel(uint64_t session_uuid, SecurityId security_id,
+                                    std::optional<Side> side, EventSink& events) {
+    std::size_t first = events.size();
+    massCancelIn(session_uuid, security_id, side, events);
+    if (!implied_.empty()) implied_.update(events, first);
+}
+
+void FullMatchingEngine::processBatch(std::span<const EngineCommand> commands, EventSink& events,
+                                      std::vector<EventRange>& ranges) {
+    ranges.resize(commands.size());
+    std::size_t batch_first = events.size();
+
+    // Key each command by the book it will hit (a cancel/modify by its
+    // resting order's book), then sort; the index breaks ties, so commands
+    // for one book keep their order. A mass cancel across all books touches
+    // any of them, so it starts a new segment that sorts after everything
+    // before it.
+    batch_order_.clear();
+    uint32_t segment = 0;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const EngineCommand& cmd = commands[i];
+        SecurityId sec_id = cmd.security_id;
+        if (cmd.type == EngineCommand::Type::NewOrder) {
+            sec_id = cmd.order.security_id;
+        } else if (cmd.type == EngineCommand::Type::MassCancel) {
+            if (sec_id == 0) ++segment;
+        } else if (const Order* order = order_pool_.find(cmd.order_id)) {
+            sec_id = order->security_id;
+        }
+        batch_order_.emplace_back(segment, sec_id, static_cast<uint32_t>(i));
+        if (cmd.type == EngineCommand::Type::MassCancel && cmd.security_id == 0) ++segment;
+    }
+    std::sort(batch_order_.begin(), batch_order_.end());
 
-    auto events = book_it->second.addOrder(raw_ptr);
+    SecurityId book_id = 0;
+    OrderBook* book = nullptr;
+    bool resolved = false;
+    uint64_t start = Clock::ticks();
+    for (auto [seg, sec_id, i] : batch_order_) {
+        if (!resolved || sec_id != book_id) {
+            book_id = sec_id;
+            book = findBook(sec_id);
+            resolved = true;
+        }
 
-    // Clean up fully filled or cancelled orders that aren't resting
-    if (raw_ptr->isFullyFilled() || raw_ptr->status == OrdStatus::Canceled ||
-        raw_ptr->status == OrdStatus::Rejected) {
-        // The order book won't hold a reference to these, so we can keep
-        // them in owned_orders_ for potential query, or clean up.
-        // For cancelled IOC/FOK, remove from tracking maps.
-        order_to_security_.erase(oid);
-        owned_orders_.erase(oid);
+        const EngineCommand& cmd = commands[i];
+        std::size_t first = events.size();
+        if (cmd.type == EngineCommand::Type::NewOrder) {
+            submitTo(book, cmd.order, events);
+        } else if (cmd.type == EngineCommand::Type::MassCancel) {
+            massCancelIn(cmd.session_uuid, cmd.security_id, cmd.mass_side, events);
+        } else {
+            // Resolve again: an earlier command may have filled or
+            // cancelled the target since the batch was keyed
+            Order* order = order_pool_.find(cmd.order_id);
+            SecurityId target = order ? order->security_id : cmd.security_id;
+            OrderBook* target_book = target == book_id ? book : findBook(target);
+            if (cmd.type == EngineCommand::Type::CancelOrder) {
+                cancelIn(target_book, order, cmd.order_id, cmd.session_uuid, events);
+            } else {
+                modifyIn(target_book, order, cmd.order_id, cmd.new_price, cmd.new_qty,
+                         cmd.new_cl_ord_id, events);
+            }
+        }
+        uint64_t end = Clock::ticks();
+        ranges[i] = {first, events.size() - first, end - start};
+        start = end;
     }
 
-    return events;
+    if (!implied_.empty()) implied_.update(events, batch_first);
+}
+
+OrderBook* FullMatchingEngine::findBook(SecurityId security_id) {
+    auto it = order_books_.find(security_id);
+    return it == order_books_.end() ? nullptr : &it->second;
 }
 
-std::vector<EngineEvent> FullMatchingEngine::cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) {
-    // Look up the security for this order
-    auto sec_it = order_to_security_.find(order_id);
-    SecurityId sec_id = security_id;
-    if (sec_it != order_to_security_.end()) {
-        sec_id = sec_it->second;
+void FullMatchingEngine::submitTo(OrderBook* book, const Order& order, EventSink& events) {
+    if (!book) {
+        events.emit(OrderRejected{
+            order.cl_ord_id,
+            order.session_uuid,
+            RejectReason::UnknownSecurity,
+            0
+        });
+        return;
     }
 
-    auto book_it = order_books_.find(sec_id);
-    if (book_it == order_books_.end()) {
-        std::vector<EngineEvent> events;
-        events.emplace_back(OrderCancelRejected{
+    OrderHandle handle = order_pool_.acquire();
+    if (handle == OrderPool::INVALID_HANDLE) {
+        events.emit(OrderRejected{
+            order.cl_ord_id,
+            order.session_uuid,
+            RejectReason::OrderCapacityExhausted,
+            0
+        });
+        return;
+    }
+
+    // Copy into the pooled slot, then assign order ID and timestamp
+    Order* pooled = order_pool_.get(handle);
+    *pooled = order;
+    pooled->prev_in_level = nullptr;
+    pooled->next_in_level = nullptr;
+    pooled->order_id = OrderPool::makeOrderId(next_order_seq_++, handle, shard_id_);
+    linkToSession(pooled);
+    if (next_order_seq_ == 0) next_order_seq_ = 1;
+    // Keep a timestamp the caller assigned (a journal replay does)
+    if (pooled->timestamp == 0) {
+        pooled->timestamp = static_cast<Timestamp>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    std::size_t first = events.size();
+    book->addOrder(pooled, events);
+    releaseDone(pooled, events.since(first));
+}
+
+void FullMatchingEngine::cancelIn(OrderBook* book, Order* order, OrderId order_id, uint64_t session_uuid, EventSink& events) {
+    if (!book) {
+        events.emit(OrderCancelRejected{
             order_id,
             ClOrdId{},
             session_uuid,
             0,
-            "Unknown security ID"
+            RejectReason::UnknownSecurity
         });
-        return events;
+        return;
     }
 
-    auto events = book_it->second.cancelOrder(order_id);
-
-    // Clean up ownership
-    order_to_security_.erase(order_id);
-    owned_orders_.erase(order_id);
+    if (!order) {
+        // Not resting (never existed, already filled or cancelled)
+        book->cancelOrder(order_id, events);
+        return;
+    }
 
-    return events;
+    book->cancelOrder(order, events);
+    release(order);
 }
 
-std::vector<EngineEvent> FullMatchingEngine::modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) {
-    auto sec_it = order_to_security_.find(order_id);
-    SecurityId sec_id = security_id;
-    if (sec_it != order_to_security_.end()) {
-        sec_id = sec_it->second;
-    }
-
-    auto book_it = order_books_.find(sec_id);
-    if (book_it == order_books_.end()) {
-        std::vector<EngineEvent> events;
-        events.emplace_back(OrderCancelRejected{
+void FullMatchingEngine::modifyIn(OrderBook* book, Order* order, OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) {
+    if (!book) {
+        events.emit(OrderCancelRejected{
             order_id,
             new_cl_ord_id,
             0,
             0,
-            "Unknown security ID"
+            RejectReason::UnknownSecurity
         });
-        return events;
+        return;
     }
 
-    auto events = book_it->second.modifyOrder(order_id, new_price, new_qty, new_cl_ord_id);
+    if (!order) {
+        book->modifyOrder(order_id, new_price, new_qty, new_cl_ord_id, events);
+        return;
+    }
+
+    // If the order was fully filled after re-matching, releaseDone frees it
+    std::size_t first = events.size();
+    book->modifyOrder(order, new_price, new_qty, new_cl_ord_id, events);
+    releaseDone(order, events.since(first));
+}
 
-    // If the order was fully filled after re-matching, clean up
-    auto owned_it = owned_orders_.find(order_id);
-    if (owned_it != owned_orders_.end()) {
-        Order* raw_ptr = owned_it->second.get();
-        if (raw_ptr->isFullyFilled() || raw_ptr->status == OrdStatus::Canceled) {
-            order_to_security_.erase(order_id);
-            owned_orders_.erase(order_id);
+void FullMatchingEngine::massCancelIn(uint64_t session_uuid, SecurityId security_id,
+                                      std::optional<Side> side, EventSink& events) {
+    auto it = session_orders_.find(session_uuid);
+    if (it == session_orders_.end()) return;
+
+    // Collect first: each cancel unlinks the order from the list
+    mass_cancel_.clear();
+    for (Order* order = it->second; order; order = order->next_in_session) {
+        if (security_id != 0 && order->security_id != security_id) continue;
+        if (side && order->side != *side) continue;
+        mass_cancel_.push_back(order);
+    }
+    // One book at a time, so its BookUpdates sit together for MDP
+    std::stable_sort(mass_cancel_.begin(), mass_cancel_.end(),
+                     [](const Order* a, const Order* b) { return a->security_id < b->security_id; });
+
+    OrderBook* book = nullptr;
+    for (Order* order : mass_cancel_) {
+        if (!book || book->securityId() != order->security_id) {
+            book = findBook(order->security_id);
         }
+        book->cancelOrder(order, events);
+        release(order);
     }
+}
 
-    return events;
+std::size_t FullMatchingEngine::sessionOrderCount(uint64_t session_uuid) const {
+    auto it = session_orders_.find(session_uuid);
+    if (it == session_orders_.end()) return 0;
+    std::size_t count = 0;
+    for (const Order* order = it->second; order; order = order->next_in_session) ++count;
+    return count;
+}
+
+EngineSnapshot FullMatchingEngine::snapshot() const {
+    EngineSnapshot snap;
+    snap.shard_id = shard_id_;
+    snap.next_order_seq = next_order_seq_;
+    snap.orders.reserve(order_pool_.live());
+    for (const auto& [security_id, config] : layout_.instruments) {
+        const OrderBook& book = order_books_.at(security_id);
+        snap.books.push_back({security_id, book.state()});
+        book.forEachOrder([&](const Order* order) { snap.orders.push_back(*order); });
+    }
+    return snap;
+}
+
+bool FullMatchingEngine::restore(const EngineSnapshot& snap) {
+    if (snap.shard_id != shard_id_ || order_pool_.live() != 0) return false;
+    for (const auto& book : snap.books) {
+        if (!order_books_.count(book.security_id)) return false;
+    }
+    std::vector<OrderHandle> handles;
+    handles.reserve(snap.orders.size());
+    for (const Order& image : snap.orders) {
+        if (!order_books_.count(image.security_id) || image.order_id == 0) return false;
+        handles.push_back(OrderPool::handleOf(image.order_id));
+    }
+    if (!order_pool_.restoreLive(handles)) return false;
+
+    for (const Order& image : snap.orders) {
+        Order* order = order_pool_.get(OrderPool::handleOf(image.order_id));
+        *order = image;
+        order->prev_in_level = order->next_in_level = nullptr;
+        order_books_.at(order->security_id).restoreOrder(order);
+        linkToSession(order);
+    }
+    for (const auto& book : snap.books) {
+        order_books_.at(book.security_id).restoreState(book.state);
+    }
+    next_order_seq_ = snap.next_order_seq;
+    implied_.rebuild();
+    return true;
 }
 
 const OrderBook* FullMatchingEngine::getOrderBook(SecurityId security_id) const {
@@ -124,4 +307,54 @@ const OrderBook* FullMatchingEngine::getOrderBook(SecurityId security_id) const
     return &it->second;
 }
 
+void FullMatchingEngine::releaseDone(Order* order, std::span<const EngineEvent> events) {
+    // Read before any release clears the slot's order_id
+    OrderId order_id = order->order_id;
+    bool done = order->isFullyFilled() || order->status == OrdStatus::Canceled ||
+                order->status == OrdStatus::Rejected;
+
+    for (const auto& event : events) {
+        if (const auto* fill = std::get_if<OrderFilled>(&event)) {
+            if (fill->maker_leaves_qty == 0) releaseId(fill->maker_order_id);
+            if (fill->taker_leaves_qty == 0 && fill->taker_order_id != order_id) {
+                releaseId(fill->taker_order_id);
+            }
+        } else if (const auto* cancel = std::get_if<OrderCancelled>(&event)) {
+            if (cancel->order_id != order_id) releaseId(cancel->order_id);
+        }
+    }
+
+    // The book only holds on to orders it rested
+    if (done) releaseId(order_id);
+}
+
+void FullMatchingEngine::releaseId(OrderId order_id) {
+    // find() only matches a live slot still holding this exact ID, so an
+    // order reported done twice is released once
+    if (Order* order = order_pool_.find(order_id)) release(order);
+}
+
+void FullMatchingEngine::linkToSession(Order* order) {
+    Order*& head = session_orders_[order->session_uuid];
+    order->prev_in_session = nullptr;
+    order->next_in_session = head;
+    if (head) head->prev_in_session = order;
+    head = order;
+}
+
+void FullMatchingEngine::release(Order* order) {
+    if (order->prev_in_session) {
+        order->prev_in_session->next_in_session = order->next_in_session;
+    } else if (order->next_in_session) {
+        session_orders_[order->session_uuid] = order->next_in_session;
+    } else {
+        session_orders_.erase(order->session_uuid);
+    }
+    if (order->next_in_session) order->next_in_session->prev_in_session = order->prev_in_session;
+    order->prev_in_session = nullptr;
+    order->next_in_session = nullptr;
+
+    order_pool_.release(OrderPool::handleOf(order->order_id));
+}
+
 } // namespace cme::sim
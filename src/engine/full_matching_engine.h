@@ -1,29 +1,132 @@
 #pragma once
 #include "matching_engine.h"
+#include "implied_engine.h"
 #include "order_book.h"
+#include "order_pool.h"
+#include <optional>
+#include <tuple>
 #include <unordered_map>
-#include <memory>
+#include <utility>
+#include <vector>
 
 namespace cme::sim {
 
+// How an engine was set up: enough to build an identical one, e.g. to
+// replay a journal of its commands
+struct EngineLayout {
+    struct Spread {
+        SecurityId spread_id = 0;
+        SecurityId front_id = 0;
+        SecurityId back_id = 0;
+    };
+    uint8_t shard_id = 0;
+    int implied_depth = 2;
+    std::vector<std::pair<SecurityId, BookConfig>> instruments;  // in add order
+    std::vector<Spread> spreads;
+};
+
+// Everything an engine holds between commands, e.g. to save in a
+// checkpoint and load into a fresh engine with the same layout
+struct EngineSnapshot {
+    struct Book {
+        SecurityId security_id = 0;
+        OrderBook::State state;
+    };
+    uint8_t shard_id = 0;
+    uint32_t next_order_seq = 1;
+    std::vector<Book> books;     // in layout order
+    // Every resting order, book by book, in OrderBook::forEachOrder order;
+    // list links are not meaningful
+    std::vector<Order> orders;
+};
+
 class FullMatchingEngine : public IMatchingEngine {
 public:
-    FullMatchingEngine();
+    // `shard_id` is stamped into every OrderId so IDs stay unique when
+    // several engines run side by side (one per MDP channel).
+    // `implied_depth` is how many implied levels spreads publish per side.
+    explicit FullMatchingEngine(uint8_t shard_id = 0, int implied_depth = 2);
+    // Add the layout's instruments and spreads in order
+    explicit FullMatchingEngine(const EngineLayout& layout);
+
+    void addInstrument(SecurityId security_id, const BookConfig& config = {});
+
+    // Derive implied prices for `spread_id` = `front_id` - `back_id`; all
+    // three books must already be added. Returns false if one is missing.
+    bool addSpread(SecurityId spread_id, SecurityId front_id, SecurityId back_id);
+
+    using IMatchingEngine::submitOrder;
+    using IMatchingEngine::cancelOrder;
+    using IMatchingEngine::modifyOrder;
+    using IMatchingEngine::massCancel;
 
-    void addInstrument(SecurityId security_id);
+    void submitOrder(const Order& order, EventSink& events) override;
+    void cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid, EventSink& events) override;
+    void modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) override;
 
-    std::vector<EngineEvent> submitOrder(std::unique_ptr<Order> order) override;
-    std::vector<EngineEvent> cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) override;
-    std::vector<EngineEvent> modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) override;
+    // Walks only the session's own order list, book by book, so the cost
+    // is the number of orders the session has resting.
+    void massCancel(uint64_t session_uuid, SecurityId security_id,
+                    std::optional<Side> side, EventSink& events) override;
+
+    // Groups the batch by book (each book's commands keep their order), so
+    // one book's levels stay hot across its commands, and refreshes implied
+    // prices once for the whole batch.
+    void processBatch(std::span<const EngineCommand> commands, EventSink& events,
+                      std::vector<EventRange>& ranges) override;
 
     const OrderBook* getOrderBook(SecurityId security_id) const;
+    const ImpliedEngine& impliedEngine() const { return implied_; }
+    const EngineLayout& layout() const { return layout_; }
+
+    EngineSnapshot snapshot() const;
+    // Load a snapshot into this engine, which must have the snapshot's
+    // books and no resting orders. Orders keep their OrderIds. False
+    // (engine untouched) if the snapshot does not fit.
+    bool restore(const EngineSnapshot& snapshot);
+
+    // Orders currently resting in a book (i.e. holding a pool slot)
+    std::size_t restingOrderCount() const { return order_pool_.live(); }
+    // Orders resting for one session
+    std::size_t sessionOrderCount(uint64_t session_uuid) const;
 
 private:
     std::unordered_map<SecurityId, OrderBook> order_books_;
-    std::unordered_map<OrderId, SecurityId> order_to_security_;
-    // Owns all resting and in-flight orders
-    std::unordered_map<OrderId, std::unique_ptr<Order>> owned_orders_;
-    uint64_t next_order_id_ = 1;
+    // Owns all resting orders; OrderIds carry their pool handle
+    OrderPool order_pool_;
+    // Implied levels for spreads, refreshed from each command's BookUpdates
+    ImpliedEngine implied_;
+    uint8_t shard_id_;
+    EngineLayout layout_;
+    uint32_t next_order_seq_ = 1;
+    // Head of each session's resting-order list (Order::next_in_session);
+    // a session is erased once its last order leaves the book
+    std::unordered_map<uint64_t, Order*> session_orders_;
+    // processBatch scratch: (segment, book, command index), sorted
+    std::vector<std::tuple<uint32_t, SecurityId, uint32_t>> batch_order_;
+    // massCancel scratch: the orders to cancel, grouped by book
+    std::vector<Order*> mass_cancel_;
+
+    OrderBook* findBook(SecurityId security_id);
+
+    // Command bodies shared by the single-command calls and processBatch.
+    // `book` is the order's book (null if unknown); `order` the resting
+    // order resolved from `order_id` (null if not resting).
+    void submitTo(OrderBook* book, const Order& order, EventSink& events);
+    void cancelIn(OrderBook* book, Order* order, OrderId order_id, uint64_t session_uuid, EventSink& events);
+    void modifyIn(OrderBook* book, Order* order, OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events);
+    void massCancelIn(uint64_t session_uuid, SecurityId security_id, std::optional<Side> side, EventSink& events);
+
+    // Return slots of orders that no longer rest: the order itself if it
+    // is done, plus any order `events` shows finished (fully filled makers,
+    // and stops the command elected that then filled or were cancelled).
+    void releaseDone(Order* order, std::span<const EngineEvent> events);
+    void releaseId(OrderId order_id);
+
+    // Every pool slot is acquired and released through these, which keep
+    // the session lists in step with the pool
+    void linkToSession(Order* order);
+    void release(Order* order);
 };
 
 } // namespace cme::sim
@@ -0,0 +1,181 @@
+#include "implied_engine.h"
+#include <algorithm>
+
+namespace cme::sim {
+
+namespace {
+
+using Level = ImpliedEngine::Level;
+using Levels = ImpliedEngine::Levels;
+
+bool isBetter(Side side, Price a, Price b) {
+    return side == Side::Buy ? a > b : a < b;
+}
+
+// Copy the best `depth` direct levels of one side of `book` into `out`
+int topLevels(const OrderBook& book, Side side, int depth, Level* out) {
+    int n = 0;
+    auto collect = [&](const auto& levels) {
+        for (const auto& [price, level] : levels) {
+            if (n == depth) break;
+            out[n++] = {price, level.total_quantity};
+        }
+    };
+    if (side == Side::Buy) collect(book.bidLevels());
+    else collect(book.askLevels());
+    return n;
+}
+
+// Add `qty` at `price` to best-first levels capped at `depth`. Returns
+// false if the price is worse than every level of a full array.
+bool mergeLevel(Levels& levels, Side side, int depth, Price price, Quantity qty) {
+    int k = 0;
+    while (k < levels.count && isBetter(side, levels.level[k].price, price)) ++k;
+    if (k < levels.count && levels.level[k].price == price) {
+        levels.level[k].qty += qty;
+        return true;
+    }
+    if (k == depth) return false;
+    int last = std::min(levels.count, depth - 1);
+    for (int i = last; i > k; --i) levels.level[i] = levels.level[i - 1];
+    levels.level[k] = {price, qty};
+    if (levels.count < depth) ++levels.count;
+    return true;
+}
+
+} // anonymous namespace
+
+ImpliedEngine::ImpliedEngine(int depth)
+    : depth_(std::clamp(depth, 1, MAX_DEPTH)) {}
+
+void ImpliedEngine::addSpread(OrderBook& spread, OrderBook& front, OrderBook& back) {
+    // Implied-in: spread from its legs
+    addSource(spread, Side::Buy,  {&front, Side::Buy,  &back, Side::Sell, true});
+    addSource(spread, Side::Sell, {&front, Side::Sell, &back, Side::Buy,  true});
+    // Implied-out: front = spread + back
+    addSource(front, Side::Buy,  {&spread, Side::Buy,  &back, Side::Buy,  false});
+    addSource(front, Side::Sell, {&spread, Side::Sell, &back, Side::Sell, false});
+    // Implied-out: back = front - spread
+    addSource(back, Side::Buy,  {&front, Side::Buy,  &spread, Side::Sell, true});
+    addSource(back, Side::Sell, {&front, Side::Sell, &spread, Side::Buy,  true});
+}
+
+void ImpliedEngine::addSource(OrderBook& book, Side side, const Source& source) {
+    auto [it, inserted] = output_by_key_.try_emplace(key(book.securityId(), side), outputs_.size());
+    if (inserted) outputs_.push_back(Output{&book, side, {}, {}, false});
+    std::size_t index = it->second;
+    outputs_[index].sources.push_back(source);
+
+    for (auto [input, input_side] : {std::pair{source.x, source.x_side},
+                                     std::pair{source.y, source.y_side}}) {
+        auto& readers = dependents_[key(input->securityId(), input_side)];
+        if (std::find(readers.begin(), readers.end(), index) == readers.end()) {
+            readers.push_back(index);
+        }
+    }
+}
+
+void ImpliedEngine::update(EventSink& events, std::size_t first) {
+    // Mark first: appending below may reallocate the buffer being scanned
+    std::size_t end = events.size();
+    for (std::size_t i = first; i < end; ++i) {
+        const auto* bu = std::get_if<BookUpdate>(&events[i]);
+        if (!bu || bu->implied) continue;
+        if (bu->price_level_index < 1 || bu->price_level_index > depth_) continue;
+
+        auto it = dependents_.find(key(bu->security_id, bu->side));
+        if (it == dependents_.end()) continue;
+        for (std::size_t index : it->second) {
+            if (outputs_[index].dirty) continue;
+            outputs_[index].dirty = true;
+            dirty_.push_back(index);
+        }
+    }
+
+    for (std::size_t index : dirty_) {
+        Output& out = outputs_[index];
+        Levels next;
+        recompute(out, next);
+        publish(out, next, events);
+        out.dirty = false;
+    }
+    dirty_.clear();
+}
+
+void ImpliedEngine::rebuild() {
+    for (Output& out : outputs_) {
+        Levels next;
+        recompute(out, next);
+        out.levels = next;
+        out.dirty = false;
+    }
+    dirty_.clear();
+}
+
+const ImpliedEngine::Levels& ImpliedEngine::implied(SecurityId security_id, Side side) const {
+    static const Levels none;
+    auto it = output_by_key_.find(key(security_id, side));
+    return it == output_by_key_.end() ? none : outputs_[it->second].levels;
+}
+
+void ImpliedEngine::recompute(const Output& out, Levels& next) const {
+    std::array<Level, MAX_DEPTH> x;
+    std::array<Level, MAX_DEPTH> y;
+
+    for (const Source& source : out.sources) {
+        int nx = topLevels(*source.x, source.x_side, depth_, x.data());
+        int ny = topLevels(*source.y, source.y_side, depth_, y.data());
+        if (nx == 0 || ny == 0) continue;
+
+        // Each step fills the smaller of the two current levels and moves
+        // past it, so implied prices only get worse and the walk ends after
+        // at most nx + ny steps.
+        int i = 0, j = 0;
+        Quantity rx = x[0].qty, ry = y[0].qty;
+        while (i < nx && j < ny) {
+            Quantity qty = std::min(rx, ry);
+            Price price = source.subtract ? x[i].price - y[j].price
+                                          : x[i].price + y[j].price;
+            if (!mergeLevel(next, out.side, depth_, price, qty)) break;
+            rx -= qty;
+            ry -= qty;
+            if (rx == 0 && ++i < nx) rx = x[i].qty;
+            if (ry == 0 && ++j < ny) ry = y[j].qty;
+        }
+    }
+}
+
+void ImpliedEngine::publish(Output& out, const Levels& next, EventSink& events) {
+    const Levels& prev = out.levels;
+    SecurityId security_id = out.book->securityId();
+    auto emit = [&](int k, const Level& level, MDUpdateAction action) {
+        events.emit(BookUpdate{
+            security_id,
+            out.side,
+            level.price,
+            action == MDUpdateAction::Delete ? 0 : level.qty,
+            0,  // implied levels carry no order count
+            action,
+            k + 1,
+            out.book->nextRptSeq(),
+            true
+        });
+    };
+
+    // Levels present before and after are rewritten in place; then new
+    // levels are appended, or vanished ones deleted from the bottom up so
+    // no delete shifts a level still to be sent.
+    int common = std::min(prev.count, next.count);
+    for (int k = 0; k < common; ++k) {
+        const Level& was = prev.level[k];
+        const Level& now = next.level[k];
+        if (was.price != now.price) emit(k, now, MDUpdateAction::Overlay);
+        else if (was.qty != now.qty) emit(k, now, MDUpdateAction::Change);
+    }
+    for (int k = common; k < next.count; ++k) emit(k, next.level[k], MDUpdateAction::New);
+    for (int k = prev.count; k-- > common;) emit(k, prev.level[k], MDUpdateAction::Delete);
+
+    out.levels = next;
+}
+
+} // namespace cme::sim
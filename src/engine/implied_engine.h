@@ -0,0 +1,104 @@
+#pragma once
+#include "order_book.h"
+#include "event_sink.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// First-generation implied prices for calendar spreads.
+//
+// Buying a spread buys its front leg and sells its back leg, so its price is
+// front - back. Implied-in: the spread's implied bid is front bid - back
+// offer, its implied offer front offer - back bid. Implied-out: each leg is
+// implied from the spread's own book and the other leg (front = spread +
+// back, back = front - spread). Only direct liquidity feeds the calculation,
+// so implied prices never feed further implieds.
+//
+// Each implied book side is a fixed top-`depth` array built by walking its
+// two inputs best-first and pairing their quantities the way one sweep
+// across both books would. That walk never reads past level `depth` of
+// either input, so a BookUpdate deeper than that cannot move an implied
+// price and is skipped; one within it recomputes only the implied sides fed
+// by that book side. Changes go out as implied BookUpdates (MDP entry types
+// E/F) carrying the rpt_seq of the book they are published for.
+//
+// Not thread-safe: owned by the engine thread, next to the books it reads.
+// ---------------------------------------------------------------------------
+class ImpliedEngine {
+public:
+    static constexpr int MAX_DEPTH = 10;
+
+    struct Level {
+        Price price;
+        Quantity qty = 0;
+    };
+
+    // Implied levels of one book side, best first
+    struct Levels {
+        std::array<Level, MAX_DEPTH> level{};
+        int count = 0;
+    };
+
+    explicit ImpliedEngine(int depth = 2);
+
+    // Register `spread` = `front` - `back`. The books must stay at fixed
+    // addresses for the engine's lifetime.
+    void addSpread(OrderBook& spread, OrderBook& front, OrderBook& back);
+
+    bool empty() const { return outputs_.empty(); }
+    int depth() const { return depth_; }
+
+    // Recompute the implied sides that the direct BookUpdates at or after
+    // position `first` may have moved, and append their implied BookUpdates
+    // to `events`.
+    void update(EventSink& events, std::size_t first);
+
+    // Recompute every implied side from the books as they are, without
+    // publishing anything (after the books were restored from a checkpoint)
+    void rebuild();
+
+    // Current implied levels of a book side (empty if it has none)
+    const Levels& implied(SecurityId security_id, Side side) const;
+
+private:
+    // One way to imply a book side: price = x + y (or x - y), pairing the
+    // levels of x's and y's sides best-first.
+    struct Source {
+        const OrderBook* x;
+        Side x_side;
+        const OrderBook* y;
+        Side y_side;
+        bool subtract;
+    };
+
+    struct Output {
+        OrderBook* book;  // book the implied levels are published for
+        Side side;
+        std::vector<Source> sources;
+        Levels levels;
+        bool dirty = false;
+    };
+
+    int depth_;
+    std::vector<Output> outputs_;
+    std::unordered_map<uint64_t, std::size_t> output_by_key_;
+    // (security, side) -> outputs that read it
+    std::unordered_map<uint64_t, std::vector<std::size_t>> dependents_;
+    std::vector<std::size_t> dirty_;
+
+    static uint64_t key(SecurityId security_id, Side side) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(security_id)) << 8) |
+               static_cast<uint8_t>(side);
+    }
+
+    void addSource(OrderBook& book, Side side, const Source& source);
+    void recompute(const Output& out, Levels& next) const;
+    void publish(Output& out, const Levels& next, EventSink& events);
+};
+
+} // namespace cme::sim
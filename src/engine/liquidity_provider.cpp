@@ -0,0 +1,81 @@
+#include "liquidity_provider.h"
+
+namespace cme::sim {
+
+LiquidityProvider::LiquidityProvider(uint64_t seed)
+    : rng_(seed ? seed : 1) {}
+
+void LiquidityProvider::addInstrument(SecurityId security_id, const LiquidityParams& params) {
+    Quote quote{security_id, params};
+    // Quote on the instrument's grid
+    if (params.tick_mantissa > 0) {
+        int64_t ticks = quote.params.reference.mantissa / params.tick_mantissa;
+        quote.params.reference = Price{ticks * params.tick_mantissa};
+    }
+    quotes_.push_back(quote);
+}
+
+std::size_t LiquidityProvider::poll(Timestamp now, std::vector<EngineCommand>& commands) {
+    std::size_t requoted = 0;
+    for (Quote& quote : quotes_) {
+        if (now < quote.next_due) continue;
+        requote(quote, commands);
+        quote.next_due = now + quote.params.requote_ns;
+        ++requoted;
+    }
+    return requoted;
+}
+
+Price LiquidityProvider::reference(SecurityId security_id) const {
+    for (const Quote& quote : quotes_) {
+        if (quote.security_id == security_id) return quote.params.reference;
+    }
+    return Price::null();
+}
+
+void LiquidityProvider::requote(Quote& quote, std::vector<EngineCommand>& commands) {
+    LiquidityParams& p = quote.params;
+    if (p.walk_ticks > 0 && quote.next_due != 0) {
+        auto span = static_cast<uint64_t>(2 * p.walk_ticks + 1);
+        int64_t step = static_cast<int64_t>(nextRandom() % span) - p.walk_ticks;
+        p.reference.mantissa += step * p.tick_mantissa;
+    }
+
+    EngineCommand pull;
+    pull.type = EngineCommand::Type::MassCancel;
+    pull.session_uuid = SESSION_UUID;
+    pull.security_id = quote.security_id;
+    commands.push_back(pull);
+
+    // Best bid sits half the spread (rounded down) below the reference
+    int64_t best_bid = p.reference.mantissa - (p.spread_ticks / 2) * p.tick_mantissa;
+    int64_t best_ask = best_bid + p.spread_ticks * p.tick_mantissa;
+    int64_t step = p.level_ticks * p.tick_mantissa;
+    for (int level = 0; level < p.depth; ++level) {
+        for (Side side : {Side::Buy, Side::Sell}) {
+            EngineCommand cmd;
+            cmd.session_uuid = SESSION_UUID;
+            cmd.security_id = quote.security_id;
+            Order& o = cmd.order;
+            o.session_uuid = SESSION_UUID;
+            o.security_id = quote.security_id;
+            o.side = side;
+            o.order_type = OrderType::Limit;
+            o.time_in_force = TimeInForce::Day;
+            o.price = Price{side == Side::Buy ? best_bid - level * step : best_ask + level * step};
+            o.quantity = p.qty;
+            o.cl_ord_id = "LIQ";
+            commands.push_back(cmd);
+        }
+    }
+}
+
+uint64_t LiquidityProvider::nextRandom() {
+    // xorshift64: deterministic per seed, so runs are repeatable
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 7;
+    rng_ ^= rng_ << 17;
+    return rng_;
+}
+
+} // namespace cme::sim
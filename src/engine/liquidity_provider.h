@@ -0,0 +1,66 @@
+#pragma once
+#include "matching_engine.h"
+#include "../common/types.h"
+#include <cstdint>
+#include <vector>
+
+namespace cme::sim {
+
+// How the liquidity provider quotes one instrument
+struct LiquidityParams {
+    Price reference;               // mid the ladder is built around
+    int64_t tick_mantissa = 0;     // instrument tick, as a Price mantissa
+    int depth = 5;                 // levels per side
+    int spread_ticks = 1;          // best bid to best ask
+    int level_ticks = 1;           // between consecutive levels
+    Quantity qty = 10;             // per level
+    uint64_t requote_ns = 100'000'000;
+    int walk_ticks = 0;            // max random move of the reference per requote
+};
+
+// ---------------------------------------------------------------------------
+// Built-in market maker that keeps books seeded with depth.
+//
+// Runs on the engine thread and produces plain engine commands, so its
+// orders go through the same batch as client orders (and into the journal,
+// so a replay reproduces them). Each requote of an instrument is one mass
+// cancel of the provider's own orders on it followed by a fresh ladder of
+// `depth` bids and offers around the reference price, which optionally
+// random-walks by up to `walk_ticks` per requote. Nothing is tracked
+// between requotes: whatever of the last ladder traded away is simply gone
+// from the mass cancel.
+//
+// The provider's orders belong to SESSION_UUID, which no FIXP session is
+// ever given.
+// ---------------------------------------------------------------------------
+class LiquidityProvider {
+public:
+    static constexpr uint64_t SESSION_UUID = UINT64_MAX - 1;
+
+    explicit LiquidityProvider(uint64_t seed = 1);
+
+    void addInstrument(SecurityId security_id, const LiquidityParams& params);
+    std::size_t instrumentCount() const { return quotes_.size(); }
+
+    // Append the commands of every instrument due for a requote at `now`
+    // (nanoseconds) to `commands`. Returns how many instruments requoted.
+    std::size_t poll(Timestamp now, std::vector<EngineCommand>& commands);
+
+    // Reference price the next requote of `security_id` starts from
+    Price reference(SecurityId security_id) const;
+
+private:
+    struct Quote {
+        SecurityId security_id;
+        LiquidityParams params;
+        Timestamp next_due = 0;    // 0 = quote on the first poll
+    };
+
+    std::vector<Quote> quotes_;
+    uint64_t rng_;
+
+    void requote(Quote& quote, std::vector<EngineCommand>& commands);
+    uint64_t nextRandom();
+};
+
+} // namespace cme::sim
@@ -1,17 +1,118 @@
 #pragma once
 #include "order.h"
 #include "engine_event.h"
+#include "event_sink.h"
+#include "../common/clock.h"
+#include <cstddef>
+#include <optional>
+#include <span>
 #include <vector>
-#include <memory>
 
 namespace cme::sim {
 
+// One decoded order-entry command, as handed to processBatch()
+struct EngineCommand {
+    enum class Type : uint8_t { NewOrder, CancelOrder, ModifyOrder, MassCancel };
+    Type type = Type::NewOrder;
+    uint64_t session_uuid = 0;
+
+    // NewOrder (by value; the engine copies it into storage it owns)
+    Order order;
+
+    // CancelOrder / ModifyOrder target; MassCancel instrument (0 = all)
+    OrderId order_id = 0;
+    SecurityId security_id = 0;
+
+    // ModifyOrder
+    Price new_price;
+    Quantity new_qty = 0;
+    ClOrdId new_cl_ord_id;
+
+    // MassCancel: only this side (both if empty)
+    std::optional<Side> mass_side;
+};
+
+// Where one command's events sit in a batch's event buffer
+struct EventRange {
+    std::size_t first = 0;
+    std::size_t count = 0;
+    uint64_t ticks = 0;   // Clock::ticks() the engine spent on the command
+};
+
 class IMatchingEngine {
 public:
     virtual ~IMatchingEngine() = default;
-    virtual std::vector<EngineEvent> submitOrder(std::unique_ptr<Order> order) = 0;
-    virtual std::vector<EngineEvent> cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) = 0;
-    virtual std::vector<EngineEvent> modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) = 0;
+
+    // Events are appended to `events`; the caller owns and reuses the sink.
+    // The engine copies the order into storage it owns and assigns its ID.
+    virtual void submitOrder(const Order& order, EventSink& events) = 0;
+    virtual void cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid, EventSink& events) = 0;
+    virtual void modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) = 0;
+
+    // Cancel every resting order of `session_uuid`, in one instrument or in
+    // all of them (`security_id` 0), optionally on one side only. Emits an
+    // OrderCancelled per order; nothing if the session has none.
+    virtual void massCancel(uint64_t session_uuid, SecurityId security_id,
+                            std::optional<Side> side, EventSink& events) = 0;
+
+    // Run a batch of commands, appending all their events to `events`;
+    // ranges[i] is set to where commands[i]'s events landed. Commands for
+    // the same instrument run in the order given, but an engine may group
+    // the rest by instrument. Events an engine derives for the batch as a
+    // whole (e.g. implied prices) follow the last range, and their time is
+    // in no range's `ticks`.
+    //
+    // The default runs the commands one by one through the calls above.
+    virtual void processBatch(std::span<const EngineCommand> commands, EventSink& events,
+                              std::vector<EventRange>& ranges) {
+        ranges.resize(commands.size());
+        uint64_t start = Clock::ticks();
+        for (std::size_t i = 0; i < commands.size(); ++i) {
+            const EngineCommand& cmd = commands[i];
+            std::size_t first = events.size();
+            switch (cmd.type) {
+                case EngineCommand::Type::NewOrder:
+                    submitOrder(cmd.order, events);
+                    break;
+                case EngineCommand::Type::CancelOrder:
+                    cancelOrder(cmd.order_id, cmd.security_id, cmd.session_uuid, events);
+                    break;
+                case EngineCommand::Type::ModifyOrder:
+                    modifyOrder(cmd.order_id, cmd.security_id, cmd.new_price, cmd.new_qty,
+                                cmd.new_cl_ord_id, events);
+                    break;
+                case EngineCommand::Type::MassCancel:
+                    massCancel(cmd.session_uuid, cmd.security_id, cmd.mass_side, events);
+                    break;
+            }
+            uint64_t end = Clock::ticks();
+            ranges[i] = {first, events.size() - first, end - start};
+            start = end;
+        }
+    }
+
+    // Convenience wrappers returning a fresh vector of events
+    std::vector<EngineEvent> submitOrder(const Order& order) {
+        EventSink events;
+        submitOrder(order, events);
+        return events.take();
+    }
+    std::vector<EngineEvent> cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) {
+        EventSink events;
+        cancelOrder(order_id, security_id, session_uuid, events);
+        return events.take();
+    }
+    std::vector<EngineEvent> modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) {
+        EventSink events;
+        modifyOrder(order_id, security_id, new_price, new_qty, new_cl_ord_id, events);
+        return events.take();
+    }
+    std::vector<EngineEvent> massCancel(uint64_t session_uuid, SecurityId security_id = 0,
+                                        std::optional<Side> side = std::nullopt) {
+        EventSink events;
+        massCancel(session_uuid, security_id, side, events);
+        return events.take();
+    }
 };
 
 } // namespace cme::sim
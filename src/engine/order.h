@@ -1,5 +1,6 @@
 #pragma once
 #include "../common/types.h"
+#include <algorithm>
 #include <string>
 
 namespace cme::sim {
@@ -8,6 +9,7 @@ struct Order {
     OrderId order_id = 0;
     ClOrdId cl_ord_id;
     uint64_t session_uuid = 0;  // owning session
+    uint32_t smp_id = 0;        // self-match prevention group; 0 = exempt
     SecurityId security_id = 0;
     Side side = Side::Buy;
     OrderType order_type = OrderType::Limit;
@@ -16,7 +18,8 @@ struct Order {
     Price stop_price;
     Quantity quantity = 0;
     Quantity filled_qty = 0;
-    Quantity display_qty = 0;
+    Quantity display_qty = 0;   // iceberg slice size; 0 = fully displayed
+    Quantity shown_qty = 0;     // iceberg: unfilled part of the current slice
     Quantity min_qty = 0;
     Timestamp timestamp = 0;
     OrdStatus status = OrdStatus::New;
@@ -25,9 +28,22 @@ struct Order {
     Quantity remainingQty() const { return quantity - filled_qty; }
     bool isFullyFilled() const { return filled_qty >= quantity; }
 
+    bool isIceberg() const { return display_qty > 0 && display_qty < quantity; }
+    // Quantity shown on the book: the current slice for an iceberg
+    Quantity visibleQty() const { return isIceberg() ? shown_qty : remainingQty(); }
+    // Start a new display slice (iceberg only); returns its size
+    Quantity refreshSlice() {
+        shown_qty = std::min(display_qty, remainingQty());
+        return shown_qty;
+    }
+
     // Intrusive list pointers for price level
     Order* prev_in_level = nullptr;
     Order* next_in_level = nullptr;
+
+    // Intrusive list pointers for the owning session's resting orders
+    Order* prev_in_session = nullptr;
+    Order* next_in_session = nullptr;
 };
 
 } // namespace cme::sim
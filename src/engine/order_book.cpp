@@ -4,31 +4,116 @@
 
 namespace cme::sim {
 
-OrderBook::OrderBook(SecurityId security_id)
-    : security_id_(security_id) {}
+namespace {
+
+bool isStop(OrderType type) {
+    return type == OrderType::StopLimit || type == OrderType::StopMarket;
+}
+
+// Order types whose `price` is a limit that must sit on the book's grid
+bool hasLimitPrice(OrderType type) {
+    return type == OrderType::Limit || type == OrderType::StopLimit;
+}
+
+// hasDepth() as a sweep under self-match prevention sees it: makers that
+// share the taker's smp_id never trade, they are skipped (CancelResting)
+// or end the sweep (the other modes). Walks only until `needed` is found.
+template <Side S>
+bool hasDepthExcludingSmp(const BookSide<S>& makers, Price limit, uint32_t smp_id,
+                          SmpMode mode, Quantity needed) {
+    int64_t depth = 0;
+    for (const auto& [price, level] : makers) {
+        if (!limit.isNull() && BookSide<S>::isBetter(limit, price)) break;
+        for (const Order* maker : level) {
+            if (maker->smp_id == smp_id) {
+                if (mode != SmpMode::CancelResting) return false;
+                continue;
+            }
+            depth += maker->remainingQty();
+            if (depth >= needed) return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+OrderBook::OrderBook(SecurityId security_id, const BookConfig& config)
+    : security_id_(security_id)
+    , bid_levels_(config)
+    , ask_levels_(config)
+    , max_published_depth_(config.max_published_depth)
+    , smp_mode_(config.smp_mode)
+    , index_orders_(config.index_orders) {}
 
 // ---------------------------------------------------------------------------
 // Public interface
 // ---------------------------------------------------------------------------
 
 std::vector<EngineEvent> OrderBook::addOrder(Order* order) {
-    std::vector<EngineEvent> events;
+    EventSink sink;
+    addOrder(order, sink);
+    return sink.take();
+}
+
+std::vector<EngineEvent> OrderBook::cancelOrder(OrderId order_id) {
+    EventSink sink;
+    cancelOrder(order_id, sink);
+    return sink.take();
+}
+
+std::vector<EngineEvent> OrderBook::modifyOrder(OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) {
+    EventSink sink;
+    modifyOrder(order_id, new_price, new_qty, new_cl_ord_id, sink);
+    return sink.take();
+}
+
+void OrderBook::addOrder(Order* order, EventSink& events) {
+    // Ladder-backed books can only hold prices on the tick grid
+    if (hasLimitPrice(order->order_type) && !acceptsPrice(order->side, order->price)) {
+        order->status = OrdStatus::Rejected;
+        events.emit(OrderRejected{
+            order->cl_ord_id,
+            order->session_uuid,
+            RejectReason::PriceOffTickLadder,
+            0
+        });
+        return;
+    }
+
+    if (isStop(order->order_type)) {
+        addStop(order, events);
+        return;
+    }
 
     // FOK: check total available quantity before doing anything
     if (order->time_in_force == TimeInForce::FOK) {
-        if (!canFillFOK(order)) {
-            events.emplace_back(OrderRejected{
+        if (!canFill(order, order->remainingQty())) {
+            order->status = OrdStatus::Rejected;
+            events.emit(OrderRejected{
                 order->cl_ord_id,
                 order->session_uuid,
-                "FOK order cannot be fully filled",
+                RejectReason::FokNotFillable,
                 0
             });
-            return events;
+            return;
         }
     }
 
+    // MinQty: at least min_qty must be executable on arrival
+    if (order->min_qty > 0 && !canFill(order, order->min_qty)) {
+        order->status = OrdStatus::Rejected;
+        events.emit(OrderRejected{
+            order->cl_ord_id,
+            order->session_uuid,
+            RejectReason::MinQtyNotFillable,
+            0
+        });
+        return;
+    }
+
     // Accept the order
-    events.emplace_back(OrderAccepted{
+    events.emit(OrderAccepted{
         order->order_id,
         order->cl_ord_id,
         order->session_uuid,
@@ -40,17 +125,21 @@ std::vector<EngineEvent> OrderBook::addOrder(Order* order) {
         order->time_in_force
     });
 
+    executeOrder(order, events);
+    electStops(events);
+}
+
+void OrderBook::executeOrder(Order* order, EventSink& events) {
     // Attempt matching
-    auto match_events = matchOrder(order);
-    events.insert(events.end(), match_events.begin(), match_events.end());
+    matchOrder(order, events);
 
-    // Post-match handling based on TIF
-    if (!order->isFullyFilled()) {
+    // Post-match handling based on TIF (nothing left if SMP cancelled it)
+    if (!order->isFullyFilled() && order->status != OrdStatus::Canceled) {
         if (order->time_in_force == TimeInForce::IOC ||
             order->time_in_force == TimeInForce::FOK) {
             // Cancel remaining quantity
             order->status = OrdStatus::Canceled;
-            events.emplace_back(OrderCancelled{
+            events.emit(OrderCancelled{
                 order->order_id,
                 order->cl_ord_id,
                 order->session_uuid,
@@ -64,7 +153,7 @@ std::vector<EngineEvent> OrderBook::addOrder(Order* order) {
         } else if (order->order_type == OrderType::Market) {
             // Market order with no liquidity remaining: cancel rest
             order->status = OrdStatus::Canceled;
-            events.emplace_back(OrderCancelled{
+            events.emit(OrderCancelled{
                 order->order_id,
                 order->cl_ord_id,
                 order->session_uuid,
@@ -74,30 +163,28 @@ std::vector<EngineEvent> OrderBook::addOrder(Order* order) {
             });
         }
     }
-
-    return events;
 }
 
-std::vector<EngineEvent> OrderBook::cancelOrder(OrderId order_id) {
-    std::vector<EngineEvent> events;
-
+void OrderBook::cancelOrder(OrderId order_id, EventSink& events) {
     auto it = orders_by_id_.find(order_id);
     if (it == orders_by_id_.end()) {
-        events.emplace_back(OrderCancelRejected{
+        events.emit(OrderCancelRejected{
             order_id,
             ClOrdId{},
             0,
             0,
-            "Order not found"
+            RejectReason::OrderNotFound
         });
-        return events;
+        return;
     }
+    cancelOrder(it->second, events);
+}
 
-    Order* order = it->second;
+void OrderBook::cancelOrder(Order* order, EventSink& events) {
     removeFromBook(order, events);
 
     order->status = OrdStatus::Canceled;
-    events.emplace_back(OrderCancelled{
+    events.emit(OrderCancelled{
         order->order_id,
         order->cl_ord_id,
         order->session_uuid,
@@ -105,32 +192,39 @@ std::vector<EngineEvent> OrderBook::cancelOrder(OrderId order_id) {
         order->filled_qty,
         order->status
     });
-
-    return events;
 }
 
-std::vector<EngineEvent> OrderBook::modifyOrder(OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) {
-    std::vector<EngineEvent> events;
-
+void OrderBook::modifyOrder(OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) {
     auto it = orders_by_id_.find(order_id);
     if (it == orders_by_id_.end()) {
-        events.emplace_back(OrderCancelRejected{
+        events.emit(OrderCancelRejected{
             order_id,
             new_cl_ord_id,
             0,
             0,
-            "Order not found"
+            RejectReason::OrderNotFound
         });
-        return events;
+        return;
     }
+    modifyOrder(it->second, new_price, new_qty, new_cl_ord_id, events);
+}
 
-    Order* order = it->second;
+void OrderBook::modifyOrder(Order* order, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) {
+    if (hasLimitPrice(order->order_type) && !acceptsPrice(order->side, new_price)) {
+        events.emit(OrderCancelRejected{
+            order->order_id,
+            new_cl_ord_id,
+            order->session_uuid,
+            0,
+            RejectReason::PriceOffTickLadder
+        });
+        return;
+    }
 
     // Remove from current position
     removeFromBook(order, events);
 
     // Update fields
-    Price old_price = order->price;
     order->price = new_price;
     order->quantity = new_qty;
     if (!new_cl_ord_id.empty()) {
@@ -139,7 +233,7 @@ std::vector<EngineEvent> OrderBook::modifyOrder(OrderId order_id, Price new_pric
     order->status = OrdStatus::Replaced;
 
     // Generate modify event
-    events.emplace_back(OrderModified{
+    events.emit(OrderModified{
         order->order_id,
         order->cl_ord_id,
         order->session_uuid,
@@ -150,16 +244,22 @@ std::vector<EngineEvent> OrderBook::modifyOrder(OrderId order_id, Price new_pric
         order->remainingQty()
     });
 
+    // An unelected stop keeps waiting for its trigger at the new terms
+    if (isStop(order->order_type)) {
+        restStop(order);
+        return;
+    }
+
     // Re-match at new price
-    auto match_events = matchOrder(order);
-    events.insert(events.end(), match_events.begin(), match_events.end());
+    matchOrder(order, events);
 
     // If not fully filled, re-insert as resting
-    if (!order->isFullyFilled() && order->order_type == OrderType::Limit) {
+    if (!order->isFullyFilled() && order->order_type == OrderType::Limit &&
+        order->status != OrdStatus::Canceled) {
         insertResting(order, events);
     }
 
-    return events;
+    electStops(events);
 }
 
 // ---------------------------------------------------------------------------
@@ -177,369 +277,369 @@ Price OrderBook::bestAsk() const {
 }
 
 int OrderBook::bidLevelCount() const {
-    return static_cast<int>(bid_levels_.size());
+    return bid_levels_.size();
 }
 
 int OrderBook::askLevelCount() const {
-    return static_cast<int>(ask_levels_.size());
+    return ask_levels_.size();
+}
+
+bool OrderBook::acceptsPrice(Side side, Price price) const {
+    return side == Side::Buy ? bid_levels_.accepts(price) : ask_levels_.accepts(price);
 }
 
 // ---------------------------------------------------------------------------
 // Matching logic
 // ---------------------------------------------------------------------------
 
-std::vector<EngineEvent> OrderBook::matchOrder(Order* order) {
-    if (order->order_type == OrderType::Market) {
-        return matchMarket(order);
-    }
-    return matchLimit(order);
-}
-
-std::vector<EngineEvent> OrderBook::matchLimit(Order* order) {
-    std::vector<EngineEvent> events;
+namespace {
 
-    if (order->side == Side::Buy) {
-        // Buy: match against asks where ask_price <= order_price
-        // ask_levels_ is ascending, so iterate from begin (lowest ask)
-        auto it = ask_levels_.begin();
-        while (it != ask_levels_.end() && order->remainingQty() > 0) {
-            if (it->first > order->price) break; // ask too expensive
+// Matching policies for OrderBook::sweep()
+struct LimitPolicy {
+    static constexpr bool price_bounded = true;   // stop at the taker's limit
+};
+struct MarketPolicy {
+    static constexpr bool price_bounded = false;  // take any price
+};
 
-            PriceLevel& level = it->second;
-            Price trade_price = it->first;
+} // anonymous namespace
 
-            while (!level.empty() && order->remainingQty() > 0) {
-                Order* maker = level.front();
-                Quantity trade_qty = std::min(order->remainingQty(), maker->remainingQty());
+void OrderBook::matchOrder(Order* order, EventSink& events) {
+    const bool market = order->order_type == OrderType::Market;
+    if (order->side == Side::Buy) {
+        if (market) sweep<Side::Buy, MarketPolicy>(order, events);
+        else        sweep<Side::Buy, LimitPolicy>(order, events);
+    } else {
+        if (market) sweep<Side::Sell, MarketPolicy>(order, events);
+        else        sweep<Side::Sell, LimitPolicy>(order, events);
+    }
+}
 
-                Quantity old_level_qty = level.total_quantity;
-                int old_level_count = level.order_count;
+template <Side TakerSide, typename Policy>
+void OrderBook::sweep(Order* order, EventSink& events) {
+    constexpr Side MakerSide = opposite(TakerSide);
+    BookSide<MakerSide>& makers = levels<MakerSide>();
+
+    // Loop-invariant, so the per-maker check is one integer compare
+    const uint32_t smp_id = smp_mode_ == SmpMode::None ? 0 : order->smp_id;
+
+    while (order->remainingQty() > 0 && order->status != OrdStatus::Canceled) {
+        PriceLevel* best = makers.best();
+        if (!best) break;
+        if constexpr (Policy::price_bounded) {
+            // A taker price better than the level (from the maker side's
+            // point of view) means the level is beyond the taker's limit
+            if (BookSide<MakerSide>::isBetter(order->price, best->price)) break;
+        }
 
-                Trade trade = executeTrade(maker, order, trade_price, trade_qty);
+        PriceLevel& level = *best;
+        Price trade_price = level.price;
 
-                // Adjust level quantity before removeOrder (which uses
-                // remainingQty(), already 0 for a fully-filled maker).
-                level.total_quantity -= trade_qty;
+        while (!level.empty() && order->remainingQty() > 0) {
+            Order* maker = level.front();
 
-                // Update maker status
-                if (maker->isFullyFilled()) {
-                    maker->status = OrdStatus::Filled;
+            if (smp_id != 0 && maker->smp_id == smp_id) [[unlikely]] {
+                if (smp_mode_ != SmpMode::CancelAggressor) {
+                    // Pull the resting order off the top level, then go on
+                    // sweeping unless the aggressor goes too
+                    Quantity resting_qty = maker->remainingQty();
                     level.removeOrder(maker);
-                    orders_by_id_.erase(maker->order_id);
-                } else {
-                    maker->status = OrdStatus::PartiallyFilled;
+                    makers.addDepth(trade_price, -resting_qty);
+                    cancelForSmp(maker, events);
+                    if (level.empty()) {
+                        generateBookUpdate(security_id_, MakerSide, trade_price,
+                                           0, 0, MDUpdateAction::Delete, 1, events);
+                    } else {
+                        generateBookUpdate(security_id_, MakerSide, trade_price,
+                                           level.total_quantity, level.order_count,
+                                           MDUpdateAction::Change, 1, events);
+                    }
                 }
-
-                // Update taker status
-                if (order->isFullyFilled()) {
-                    order->status = OrdStatus::Filled;
-                } else {
-                    order->status = OrdStatus::PartiallyFilled;
-                }
-
-                // Generate fill event
-                events.emplace_back(OrderFilled{
-                    trade.trade_id,
-                    trade.security_id,
-                    trade.price,
-                    trade.quantity,
-                    trade.aggressor_side,
-                    maker->order_id, maker->cl_ord_id, maker->session_uuid,
-                    maker->filled_qty, maker->remainingQty(), maker->status,
-                    order->order_id, order->cl_ord_id, order->session_uuid,
-                    order->filled_qty, order->remainingQty(), order->status
-                });
-
-                // Book update for the ask level change
-                int level_idx = priceLevelIndex(Side::Sell, trade_price);
-                if (level.empty()) {
-                    generateBookUpdate(security_id_, Side::Sell, trade_price,
-                                       0, 0, MDUpdateAction::Delete, level_idx, events);
-                } else {
-                    generateBookUpdate(security_id_, Side::Sell, trade_price,
-                                       level.total_quantity, level.order_count,
-                                       MDUpdateAction::Change, level_idx, events);
+                if (smp_mode_ != SmpMode::CancelResting) {
+                    cancelForSmp(order, events);
+                    break;
                 }
+                continue;
             }
-
-            if (level.empty()) {
-                it = ask_levels_.erase(it);
+            // An iceberg maker trades at most its displayed slice per turn
+            Quantity trade_qty = std::min(order->remainingQty(), maker->visibleQty());
+
+            Trade trade = executeTrade(maker, order, trade_price, trade_qty);
+            last_trade_price_ = trade_price;
+            if (trade_price < trade_low_) trade_low_ = trade_price;   // null is +inf
+            if (trade_high_.isNull() || trade_price > trade_high_) trade_high_ = trade_price;
+
+            // Adjust level quantity before removeOrder (which uses
+            // visibleQty(), already 0 for a fully-filled maker).
+            level.total_quantity -= trade_qty;
+            if (maker->isIceberg()) maker->shown_qty -= trade_qty;
+            makers.addDepth(trade_price, -trade_qty);
+
+            if (maker->isFullyFilled()) {
+                maker->status = OrdStatus::Filled;
+                level.removeOrder(maker);
+                if (index_orders_) orders_by_id_.erase(maker->order_id);
             } else {
-                ++it;
-            }
-        }
-    } else {
-        // Sell: match against bids where bid_price >= order_price
-        // bid_levels_ is descending, so iterate from begin (highest bid)
-        auto it = bid_levels_.begin();
-        while (it != bid_levels_.end() && order->remainingQty() > 0) {
-            if (it->first < order->price) break; // bid too low
-
-            PriceLevel& level = it->second;
-            Price trade_price = it->first;
-
-            while (!level.empty() && order->remainingQty() > 0) {
-                Order* maker = level.front();
-                Quantity trade_qty = std::min(order->remainingQty(), maker->remainingQty());
-
-                Trade trade = executeTrade(maker, order, trade_price, trade_qty);
-
-                level.total_quantity -= trade_qty;
-
-                if (maker->isFullyFilled()) {
-                    maker->status = OrdStatus::Filled;
-                    level.removeOrder(maker);
-                    orders_by_id_.erase(maker->order_id);
-                } else {
-                    maker->status = OrdStatus::PartiallyFilled;
-                }
-
-                if (order->isFullyFilled()) {
-                    order->status = OrdStatus::Filled;
-                } else {
-                    order->status = OrdStatus::PartiallyFilled;
-                }
-
-                events.emplace_back(OrderFilled{
-                    trade.trade_id,
-                    trade.security_id,
-                    trade.price,
-                    trade.quantity,
-                    trade.aggressor_side,
-                    maker->order_id, maker->cl_ord_id, maker->session_uuid,
-                    maker->filled_qty, maker->remainingQty(), maker->status,
-                    order->order_id, order->cl_ord_id, order->session_uuid,
-                    order->filled_qty, order->remainingQty(), order->status
-                });
-
-                int level_idx = priceLevelIndex(Side::Buy, trade_price);
-                if (level.empty()) {
-                    generateBookUpdate(security_id_, Side::Buy, trade_price,
-                                       0, 0, MDUpdateAction::Delete, level_idx, events);
-                } else {
-                    generateBookUpdate(security_id_, Side::Buy, trade_price,
-                                       level.total_quantity, level.order_count,
-                                       MDUpdateAction::Change, level_idx, events);
+                maker->status = OrdStatus::PartiallyFilled;
+                if (maker->isIceberg() && maker->shown_qty == 0) {
+                    level.replenish(maker);
                 }
             }
 
+            order->status = order->isFullyFilled() ? OrdStatus::Filled
+                                                   : OrdStatus::PartiallyFilled;
+
+            events.emit(OrderFilled{
+                trade.trade_id,
+                trade.security_id,
+                trade.price,
+                trade.quantity,
+                trade.aggressor_side,
+                maker->order_id, maker->cl_ord_id, maker->session_uuid,
+                maker->filled_qty, maker->remainingQty(), maker->status,
+                order->order_id, order->cl_ord_id, order->session_uuid,
+                order->filled_qty, order->remainingQty(), order->status
+            });
+
+            // Matching always consumes the top of the opposite side
+            int level_idx = 1;
             if (level.empty()) {
-                it = bid_levels_.erase(it);
+                generateBookUpdate(security_id_, MakerSide, trade_price,
+                                   0, 0, MDUpdateAction::Delete, level_idx, events);
             } else {
-                ++it;
+                generateBookUpdate(security_id_, MakerSide, trade_price,
+                                   level.total_quantity, level.order_count,
+                                   MDUpdateAction::Change, level_idx, events);
             }
         }
-    }
 
-    return events;
+        if (level.empty()) {
+            makers.erase(&level);
+        }
+    }
 }
 
-std::vector<EngineEvent> OrderBook::matchMarket(Order* order) {
-    std::vector<EngineEvent> events;
-
-    if (order->side == Side::Buy) {
-        auto it = ask_levels_.begin();
-        while (it != ask_levels_.end() && order->remainingQty() > 0) {
-            PriceLevel& level = it->second;
-            Price trade_price = it->first;
-
-            while (!level.empty() && order->remainingQty() > 0) {
-                Order* maker = level.front();
-                Quantity trade_qty = std::min(order->remainingQty(), maker->remainingQty());
-
-                Trade trade = executeTrade(maker, order, trade_price, trade_qty);
-
-                level.total_quantity -= trade_qty;
-
-                if (maker->isFullyFilled()) {
-                    maker->status = OrdStatus::Filled;
-                    level.removeOrder(maker);
-                    orders_by_id_.erase(maker->order_id);
-                } else {
-                    maker->status = OrdStatus::PartiallyFilled;
-                }
-
-                if (order->isFullyFilled()) {
-                    order->status = OrdStatus::Filled;
-                } else {
-                    order->status = OrdStatus::PartiallyFilled;
-                }
+// ---------------------------------------------------------------------------
+// Checkpoint restore
+// ---------------------------------------------------------------------------
 
-                events.emplace_back(OrderFilled{
-                    trade.trade_id,
-                    trade.security_id,
-                    trade.price,
-                    trade.quantity,
-                    trade.aggressor_side,
-                    maker->order_id, maker->cl_ord_id, maker->session_uuid,
-                    maker->filled_qty, maker->remainingQty(), maker->status,
-                    order->order_id, order->cl_ord_id, order->session_uuid,
-                    order->filled_qty, order->remainingQty(), order->status
-                });
-
-                int level_idx = priceLevelIndex(Side::Sell, trade_price);
-                if (level.empty()) {
-                    generateBookUpdate(security_id_, Side::Sell, trade_price,
-                                       0, 0, MDUpdateAction::Delete, level_idx, events);
-                } else {
-                    generateBookUpdate(security_id_, Side::Sell, trade_price,
-                                       level.total_quantity, level.order_count,
-                                       MDUpdateAction::Change, level_idx, events);
-                }
-            }
+void OrderBook::restoreState(const State& state) {
+    next_trade_id_ = state.next_trade_id;
+    rpt_seq_ = state.rpt_seq;
+    last_trade_price_ = state.last_trade_price;
+}
 
-            if (level.empty()) {
-                it = ask_levels_.erase(it);
-            } else {
-                ++it;
-            }
-        }
+void OrderBook::restoreOrder(Order* order) {
+    if (isStop(order->order_type)) {
+        restStop(order);
+        return;
+    }
+    if (index_orders_) orders_by_id_[order->order_id] = order;
+    if (order->side == Side::Buy) {
+        bid_levels_.insert(order->price).first->addOrder(order);
+        bid_levels_.addDepth(order->price, order->remainingQty());
     } else {
-        auto it = bid_levels_.begin();
-        while (it != bid_levels_.end() && order->remainingQty() > 0) {
-            PriceLevel& level = it->second;
-            Price trade_price = it->first;
+        ask_levels_.insert(order->price).first->addOrder(order);
+        ask_levels_.addDepth(order->price, order->remainingQty());
+    }
+}
 
-            while (!level.empty() && order->remainingQty() > 0) {
-                Order* maker = level.front();
-                Quantity trade_qty = std::min(order->remainingQty(), maker->remainingQty());
+// ---------------------------------------------------------------------------
+// Stop orders
+// ---------------------------------------------------------------------------
 
-                Trade trade = executeTrade(maker, order, trade_price, trade_qty);
+void OrderBook::addStop(Order* order, EventSink& events) {
+    // A stop the last trade has already reached would elect on entry; CME
+    // rejects those instead (buy stops must be above the last trade, sell
+    // stops below it).
+    bool reached = false;
+    if (!last_trade_price_.isNull()) {
+        reached = order->side == Side::Buy ? last_trade_price_ >= order->stop_price
+                                           : last_trade_price_ <= order->stop_price;
+    }
+    if (order->stop_price.isNull() || reached) {
+        order->status = OrdStatus::Rejected;
+        events.emit(OrderRejected{
+            order->cl_ord_id,
+            order->session_uuid,
+            RejectReason::InvalidStopPrice,
+            0
+        });
+        return;
+    }
 
-                level.total_quantity -= trade_qty;
+    events.emit(OrderAccepted{
+        order->order_id,
+        order->cl_ord_id,
+        order->session_uuid,
+        order->security_id,
+        order->side,
+        order->price,
+        order->quantity,
+        order->order_type,
+        order->time_in_force
+    });
 
-                if (maker->isFullyFilled()) {
-                    maker->status = OrdStatus::Filled;
-                    level.removeOrder(maker);
-                    orders_by_id_.erase(maker->order_id);
-                } else {
-                    maker->status = OrdStatus::PartiallyFilled;
-                }
+    // Unelected stops are not visible on the book: no BookUpdate
+    restStop(order);
+}
 
-                if (order->isFullyFilled()) {
-                    order->status = OrdStatus::Filled;
-                } else {
-                    order->status = OrdStatus::PartiallyFilled;
-                }
+void OrderBook::restStop(Order* order) {
+    if (index_orders_) orders_by_id_[order->order_id] = order;
+    if (order->side == Side::Buy) {
+        buy_stops_.add(order);
+    } else {
+        sell_stops_.add(order);
+    }
+}
 
-                events.emplace_back(OrderFilled{
-                    trade.trade_id,
-                    trade.security_id,
-                    trade.price,
-                    trade.quantity,
-                    trade.aggressor_side,
-                    maker->order_id, maker->cl_ord_id, maker->session_uuid,
-                    maker->filled_qty, maker->remainingQty(), maker->status,
-                    order->order_id, order->cl_ord_id, order->session_uuid,
-                    order->filled_qty, order->remainingQty(), order->status
-                });
-
-                int level_idx = priceLevelIndex(Side::Buy, trade_price);
-                if (level.empty()) {
-                    generateBookUpdate(security_id_, Side::Buy, trade_price,
-                                       0, 0, MDUpdateAction::Delete, level_idx, events);
-                } else {
-                    generateBookUpdate(security_id_, Side::Buy, trade_price,
-                                       level.total_quantity, level.order_count,
-                                       MDUpdateAction::Change, level_idx, events);
-                }
-            }
+void OrderBook::electStops(EventSink& events) {
+    // Each elected stop may trade and widen the range, electing more
+    // stops; keep going until a pass elects nothing. Iterative, so a long
+    // cascade cannot grow the stack.
+    while (!trade_high_.isNull()) {
+        Price trigger = trade_high_;
+        Order* order = buy_stops_.popElected(trigger);
+        if (!order) {
+            trigger = trade_low_;
+            order = sell_stops_.popElected(trigger);
+        }
+        if (!order) break;
+
+        if (index_orders_) orders_by_id_.erase(order->order_id);
+        order->order_type = order->order_type == OrderType::StopLimit ? OrderType::Limit
+                                                                      : OrderType::Market;
+        events.emit(OrderTriggered{
+            order->order_id,
+            order->cl_ord_id,
+            order->session_uuid,
+            order->security_id,
+            order->side,
+            order->stop_price,
+            trigger,
+            order->order_type
+        });
 
-            if (level.empty()) {
-                it = bid_levels_.erase(it);
-            } else {
-                ++it;
-            }
+        // An elected stop arrives now: FOK and MinQty apply as on entry
+        bool fok_short = order->time_in_force == TimeInForce::FOK &&
+                         !canFill(order, order->remainingQty());
+        bool min_short = order->min_qty > 0 && !canFill(order, order->min_qty);
+        if (fok_short || min_short) {
+            order->status = OrdStatus::Canceled;
+            events.emit(OrderCancelled{
+                order->order_id,
+                order->cl_ord_id,
+                order->session_uuid,
+                order->security_id,
+                order->filled_qty,
+                order->status
+            });
+            continue;
         }
+        executeOrder(order, events);
     }
-
-    return events;
+    trade_low_ = Price::null();
+    trade_high_ = Price::null();
 }
 
-bool OrderBook::canFillFOK(Order* order) const {
-    Quantity needed = order->quantity;
+void OrderBook::cancelForSmp(Order* order, EventSink& events) {
+    if (index_orders_) orders_by_id_.erase(order->order_id);
+    order->status = OrdStatus::Canceled;
+    events.emit(OrderCancelled{
+        order->order_id,
+        order->cl_ord_id,
+        order->session_uuid,
+        order->security_id,
+        order->filled_qty,
+        order->status
+    });
+}
 
+bool OrderBook::canFill(const Order* order, Quantity qty) const {
+    Price limit = order->order_type == OrderType::Market ? Price::null() : order->price;
+    if (smp_mode_ != SmpMode::None && order->smp_id != 0) [[unlikely]] {
+        return order->side == Side::Buy
+            ? hasDepthExcludingSmp(ask_levels_, limit, order->smp_id, smp_mode_, qty)
+            : hasDepthExcludingSmp(bid_levels_, limit, order->smp_id, smp_mode_, qty);
+    }
     if (order->side == Side::Buy) {
-        for (const auto& [price, level] : ask_levels_) {
-            if (order->order_type == OrderType::Limit && price > order->price) break;
-            needed -= level.total_quantity;
-            if (needed <= 0) return true;
-        }
-    } else {
-        for (const auto& [price, level] : bid_levels_) {
-            if (order->order_type == OrderType::Limit && price < order->price) break;
-            needed -= level.total_quantity;
-            if (needed <= 0) return true;
-        }
+        return ask_levels_.hasDepth(limit, qty);
     }
-
-    return needed <= 0;
+    return bid_levels_.hasDepth(limit, qty);
 }
 
 // ---------------------------------------------------------------------------
 // Book manipulation
 // ---------------------------------------------------------------------------
 
-void OrderBook::insertResting(Order* order, std::vector<EngineEvent>& events) {
-    orders_by_id_[order->order_id] = order;
+void OrderBook::insertResting(Order* order, EventSink& events) {
+    if (index_orders_) orders_by_id_[order->order_id] = order;
+    if (order->isIceberg()) order->refreshSlice();
 
     if (order->side == Side::Buy) {
-        auto [it, inserted] = bid_levels_.try_emplace(order->price);
-        if (inserted) {
-            it->second.price = order->price;
-        }
-        it->second.addOrder(order);
+        auto [level, inserted] = bid_levels_.insert(order->price);
+        level->addOrder(order);
+        bid_levels_.addDepth(order->price, order->remainingQty());
 
         int level_idx = priceLevelIndex(Side::Buy, order->price);
         MDUpdateAction action = inserted ? MDUpdateAction::New : MDUpdateAction::Change;
         generateBookUpdate(security_id_, Side::Buy, order->price,
-                           it->second.total_quantity, it->second.order_count,
+                           level->total_quantity, level->order_count,
                            action, level_idx, events);
     } else {
-        auto [it, inserted] = ask_levels_.try_emplace(order->price);
-        if (inserted) {
-            it->second.price = order->price;
-        }
-        it->second.addOrder(order);
+        auto [level, inserted] = ask_levels_.insert(order->price);
+        level->addOrder(order);
+        ask_levels_.addDepth(order->price, order->remainingQty());
 
         int level_idx = priceLevelIndex(Side::Sell, order->price);
         MDUpdateAction action = inserted ? MDUpdateAction::New : MDUpdateAction::Change;
         generateBookUpdate(security_id_, Side::Sell, order->price,
-                           it->second.total_quantity, it->second.order_count,
+                           level->total_quantity, level->order_count,
                            action, level_idx, events);
     }
 }
 
-void OrderBook::removeFromBook(Order* order, std::vector<EngineEvent>& events) {
-    orders_by_id_.erase(order->order_id);
+void OrderBook::removeFromBook(Order* order, EventSink& events) {
+    if (index_orders_) orders_by_id_.erase(order->order_id);
+
+    if (isStop(order->order_type)) {
+        if (order->side == Side::Buy) {
+            buy_stops_.remove(order);
+        } else {
+            sell_stops_.remove(order);
+        }
+        return;
+    }
 
     if (order->side == Side::Buy) {
-        auto it = bid_levels_.find(order->price);
-        if (it != bid_levels_.end()) {
+        PriceLevel* level = bid_levels_.find(order->price);
+        if (level) {
             int level_idx = priceLevelIndex(Side::Buy, order->price);
-            it->second.removeOrder(order);
-            if (it->second.empty()) {
-                bid_levels_.erase(it);
+            level->removeOrder(order);
+            bid_levels_.addDepth(order->price, -order->remainingQty());
+            if (level->empty()) {
+                bid_levels_.erase(level);
                 generateBookUpdate(security_id_, Side::Buy, order->price,
                                    0, 0, MDUpdateAction::Delete, level_idx, events);
             } else {
                 generateBookUpdate(security_id_, Side::Buy, order->price,
-                                   it->second.total_quantity, it->second.order_count,
+                                   level->total_quantity, level->order_count,
                                    MDUpdateAction::Change, level_idx, events);
             }
         }
     } else {
-        auto it = ask_levels_.find(order->price);
-        if (it != ask_levels_.end()) {
+        PriceLevel* level = ask_levels_.find(order->price);
+        if (level) {
             int level_idx = priceLevelIndex(Side::Sell, order->price);
-            it->second.removeOrder(order);
-            if (it->second.empty()) {
-                ask_levels_.erase(it);
+            level->removeOrder(order);
+            ask_levels_.addDepth(order->price, -order->remainingQty());
+            if (level->empty()) {
+                ask_levels_.erase(level);
                 generateBookUpdate(security_id_, Side::Sell, order->price,
                                    0, 0, MDUpdateAction::Delete, level_idx, events);
             } else {
                 generateBookUpdate(security_id_, Side::Sell, order->price,
-                                   it->second.total_quantity, it->second.order_count,
+                                   level->total_quantity, level->order_count,
                                    MDUpdateAction::Change, level_idx, events);
             }
         }
@@ -566,41 +666,20 @@ Trade OrderBook::executeTrade(Order* maker, Order* taker, Price trade_price, Qua
 }
 
 int OrderBook::priceLevelIndex(Side side, Price price) const {
-    int idx = 1;
     if (side == Side::Buy) {
-        for (const auto& [p, level] : bid_levels_) {
-            if (p == price) return idx;
-            ++idx;
-        }
-    } else {
-        for (const auto& [p, level] : ask_levels_) {
-            if (p == price) return idx;
-            ++idx;
-        }
-    }
-    // New level - return the position it would occupy
-    // For a new level, count how many levels are better
-    idx = 1;
-    if (side == Side::Buy) {
-        for (const auto& [p, level] : bid_levels_) {
-            if (price > p) return idx;
-            ++idx;
-        }
-        return idx;
-    } else {
-        for (const auto& [p, level] : ask_levels_) {
-            if (price < p) return idx;
-            ++idx;
-        }
-        return idx;
+        return bid_levels_.rank(price, max_published_depth_);
     }
+    return ask_levels_.rank(price, max_published_depth_);
 }
 
 void OrderBook::generateBookUpdate(SecurityId sec_id, Side side, Price price,
                                     Quantity new_qty, int new_count,
                                     MDUpdateAction action, int level_idx,
-                                    std::vector<EngineEvent>& events) {
-    events.emplace_back(BookUpdate{
+                                    EventSink& events) {
+    // Levels beyond the published MDP depth are never sent
+    if (level_idx == 0) return;
+
+    events.emit(BookUpdate{
         sec_id,
         side,
         price,
@@ -610,6 +689,31 @@ void OrderBook::generateBookUpdate(SecurityId sec_id, Side side, Price price,
         level_idx,
         rpt_seq_++
     });
+
+    // A Delete inside the published depth moves the next level up into the
+    // last published rank; subscribers only learn of it from a New there
+    if (action == MDUpdateAction::Delete && max_published_depth_ > 0) {
+        publishLevelMovedUp(side, events);
+    }
+}
+
+void OrderBook::publishLevelMovedUp(Side side, EventSink& events) {
+    auto publish = [&](const auto& levels) {
+        int rank = 0;
+        for (const auto& [price, level] : levels) {
+            if (level.empty()) continue;   // the deleted one, if a sweep has not erased it yet
+            if (++rank == max_published_depth_) {
+                generateBookUpdate(security_id_, side, price, level.total_quantity,
+                                   level.order_count, MDUpdateAction::New, rank, events);
+                return;
+            }
+        }
+    };
+    if (side == Side::Buy) {
+        publish(bid_levels_);
+    } else {
+        publish(ask_levels_);
+    }
 }
 
 } // namespace cme::sim
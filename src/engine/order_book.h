@@ -2,8 +2,10 @@
 #include "order.h"
 #include "trade.h"
 #include "price_level.h"
+#include "book_side.h"
+#include "stop_book.h"
 #include "engine_event.h"
-#include <map>
+#include "event_sink.h"
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -12,9 +14,19 @@ namespace cme::sim {
 
 class OrderBook {
 public:
-    explicit OrderBook(SecurityId security_id);
+    explicit OrderBook(SecurityId security_id, const BookConfig& config = {});
 
-    // Returns vector of events generated
+    // Append generated events to `events` (never cleared here)
+    void addOrder(Order* order, EventSink& events);
+    void cancelOrder(OrderId order_id, EventSink& events);
+    void modifyOrder(OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events);
+
+    // Same as above for a caller that already holds the resting order
+    // (e.g. resolved through an OrderPool handle); skips the id lookup.
+    void cancelOrder(Order* order, EventSink& events);
+    void modifyOrder(Order* order, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events);
+
+    // Convenience wrappers returning a fresh vector of events
     std::vector<EngineEvent> addOrder(Order* order);
     std::vector<EngineEvent> cancelOrder(OrderId order_id);
     std::vector<EngineEvent> modifyOrder(OrderId order_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id);
@@ -24,35 +36,110 @@ public:
     Price bestAsk() const;
     int bidLevelCount() const;
     int askLevelCount() const;
-    const std::map<Price, PriceLevel, std::greater<Price>>& bidLevels() const { return bid_levels_; }
-    const std::map<Price, PriceLevel>& askLevels() const { return ask_levels_; }
+    const BookSide<Side::Buy>& bidLevels() const { return bid_levels_; }
+    const BookSide<Side::Sell>& askLevels() const { return ask_levels_; }
+    Price lastTradePrice() const { return last_trade_price_; }
+    std::size_t stopOrderCount() const { return buy_stops_.size() + sell_stops_.size(); }
 
     SecurityId securityId() const { return security_id_; }
+    BookBackend backend() const { return bid_levels_.backend(); }
+
+    // Next MDP rpt_seq for this instrument, for book updates published on
+    // its behalf (implied levels)
+    uint32_t nextRptSeq() { return rpt_seq_++; }
+
+    // Counters a checkpoint carries besides the resting orders
+    struct State {
+        uint64_t next_trade_id = 1;
+        uint32_t rpt_seq = 1;
+        Price last_trade_price = Price::null();
+    };
+    State state() const { return {next_trade_id_, rpt_seq_, last_trade_price_}; }
+    void restoreState(const State& state);
+
+    // Visit every resting order in an order that restoreOrder() turns back
+    // into the same book: stops in election order, then bids and asks
+    // best-first, each level in time priority.
+    template <typename F>
+    void forEachOrder(F&& f) const {
+        buy_stops_.forEach(f);
+        sell_stops_.forEach(f);
+        for (const auto& [price, level] : bid_levels_) {
+            for (Order* order : level) f(order);
+        }
+        for (const auto& [price, level] : ask_levels_) {
+            for (Order* order : level) f(order);
+        }
+    }
+
+    // Put a resting order (or unelected stop) back at the end of its
+    // queue as it is, iceberg slice included: no matching, no events.
+    void restoreOrder(Order* order);
 
 private:
     SecurityId security_id_;
-    std::map<Price, PriceLevel, std::greater<Price>> bid_levels_; // descending by price
-    std::map<Price, PriceLevel> ask_levels_;                      // ascending by price
-    std::unordered_map<OrderId, Order*> orders_by_id_;
+    BookSide<Side::Buy> bid_levels_;   // descending by price
+    BookSide<Side::Sell> ask_levels_;  // ascending by price
+    int max_published_depth_;          // 0 = unlimited
+    SmpMode smp_mode_;
+    bool index_orders_;
+    std::unordered_map<OrderId, Order*> orders_by_id_;  // only if index_orders_
+    StopBook<Side::Buy> buy_stops_;    // unelected stops, by trigger price
+    StopBook<Side::Sell> sell_stops_;
+    Price last_trade_price_ = Price::null();
+    // Trade price range since the last election pass (null if no trade):
+    // a sweep can print through a stop and end beyond it again
+    Price trade_low_ = Price::null();
+    Price trade_high_ = Price::null();
 
     uint64_t next_trade_id_ = 1;
     uint32_t rpt_seq_ = 1;
 
-    std::vector<EngineEvent> matchOrder(Order* order);
-    std::vector<EngineEvent> matchLimit(Order* order);
-    std::vector<EngineEvent> matchMarket(Order* order);
-    bool canFillFOK(Order* order) const;
-    void insertResting(Order* order, std::vector<EngineEvent>& events);
-    void removeFromBook(Order* order, std::vector<EngineEvent>& events);
+    void matchOrder(Order* order, EventSink& events);
+
+    // Match an accepted order, then rest or cancel what is left per its TIF
+    void executeOrder(Order* order, EventSink& events);
+
+    // Stop orders: accept/rest an unelected stop, and elect every stop a
+    // trade since the last pass has reached (iteratively, as elected stops
+    // trade): buy stops against the highest price, sell stops the lowest.
+    void addStop(Order* order, EventSink& events);
+    void restStop(Order* order);
+    void electStops(EventSink& events);
+
+    // Single matching kernel: sweeps the side opposite TakerSide best-first.
+    // Policy decides at compile time whether the taker's price bounds the
+    // sweep (limit) or not (market); see order_book.cpp.
+    template <Side TakerSide, typename Policy>
+    void sweep(Order* order, EventSink& events);
+
+    // Cancel `order` (resting or aggressor) because of self-match prevention
+    void cancelForSmp(Order* order, EventSink& events);
+
+    template <Side S>
+    BookSide<S>& levels() {
+        if constexpr (S == Side::Buy) return bid_levels_;
+        else return ask_levels_;
+    }
+
+    // Whether `qty` of this order could execute right now against the
+    // opposite side (within its limit price unless it is a market order)
+    bool canFill(const Order* order, Quantity qty) const;
+    bool acceptsPrice(Side side, Price price) const;
+    void insertResting(Order* order, EventSink& events);
+    void removeFromBook(Order* order, EventSink& events);
     Trade executeTrade(Order* maker, Order* taker, Price trade_price, Quantity trade_qty);
 
-    // Compute 1-based price level index for a given side and price
+    // 1-based price level index for a given side and price (the rank a new
+    // level would take if none rests there). 0 if beyond the published depth.
     int priceLevelIndex(Side side, Price price) const;
 
     void generateBookUpdate(SecurityId sec_id, Side side, Price price,
                             Quantity new_qty, int new_count,
                             MDUpdateAction action, int level_idx,
-                            std::vector<EngineEvent>& events);
+                            EventSink& events);
+    // Publish the level now at rank max_published_depth_, if any
+    void publishLevelMovedUp(Side side, EventSink& events);
 };
 
 } // namespace cme::sim
@@ -0,0 +1,144 @@
+#pragma once
+#include "order.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cme::sim {
+
+using OrderHandle = uint32_t;
+
+// ---------------------------------------------------------------------------
+// Slab allocator for engine-owned Order records.
+//
+// Orders live in fixed-size slabs that are never moved or freed while the
+// pool exists, so Order* stays valid for the lifetime of a handle and the
+// intrusive price-level links never need fixing up. Released slots go on a
+// LIFO free list and are reused before a new slab is allocated.
+//
+// Exchange order IDs embed the handle in their low 24 bits (see
+// makeOrderId()), so cancel/modify resolve an OrderId to its slot with a
+// mask and an index. find() rejects stale IDs whose slot has since been
+// reused by a later order.
+//
+// Not thread-safe: owned by the engine thread.
+// ---------------------------------------------------------------------------
+class OrderPool {
+public:
+    static constexpr OrderHandle INVALID_HANDLE = UINT32_MAX;
+    static constexpr std::size_t MAX_ORDERS = std::size_t{1} << 24;
+
+    explicit OrderPool(std::size_t slab_orders = 4096)
+        : slab_shift_(shiftFor(slab_orders))
+        , slab_mask_((std::size_t{1} << slab_shift_) - 1) {}
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    // Reserve a slot, growing by one slab when the free list is empty.
+    // The slot is reset to a default Order.
+    OrderHandle acquire() {
+        if (free_.empty()) {
+            if (capacity() + slabSize() > MAX_ORDERS) return INVALID_HANDLE;
+            grow();
+        }
+        OrderHandle h = free_.back();
+        free_.pop_back();
+        *get(h) = Order{};
+        ++live_;
+        return h;
+    }
+
+    // Return a slot to the free list. The slot's order_id is cleared so
+    // find() no longer resolves it.
+    void release(OrderHandle h) {
+        get(h)->order_id = 0;
+        free_.push_back(h);
+        --live_;
+    }
+
+    // Rebuild an empty pool with exactly `handles` live, e.g. to restore
+    // orders under the OrderIds they were given before. Each listed slot
+    // is reset to a default Order; the rest go on the free list, lowest
+    // first. False (pool unchanged) if the pool is not empty, a handle is
+    // out of range or one is listed twice.
+    bool restoreLive(std::span<const OrderHandle> handles) {
+        if (live_ != 0) return false;
+        std::size_t needed = 0;
+        for (OrderHandle h : handles) {
+            if (h >= MAX_ORDERS) return false;
+            needed = std::max(needed, std::size_t{h} + 1);
+        }
+        std::size_t slabs = (needed + slab_mask_) >> slab_shift_;
+        std::vector<bool> taken(std::max(slabs * slabSize(), capacity()), false);
+        for (OrderHandle h : handles) {
+            if (taken[h]) return false;
+            taken[h] = true;
+        }
+
+        while (slabs_.size() < slabs) slabs_.push_back(std::make_unique<Order[]>(slabSize()));
+        free_.clear();
+        for (std::size_t h = capacity(); h-- > 0;) {
+            if (!taken[h]) free_.push_back(static_cast<OrderHandle>(h));
+        }
+        for (OrderHandle h : handles) *get(h) = Order{};
+        live_ = handles.size();
+        return true;
+    }
+
+    Order* get(OrderHandle h) {
+        return &slabs_[h >> slab_shift_][h & slab_mask_];
+    }
+
+    // Resolve an exchange OrderId to its live slot, or nullptr if the handle
+    // is out of range or the slot now holds a different order.
+    Order* find(OrderId order_id) {
+        OrderHandle h = handleOf(order_id);
+        if (h >= capacity()) return nullptr;
+        Order* order = get(h);
+        return order->order_id == order_id ? order : nullptr;
+    }
+
+    std::size_t live() const { return live_; }
+    std::size_t capacity() const { return slabs_.size() * slabSize(); }
+
+    // OrderId layout: [sequence:32][shard:8][handle:24]. The sequence keeps
+    // IDs unique across slot reuse and must be non-zero so no ID is 0; the
+    // shard keeps them unique across engine shards with their own pools.
+    static OrderId makeOrderId(uint32_t sequence, OrderHandle h, uint8_t shard = 0) {
+        return (static_cast<OrderId>(sequence) << 32) |
+               (static_cast<OrderId>(shard) << 24) | h;
+    }
+    static OrderHandle handleOf(OrderId order_id) {
+        return static_cast<OrderHandle>(order_id & 0xFFFFFFu);
+    }
+
+private:
+    std::size_t slab_shift_;
+    std::size_t slab_mask_;
+    std::vector<std::unique_ptr<Order[]>> slabs_;
+    std::vector<OrderHandle> free_;
+    std::size_t live_ = 0;
+
+    std::size_t slabSize() const { return slab_mask_ + 1; }
+
+    static std::size_t shiftFor(std::size_t n) {
+        std::size_t shift = 0;
+        while ((std::size_t{1} << shift) < n) ++shift;
+        return shift;
+    }
+
+    void grow() {
+        auto first = static_cast<OrderHandle>(capacity());
+        slabs_.push_back(std::make_unique<Order[]>(slabSize()));
+        // Push in reverse so the lowest handle is handed out first
+        for (std::size_t i = slabSize(); i-- > 0;) {
+            free_.push_back(first + static_cast<OrderHandle>(i));
+        }
+    }
+};
+
+} // namespace cme::sim
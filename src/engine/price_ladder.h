@@ -0,0 +1,261 @@
+#pragma once
+#include "price_level.h"
+#include "../common/fenwick_tree.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Tick-indexed price ladder for one side of an order book.
+//
+// Levels live in a contiguous array indexed by tick offset from an anchor
+// price (slot 0). An occupancy bitmap lets scans skip empty ticks 64 at a
+// time, and a best-price cursor makes top-of-book lookup O(1). When a price
+// falls outside the window the ladder re-anchors around the occupied range,
+// doubling the window if the resting book no longer fits. Fenwick trees
+// over slot occupancy and executable quantity give the rank of any level
+// and the cumulative depth up to any price in O(log n).
+//
+// Every slot carries its price, so PriceLevel::price maps straight back to
+// the slot index. Prices must sit on the tick grid (see accepts()).
+// ---------------------------------------------------------------------------
+template <Side S>
+class PriceLadder {
+public:
+    using Slot = std::pair<const Price, PriceLevel>;
+    static constexpr int NONE = -1;
+
+    // Hard cap on the window so a stray far-away price cannot balloon memory.
+    static constexpr std::size_t MAX_TICKS = std::size_t{1} << 20;
+
+    PriceLadder(int64_t tick_mantissa, std::size_t initial_ticks)
+        : tick_(tick_mantissa)
+        , window_(roundToWords(std::min(std::max<std::size_t>(initial_ticks, 64), MAX_TICKS))) {}
+
+    // True if the price is on the tick grid and the ladder can hold it
+    // alongside the levels already resting.
+    bool accepts(Price price) const {
+        if (tick_ <= 0 || price.mantissa % tick_ != 0) return false;
+        if (indexOf(price) != NONE || count_ == 0) return true;
+        auto [lo, hi] = occupiedTickRange();
+        int64_t t = price.mantissa / tick_;
+        return static_cast<std::size_t>(std::max(hi, t) - std::min(lo, t) + 1) <= MAX_TICKS;
+    }
+
+    PriceLevel* find(Price price) {
+        int idx = indexOf(price);
+        if (idx == NONE || !isOccupied(idx)) return nullptr;
+        return &slots_[idx].second;
+    }
+
+    // Find the level at `price`, creating it if empty. Returns {level, created}.
+    // May re-anchor, which invalidates previously returned level pointers.
+    std::pair<PriceLevel*, bool> insert(Price price) {
+        int idx = indexOf(price);
+        if (idx == NONE) {
+            reanchor(price);
+            idx = indexOf(price);
+        }
+        PriceLevel& level = slots_[idx].second;
+        if (isOccupied(idx)) return {&level, false};
+
+        setOccupied(idx);
+        level_counts_.add(idx, 1);
+        ++count_;
+        if (best_ == NONE || isBetter(idx, best_)) best_ = idx;
+        return {&level, true};
+    }
+
+    // Release an (empty) level back to the ladder.
+    void erase(PriceLevel* level) {
+        int idx = indexOf(level->price);
+        Price price = level->price;
+        *level = PriceLevel{};
+        level->price = price;
+
+        clearOccupied(idx);
+        level_counts_.add(idx, -1);
+        --count_;
+        if (idx == best_) best_ = nextWorse(idx);
+    }
+
+    PriceLevel* best() {
+        return best_ == NONE ? nullptr : &slots_[best_].second;
+    }
+
+    int bestIndex() const { return best_; }
+
+    // Number of occupied levels strictly better than `price`, which must
+    // fall inside the current window (true for any resting level).
+    int countBetter(Price price) const {
+        auto idx = static_cast<std::size_t>(indexOf(price));
+        if constexpr (S == Side::Buy) {
+            return count_ - level_counts_.prefixSum(idx + 1);
+        } else {
+            return level_counts_.prefixSum(idx);
+        }
+    }
+
+    // Executable quantity (visible + iceberg reserve) at `price` changed by
+    // `delta`. The owner reports every change so the depth tree stays exact.
+    void addDepth(Price price, int64_t delta) {
+        depth_.add(static_cast<std::size_t>(indexOf(price)), delta);
+        depth_total_ += delta;
+    }
+
+    int64_t depthTotal() const { return depth_total_; }
+
+    // Executable quantity at levels priced no worse than `limit` for a taker
+    // on the other side: asks at or below it, bids at or above it.
+    int64_t depthThrough(Price limit) const {
+        if (count_ == 0) return 0;
+        int64_t off = limit.mantissa - base_tick_ * tick_;
+        auto slots = static_cast<int64_t>(slots_.size());
+        if constexpr (S == Side::Buy) {
+            // Slots [ceil(off / tick), end)
+            if (off <= 0) return depth_total_;
+            int64_t first = (off + tick_ - 1) / tick_;
+            if (first >= slots) return 0;
+            return depth_total_ - depth_.prefixSum(static_cast<std::size_t>(first));
+        } else {
+            // Slots [0, floor(off / tick)]
+            if (off < 0) return 0;
+            int64_t last = off / tick_;
+            if (last >= slots) return depth_total_;
+            return depth_.prefixSum(static_cast<std::size_t>(last + 1));
+        }
+    }
+
+    // Next occupied slot strictly worse than `idx`, or NONE.
+    int nextWorse(int idx) const {
+        if constexpr (S == Side::Buy) {
+            return scanDown(idx - 1);
+        } else {
+            return scanUp(idx + 1);
+        }
+    }
+
+    const Slot& slot(int idx) const { return slots_[idx]; }
+
+    int size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    std::size_t windowTicks() const { return slots_.size(); }
+
+private:
+    int64_t tick_;
+    std::size_t window_;
+    int64_t base_tick_ = 0;            // absolute tick number of slot 0
+    std::vector<Slot> slots_;
+    std::vector<uint64_t> occupied_;   // one bit per slot
+    FenwickTree<int> level_counts_;    // occupancy, for rank queries
+    FenwickTree<int64_t> depth_;       // executable quantity per slot
+    int64_t depth_total_ = 0;
+    int best_ = NONE;
+    int count_ = 0;
+
+    static std::size_t roundToWords(std::size_t n) { return (n + 63) & ~std::size_t{63}; }
+
+    static bool isBetter(int a, int b) {
+        if constexpr (S == Side::Buy) return a > b;
+        else return a < b;
+    }
+
+    int indexOf(Price price) const {
+        if (slots_.empty()) return NONE;
+        int64_t off = price.mantissa - base_tick_ * tick_;
+        if (off < 0 || off % tick_ != 0) return NONE;
+        int64_t idx = off / tick_;
+        if (idx >= static_cast<int64_t>(slots_.size())) return NONE;
+        return static_cast<int>(idx);
+    }
+
+    bool isOccupied(int idx) const { return (occupied_[idx >> 6] >> (idx & 63)) & 1; }
+    void setOccupied(int idx)   { occupied_[idx >> 6] |= uint64_t{1} << (idx & 63); }
+    void clearOccupied(int idx) { occupied_[idx >> 6] &= ~(uint64_t{1} << (idx & 63)); }
+
+    // Lowest occupied index >= from, or NONE.
+    int scanUp(int from) const {
+        if (from >= static_cast<int>(slots_.size())) return NONE;
+        std::size_t w = static_cast<std::size_t>(from) >> 6;
+        uint64_t bits = occupied_[w] & (~uint64_t{0} << (from & 63));
+        while (!bits) {
+            if (++w == occupied_.size()) return NONE;
+            bits = occupied_[w];
+        }
+        return static_cast<int>(w * 64 + std::countr_zero(bits));
+    }
+
+    // Highest occupied index <= from, or NONE.
+    int scanDown(int from) const {
+        if (from < 0) return NONE;
+        std::size_t w = static_cast<std::size_t>(from) >> 6;
+        uint64_t bits = occupied_[w] & (~uint64_t{0} >> (63 - (from & 63)));
+        while (!bits) {
+            if (w == 0) return NONE;
+            bits = occupied_[--w];
+        }
+        return static_cast<int>(w * 64 + 63 - std::countl_zero(bits));
+    }
+
+    std::pair<int64_t, int64_t> occupiedTickRange() const {
+        int last = static_cast<int>(slots_.size()) - 1;
+        return {base_tick_ + scanUp(0), base_tick_ + scanDown(last)};
+    }
+
+    // Rebuild the window so it covers every resting level plus `price`,
+    // centred on that range. Resting levels are copied across; orders link
+    // to each other rather than to their level, so no order is touched.
+    void reanchor(Price price) {
+        int64_t target = price.mantissa / tick_;
+        int64_t lo = target;
+        int64_t hi = target;
+        if (count_ > 0) {
+            auto [occ_lo, occ_hi] = occupiedTickRange();
+            lo = std::min(lo, occ_lo);
+            hi = std::max(hi, occ_hi);
+        }
+
+        std::size_t span = static_cast<std::size_t>(hi - lo + 1);
+        while (window_ < span * 2 && window_ < MAX_TICKS) window_ *= 2;
+        std::size_t window = std::min(window_, MAX_TICKS);
+
+        int64_t new_base = lo - static_cast<int64_t>((window - span) / 2);
+
+        std::vector<Slot> slots;
+        slots.reserve(window);
+        for (std::size_t i = 0; i < window; ++i) {
+            Price p{(new_base + static_cast<int64_t>(i)) * tick_};
+            slots.emplace_back(p, PriceLevel{});
+            slots.back().second.price = p;
+        }
+        std::vector<uint64_t> occupied(window / 64, 0);
+        FenwickTree<int> level_counts(window);
+        FenwickTree<int64_t> depth(window);
+
+        int new_best = NONE;
+        for (int idx = scanUp(0); idx != NONE; idx = scanUp(idx + 1)) {
+            int moved = static_cast<int>(base_tick_ + idx - new_base);
+            slots[moved].second = slots_[idx].second;
+            occupied[moved >> 6] |= uint64_t{1} << (moved & 63);
+            level_counts.add(static_cast<std::size_t>(moved), 1);
+            const PriceLevel& level = slots[moved].second;
+            depth.add(static_cast<std::size_t>(moved),
+                      int64_t{level.total_quantity} + level.hidden_quantity);
+            if (idx == best_) new_best = moved;
+        }
+
+        slots_ = std::move(slots);
+        occupied_ = std::move(occupied);
+        level_counts_ = std::move(level_counts);
+        depth_ = std::move(depth);
+        base_tick_ = new_base;
+        best_ = new_best;
+    }
+};
+
+} // namespace cme::sim
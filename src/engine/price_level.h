@@ -3,10 +3,16 @@
 
 namespace cme::sim {
 
+// ---------------------------------------------------------------------------
+// FIFO queue of orders at one price. total_quantity is what the book shows
+// (iceberg orders contribute only their current slice); hidden_quantity is
+// the iceberg reserve behind it, so the two together are executable.
+// ---------------------------------------------------------------------------
 class PriceLevel {
 public:
     Price price;
     Quantity total_quantity = 0;
+    Quantity hidden_quantity = 0;
     int order_count = 0;
 
     void addOrder(Order* order) {
@@ -18,27 +24,35 @@ public:
             head_ = order;
         }
         tail_ = order;
-        total_quantity += order->remainingQty();
+        total_quantity += order->visibleQty();
+        hidden_quantity += order->remainingQty() - order->visibleQty();
         ++order_count;
     }
 
     void removeOrder(Order* order) {
-        if (order->prev_in_level) {
-            order->prev_in_level->next_in_level = order->next_in_level;
-        } else {
-            head_ = order->next_in_level;
-        }
-        if (order->next_in_level) {
-            order->next_in_level->prev_in_level = order->prev_in_level;
-        } else {
-            tail_ = order->prev_in_level;
-        }
-        total_quantity -= order->remainingQty();
+        unlink(order);
+        total_quantity -= order->visibleQty();
+        hidden_quantity -= order->remainingQty() - order->visibleQty();
         --order_count;
         order->prev_in_level = nullptr;
         order->next_in_level = nullptr;
     }
 
+    // Iceberg whose slice traded out: show the next slice from the reserve
+    // and requeue it behind everything at this price. O(1), the level and
+    // its place in the book are untouched.
+    void replenish(Order* order) {
+        Quantity slice = order->refreshSlice();
+        total_quantity += slice;
+        hidden_quantity -= slice;
+        if (order == tail_) return;
+        unlink(order);
+        order->prev_in_level = tail_;
+        order->next_in_level = nullptr;
+        tail_->next_in_level = order;
+        tail_ = order;
+    }
+
     Order* front() const { return head_; }
     bool empty() const { return head_ == nullptr; }
 
@@ -67,6 +81,19 @@ public:
 private:
     Order* head_ = nullptr;
     Order* tail_ = nullptr;
+
+    void unlink(Order* order) {
+        if (order->prev_in_level) {
+            order->prev_in_level->next_in_level = order->next_in_level;
+        } else {
+            head_ = order->next_in_level;
+        }
+        if (order->next_in_level) {
+            order->next_in_level->prev_in_level = order->prev_in_level;
+        } else {
+            tail_ = order->prev_in_level;
+        }
+    }
 };
 
 } // namespace cme::sim
@@ -0,0 +1,73 @@
+#pragma once
+#include "price_level.h"
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <type_traits>
+
+namespace cme::sim {
+
+// ---------------------------------------------------------------------------
+// Resting stop orders for one side of an instrument, indexed by trigger
+// price.
+//
+// A buy stop is elected by a trade at or above its stop price, a sell stop
+// by a trade at or below it. Levels are kept ordered so the first level is
+// always the next one a trade can elect: ascending stop prices for buys,
+// descending for sells. Electing stops is then a walk from the front that
+// stops at the first level the last trade price has not reached, however
+// many stops rest behind it. Orders at one stop price elect in time order.
+//
+// Stops reuse PriceLevel's intrusive list; a stop is never in the visible
+// book at the same time, so the links are free.
+// ---------------------------------------------------------------------------
+template <Side S>
+class StopBook {
+    using Compare = std::conditional_t<S == Side::Buy, std::less<Price>, std::greater<Price>>;
+
+public:
+    void add(Order* order) {
+        auto [it, inserted] = levels_.try_emplace(order->stop_price);
+        if (inserted) it->second.price = order->stop_price;
+        it->second.addOrder(order);
+        ++count_;
+    }
+
+    void remove(Order* order) {
+        auto it = levels_.find(order->stop_price);
+        if (it == levels_.end()) return;
+        it->second.removeOrder(order);
+        if (it->second.empty()) levels_.erase(it);
+        --count_;
+    }
+
+    // Remove and return the oldest stop elected by a trade at `last`, or
+    // nullptr if none is.
+    Order* popElected(Price last) {
+        if (levels_.empty()) return nullptr;
+        auto it = levels_.begin();
+        if (Compare{}(last, it->first)) return nullptr; // trigger not reached
+        Order* order = it->second.front();
+        it->second.removeOrder(order);
+        if (it->second.empty()) levels_.erase(it);
+        --count_;
+        return order;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // Visit every stop in election order (trigger priority, then time)
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const auto& [price, level] : levels_) {
+            for (Order* order : level) f(order);
+        }
+    }
+
+private:
+    std::map<Price, PriceLevel, Compare> levels_;
+    std::size_t count_ = 0;
+};
+
+} // namespace cme::sim
@@ -31,29 +31,29 @@ Timestamp SyntheticEngine::nowNs() {
 // IMatchingEngine interface
 // --------------------------------------------------------------------------
 
-std::vector<EngineEvent> SyntheticEngine::submitOrder(std::unique_ptr<Order> order) {
-    std::vector<EngineEvent> events;
+void SyntheticEngine::submitOrder(const Order& submitted, EventSink& events) {
+    Order order = submitted;
 
     // Assign order ID
-    order->order_id = next_order_id_++;
-    order->timestamp = nowNs();
-    order->status = OrdStatus::New;
+    order.order_id = next_order_id_++;
+    order.timestamp = nowNs();
+    order.status = OrdStatus::New;
 
-    SecurityId sec_id = order->security_id;
-    OrderId oid = order->order_id;
+    SecurityId sec_id = order.security_id;
+    OrderId oid = order.order_id;
 
     // Emit OrderAccepted
     OrderAccepted accepted{};
-    accepted.order_id = order->order_id;
-    accepted.cl_ord_id = order->cl_ord_id;
-    accepted.session_uuid = order->session_uuid;
-    accepted.security_id = order->security_id;
-    accepted.side = order->side;
-    accepted.price = order->price;
-    accepted.quantity = order->quantity;
-    accepted.order_type = order->order_type;
-    accepted.time_in_force = order->time_in_force;
-    events.push_back(accepted);
+    accepted.order_id = order.order_id;
+    accepted.cl_ord_id = order.cl_ord_id;
+    accepted.session_uuid = order.session_uuid;
+    accepted.security_id = order.security_id;
+    accepted.side = order.side;
+    accepted.price = order.price;
+    accepted.quantity = order.quantity;
+    accepted.order_type = order.order_type;
+    accepted.time_in_force = order.time_in_force;
+    events.emit(accepted);
 
     // Check for immediate fill against current BBO
     BBO bbo;
@@ -65,47 +65,44 @@ std::vector<EngineEvent> SyntheticEngine::submitOrder(std::unique_ptr<Order> ord
         }
     }
 
-    if (isMarketable(*order, bbo)) {
+    if (isMarketable(order, bbo)) {
         // Determine fill price
         Price fill_price;
-        if (order->side == Side::Buy) {
+        if (order.side == Side::Buy) {
             fill_price = bbo.best_ask;
         } else {
             fill_price = bbo.best_bid;
         }
 
-        Quantity fill_qty = order->remainingQty();
-        events.push_back(generateFill(*order, fill_price, fill_qty));
+        Quantity fill_qty = order.remainingQty();
+        events.emit(generateFill(order, fill_price, fill_qty));
     } else {
         // IOC/FOK orders that are not marketable get cancelled
-        if (order->time_in_force == TimeInForce::IOC ||
-            order->time_in_force == TimeInForce::FOK) {
-            order->status = OrdStatus::Canceled;
+        if (order.time_in_force == TimeInForce::IOC ||
+            order.time_in_force == TimeInForce::FOK) {
+            order.status = OrdStatus::Canceled;
 
             OrderCancelled cancelled{};
-            cancelled.order_id = order->order_id;
-            cancelled.cl_ord_id = order->cl_ord_id;
-            cancelled.session_uuid = order->session_uuid;
-            cancelled.security_id = order->security_id;
-            cancelled.cum_qty = order->filled_qty;
+            cancelled.order_id = order.order_id;
+            cancelled.cl_ord_id = order.cl_ord_id;
+            cancelled.session_uuid = order.session_uuid;
+            cancelled.security_id = order.security_id;
+            cancelled.cum_qty = order.filled_qty;
             cancelled.ord_status = OrdStatus::Canceled;
-            events.push_back(cancelled);
+            events.emit(cancelled);
         } else {
             // Store as resting order
             std::lock_guard<std::mutex> lock(orders_mutex_);
             orders_by_security_[sec_id].push_back(oid);
             RestingOrder resting;
-            resting.order = std::move(order);
+            resting.order = order;
             resting.submit_time = nowNs();
             resting_orders_.emplace(oid, std::move(resting));
         }
     }
-
-    return events;
 }
 
-std::vector<EngineEvent> SyntheticEngine::cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) {
-    std::vector<EngineEvent> events;
+void SyntheticEngine::cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid, EventSink& events) {
     std::lock_guard<std::mutex> lock(orders_mutex_);
 
     auto it = resting_orders_.find(order_id);
@@ -114,12 +111,12 @@ std::vector<EngineEvent> SyntheticEngine::cancelOrder(OrderId order_id, Security
         rejected.order_id = order_id;
         rejected.session_uuid = session_uuid;
         rejected.reject_reason_code = 1;
-        rejected.reason = "Unknown order";
-        events.push_back(rejected);
-        return events;
+        rejected.reason = RejectReason::OrderNotFound;
+        events.emit(rejected);
+        return;
     }
 
-    Order& order = *it->second.order;
+    Order& order = it->second.order;
     order.status = OrdStatus::Canceled;
 
     OrderCancelled cancelled{};
@@ -129,18 +126,16 @@ std::vector<EngineEvent> SyntheticEngine::cancelOrder(OrderId order_id, Security
     cancelled.security_id = order.security_id;
     cancelled.cum_qty = order.filled_qty;
     cancelled.ord_status = OrdStatus::Canceled;
-    events.push_back(cancelled);
+    events.emit(cancelled);
 
     // Remove from orders_by_security_
     auto& sec_orders = orders_by_security_[security_id];
     sec_orders.erase(std::remove(sec_orders.begin(), sec_orders.end(), order_id), sec_orders.end());
 
     resting_orders_.erase(it);
-    return events;
 }
 
-std::vector<EngineEvent> SyntheticEngine::modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) {
-    std::vector<EngineEvent> events;
+void SyntheticEngine::modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) {
     std::lock_guard<std::mutex> lock(orders_mutex_);
 
     auto it = resting_orders_.find(order_id);
@@ -148,12 +143,12 @@ std::vector<EngineEvent> SyntheticEngine::modifyOrder(OrderId order_id, Security
         OrderCancelRejected rejected{};
         rejected.order_id = order_id;
         rejected.reject_reason_code = 1;
-        rejected.reason = "Unknown order";
-        events.push_back(rejected);
-        return events;
+        rejected.reason = RejectReason::OrderNotFound;
+        events.emit(rejected);
+        return;
     }
 
-    Order& order = *it->second.order;
+    Order& order = it->second.order;
     order.price = new_price;
     order.quantity = new_qty;
     order.cl_ord_id = new_cl_ord_id;
@@ -168,9 +163,39 @@ std::vector<EngineEvent> SyntheticEngine::modifyOrder(OrderId order_id, Security
     modified.new_qty = new_qty;
     modified.cum_qty = order.filled_qty;
     modified.leaves_qty = order.remainingQty();
-    events.push_back(modified);
+    events.emit(modified);
+}
 
-    return events;
+void SyntheticEngine::massCancel(uint64_t session_uuid, SecurityId security_id,
+                                 std::optional<Side> side, EventSink& events) {
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+
+    // Resting orders here are only those replay has not filled yet, so a
+    // scan of the instrument lists is cheap enough
+    for (auto& [sec_id, sec_orders] : orders_by_security_) {
+        if (security_id != 0 && sec_id != security_id) continue;
+        auto keep = std::remove_if(sec_orders.begin(), sec_orders.end(), [&](OrderId oid) {
+            auto it = resting_orders_.find(oid);
+            if (it == resting_orders_.end()) return true;
+            Order& order = it->second.order;
+            if (order.session_uuid != session_uuid) return false;
+            if (side && order.side != *side) return false;
+
+            order.status = OrdStatus::Canceled;
+            OrderCancelled cancelled{};
+            cancelled.order_id = order.order_id;
+            cancelled.cl_ord_id = order.cl_ord_id;
+            cancelled.session_uuid = order.session_uuid;
+            cancelled.security_id = order.security_id;
+            cancelled.cum_qty = order.filled_qty;
+            cancelled.ord_status = OrdStatus::Canceled;
+            events.emit(cancelled);
+
+            resting_orders_.erase(it);
+            return true;
+        });
+        sec_orders.erase(keep, sec_orders.end());
+    }
 }
 
 // --------------------------------------------------------------------------
@@ -374,7 +399,7 @@ std::vector<EngineEvent> SyntheticEngine::checkFillsOnTrade(
         auto oit = resting_orders_.find(oid);
         if (oit == resting_orders_.end()) continue;
 
-        Order& order = *oit->second.order;
+        Order& order = oit->second.order;
 
         // Check if the trade price crosses the resting order
         bool should_fill_price = false;
@@ -26,9 +26,16 @@ public:
     ~SyntheticEngine() override;
 
     // IMatchingEngine interface
-    std::vector<EngineEvent> submitOrder(std::unique_ptr<Order> order) override;
-    std::vector<EngineEvent> cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid) override;
-    std::vector<EngineEvent> modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id) override;
+    using IMatchingEngine::submitOrder;
+    using IMatchingEngine::cancelOrder;
+    using IMatchingEngine::modifyOrder;
+    using IMatchingEngine::massCancel;
+
+    void submitOrder(const Order& order, EventSink& events) override;
+    void cancelOrder(OrderId order_id, SecurityId security_id, uint64_t session_uuid, EventSink& events) override;
+    void modifyOrder(OrderId order_id, SecurityId security_id, Price new_price, Quantity new_qty, ClOrdId new_cl_ord_id, EventSink& events) override;
+    void massCancel(uint64_t session_uuid, SecurityId security_id,
+                    std::optional<Side> side, EventSink& events) override;
 
     // Start/stop pcap replay
     void startReplay();
@@ -57,7 +64,7 @@ private:
 
     // Resting orders waiting for fills
     struct RestingOrder {
-        std::unique_ptr<Order> order;
+        Order order;
         Timestamp submit_time;
     };
     mutable std::mutex orders_mutex_;
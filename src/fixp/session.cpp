@@ -3,6 +3,20 @@
 
 namespace cme::sim::fixp {
 
+namespace {
+
+// Wrap a request view (checking the whole fixed block is present) and read
+// its sequence number
+template <typename View>
+bool readSeqNum(const char* data, size_t len, uint32_t& seq) {
+    View msg;
+    if (!msg.wrap(data, len)) return false;
+    seq = msg.seqNum();
+    return true;
+}
+
+} // namespace
+
 Session::Session(uint64_t assigned_uuid, SendCallback send_cb, AppMessageCallback app_cb)
     : uuid_(assigned_uuid)
     , send_cb_(std::move(send_cb))
@@ -276,35 +290,37 @@ void Session::handleApplicationMessage(uint16_t templateId, const char* data, si
         return;
     }
 
-    // Extract the client's sequence number from the message body.
-    // For iLink3 application messages, seqNum is typically at a fixed offset
-    // in the body. However, the offset varies by message type.
-    // We use next_in_seq_ to track expected sequence and detect gaps.
-
-    // For NewOrderSingle514: seqNum is at body offset 17
-    // For OrderCancelReplaceRequest515: seqNum is at body offset 17
-    // For OrderCancelRequest516: seqNum is at body offset 17
-    // Read seqNum from the appropriate position based on templateId.
+    // Extract the client's sequence number from the message body. Every
+    // iLink3 order-entry request carries it at body offset 17; the views
+    // also make sure the message is long enough to hold it.
     uint32_t client_seq = 0;
-    const char* body = data + sbe::MessageHeader::SIZE;
+    bool complete = true;
 
     switch (templateId) {
         case sbe::NewOrderSingle514::TEMPLATE_ID:
-            std::memcpy(&client_seq, body + 17, 4); // seqNum at offset 17
+            complete = readSeqNum<sbe::NewOrderSingle514View>(data, len, client_seq);
             break;
         case sbe::OrderCancelReplaceRequest515::TEMPLATE_ID:
-            std::memcpy(&client_seq, body + 17, 4);
+            complete = readSeqNum<sbe::OrderCancelReplaceRequest515View>(data, len, client_seq);
             break;
         case sbe::OrderCancelRequest516::TEMPLATE_ID:
-            std::memcpy(&client_seq, body + 17, 4);
+            complete = readSeqNum<sbe::OrderCancelRequest516View>(data, len, client_seq);
+            break;
+        case sbe::OrderMassActionRequest529::TEMPLATE_ID:
+            complete = readSeqNum<sbe::OrderMassActionRequest529View>(data, len, client_seq);
             break;
         default:
             // Unknown app message type; try offset 17 as common pattern
             if (len >= sbe::MessageHeader::SIZE + 21) {
-                std::memcpy(&client_seq, body + 17, 4);
+                std::memcpy(&client_seq, data + sbe::MessageHeader::SIZE + 17, 4);
             }
             break;
     }
+    if (!complete) {
+        logger_->warn("UUID={}: truncated app message (templateId={}, {}B), ignoring",
+                      uuid_, templateId, len);
+        return;
+    }
 
     // Gap detection: if client_seq > next_in_seq_, messages were skipped
     if (client_seq > next_in_seq_) {
@@ -1,4 +1,5 @@
 #include "session_manager.h"
+#include <algorithm>
 
 namespace cme::sim::fixp {
 
@@ -72,4 +73,14 @@ size_t SessionManager::activeSessionCount() const {
     return sessions_.size();
 }
 
+uint64_t SessionManager::nextUuid() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_uuid_;
+}
+
+void SessionManager::setNextUuid(uint64_t uuid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_uuid_ = std::max(next_uuid_, uuid);
+}
+
 } // namespace cme::sim::fixp
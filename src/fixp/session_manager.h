@@ -25,6 +25,11 @@ public:
 
     size_t activeSessionCount() const;
 
+    // UUID the next session gets. Restored from a checkpoint so new
+    // sessions never take over the UUID of restored orders' owners.
+    uint64_t nextUuid() const;
+    void setNextUuid(uint64_t uuid);
+
 private:
     std::unordered_map<uint64_t, std::shared_ptr<Session>> sessions_;
     uint64_t next_uuid_ = 1;
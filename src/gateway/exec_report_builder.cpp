@@ -26,7 +26,7 @@ static uint64_t currentTimeNanos() {
 }
 
 std::string ExecReportBuilder::generateExecId() {
-    return std::to_string(next_exec_id_++);
+    return std::to_string(next_exec_id_.fetch_add(1, std::memory_order_relaxed));
 }
 
 std::vector<char> ExecReportBuilder::buildExecutionReportNew(
@@ -48,7 +48,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportNew(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
 
     // Encode SBE header + body only (TcpConnection adds SOFH framing)
     size_t sbe_len = msg.encodedLength();
@@ -71,7 +71,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportReject(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
 
     msg.ordStatus = '8';
     msg.execType = '8';
@@ -91,7 +91,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportFill(
 
     if (is_maker) {
         msg.orderID = event.maker_order_id;
-        sbe::writeFixedString(msg.clOrdID, event.maker_cl_ord_id.c_str(), 20);
+        sbe::writeFixedString(msg.clOrdID, event.maker_cl_ord_id, 20);
         msg.cumQty = static_cast<uint32_t>(event.maker_cum_qty);
         msg.leavesQty = static_cast<uint32_t>(event.maker_leaves_qty);
         msg.side = (event.aggressor_side == Side::Buy)
@@ -100,7 +100,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportFill(
         msg.ordStatus = ordStatusToChar(event.maker_ord_status);
     } else {
         msg.orderID = event.taker_order_id;
-        sbe::writeFixedString(msg.clOrdID, event.taker_cl_ord_id.c_str(), 20);
+        sbe::writeFixedString(msg.clOrdID, event.taker_cl_ord_id, 20);
         msg.cumQty = static_cast<uint32_t>(event.taker_cum_qty);
         msg.leavesQty = static_cast<uint32_t>(event.taker_leaves_qty);
         msg.side = static_cast<uint8_t>(event.aggressor_side);
@@ -147,7 +147,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportCancel(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
 
     size_t sbe_len = msg.encodedLength();
     std::vector<char> buf(sbe_len, 0);
@@ -175,7 +175,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportModify(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
 
     size_t sbe_len = msg.encodedLength();
     std::vector<char> buf(sbe_len, 0);
@@ -206,7 +206,7 @@ std::vector<char> ExecReportBuilder::buildExecutionReportElimination(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
 
     size_t sbe_len = msg.encodedLength();
     std::vector<char> buf(sbe_len, 0);
@@ -229,7 +229,35 @@ std::vector<char> ExecReportBuilder::buildOrderCancelReject(
 
     std::string exec_id = generateExecId();
     sbe::writeFixedString(msg.execID, exec_id.c_str(), 40);
-    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id.c_str(), 20);
+    sbe::writeFixedString(msg.clOrdID, event.cl_ord_id, 20);
+
+    size_t sbe_len = msg.encodedLength();
+    std::vector<char> buf(sbe_len, 0);
+    msg.encode(buf.data(), 0);
+
+    return buf;
+}
+
+std::vector<char> ExecReportBuilder::buildOrderMassActionReport(
+    uint64_t uuid, uint64_t order_request_id, SecurityId security_id, uint8_t scope,
+    uint8_t side, uint32_t total_affected, std::optional<uint8_t> reject_reason) {
+
+    sbe::OrderMassActionReport562 msg;
+    msg.uuid = uuid;
+    msg.orderRequestID = order_request_id;
+    msg.massActionReportID = next_exec_id_.fetch_add(1, std::memory_order_relaxed);
+    msg.securityID = security_id;
+    msg.massActionScope = scope;
+    msg.side = side;
+    msg.totalAffectedOrders = total_affected;
+    if (reject_reason) {
+        msg.massActionResponse = sbe::OrderMassActionReport562::RESPONSE_REJECTED;
+        msg.massActionRejectReason = *reject_reason;
+    }
+
+    auto now = currentTimeNanos();
+    msg.transactTime = now;
+    msg.sendingTimeEpoch = now;
 
     size_t sbe_len = msg.encodedLength();
     std::vector<char> buf(sbe_len, 0);
@@ -2,6 +2,8 @@
 
 #include "../common/types.h"
 #include "../engine/engine_event.h"
+#include <atomic>
+#include <optional>
 #include <vector>
 #include <string>
 #include <cstdint>
@@ -17,11 +19,16 @@ public:
     std::vector<char> buildExecutionReportModify(const OrderModified& event, uint64_t uuid);
     std::vector<char> buildExecutionReportElimination(const OrderAccepted& event, uint64_t uuid);
     std::vector<char> buildOrderCancelReject(const OrderCancelRejected& event, uint64_t uuid);
+    // Answer to an OrderMassActionRequest; a `reject_reason` rejects it
+    std::vector<char> buildOrderMassActionReport(uint64_t uuid, uint64_t order_request_id,
+                                                 SecurityId security_id, uint8_t scope,
+                                                 uint8_t side, uint32_t total_affected,
+                                                 std::optional<uint8_t> reject_reason = std::nullopt);
 
     std::vector<char> buildFromEvent(const EngineEvent& event, uint64_t session_uuid);
 
 private:
-    uint64_t next_exec_id_ = 1;
+    std::atomic<uint64_t> next_exec_id_{1};  // shared by engine shards
     std::string generateExecId();
 };
 
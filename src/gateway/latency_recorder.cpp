@@ -0,0 +1,35 @@
+#include "latency_recorder.h"
+#include <cstdio>
+
+namespace cme::sim::gateway {
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::QueueWait: return "queue_wait";
+        case LatencyStage::Match:     return "match";
+        case LatencyStage::Encode:    return "encode";
+    }
+    return "?";
+}
+
+const char* commandTypeName(EngineCommand::Type type) {
+    switch (type) {
+        case EngineCommand::Type::NewOrder:    return "NewOrder";
+        case EngineCommand::Type::CancelOrder: return "Cancel";
+        case EngineCommand::Type::ModifyOrder: return "Modify";
+        case EngineCommand::Type::MassCancel:  return "MassCancel";
+    }
+    return "?";
+}
+
+std::string formatLatency(const LatencyHistogram& histogram, double nanos_per_tick) {
+    auto us = [&](uint64_t ticks) { return static_cast<double>(ticks) * nanos_per_tick / 1000.0; };
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "n=%llu p50=%.2fus p99=%.2fus p99.9=%.2fus max=%.2fus",
+                  static_cast<unsigned long long>(histogram.count()),
+                  us(histogram.percentile(50.0)), us(histogram.percentile(99.0)),
+                  us(histogram.percentile(99.9)), us(histogram.max()));
+    return buf;
+}
+
+} // namespace cme::sim::gateway
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../common/latency_histogram.h"
+#include "../common/types.h"
+#include "../engine/matching_engine.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace cme::sim::gateway {
+
+// Where a command's time goes on its way through an engine shard
+enum class LatencyStage : uint8_t {
+    QueueWait,  // pushed by the IO thread to drained by the engine thread
+    Match,      // inside the matching engine
+    Encode,     // building its exec reports
+};
+
+const char* latencyStageName(LatencyStage stage);
+const char* commandTypeName(EngineCommand::Type type);
+
+// ---------------------------------------------------------------------------
+// Latency histograms of one engine shard, per instrument, command type and
+// stage, in Clock::ticks().
+//
+// Owned and written by the shard's engine thread only, so recording is a
+// hash lookup (skipped for runs of one instrument) and a histogram
+// increment with no atomics. Read it from that thread, or once it stopped.
+// ---------------------------------------------------------------------------
+class LatencyRecorder {
+public:
+    static constexpr std::size_t STAGES = 3;
+    static constexpr std::size_t COMMAND_TYPES = 4;
+
+    void record(LatencyStage stage, const EngineCommand& cmd, uint64_t ticks) {
+        SecurityId security_id = cmd.type == EngineCommand::Type::NewOrder
+                                     ? cmd.order.security_id : cmd.security_id;
+        setFor(security_id)[index(stage, cmd.type)].record(ticks);
+    }
+
+    // fn(security_id, type, stage, histogram) for every histogram with data
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& [security_id, set] : sets_) {
+            for (std::size_t t = 0; t < COMMAND_TYPES; ++t) {
+                for (std::size_t s = 0; s < STAGES; ++s) {
+                    const LatencyHistogram& h = (*set)[t * STAGES + s];
+                    if (h.count() == 0) continue;
+                    fn(security_id, static_cast<EngineCommand::Type>(t),
+                       static_cast<LatencyStage>(s), h);
+                }
+            }
+        }
+    }
+
+    void reset() { sets_.clear(); last_set_ = nullptr; }
+
+private:
+    using HistogramSet = std::array<LatencyHistogram, STAGES * COMMAND_TYPES>;
+
+    std::unordered_map<SecurityId, std::unique_ptr<HistogramSet>> sets_;
+    SecurityId last_security_ = 0;
+    HistogramSet* last_set_ = nullptr;
+
+    static std::size_t index(LatencyStage stage, EngineCommand::Type type) {
+        return static_cast<std::size_t>(type) * STAGES + static_cast<std::size_t>(stage);
+    }
+
+    HistogramSet& setFor(SecurityId security_id) {
+        if (last_set_ && security_id == last_security_) return *last_set_;
+        auto& set = sets_[security_id];
+        if (!set) set = std::make_unique<HistogramSet>();
+        last_security_ = security_id;
+        last_set_ = set.get();
+        return *set;
+    }
+};
+
+// "n=1200 p50=1.4us p99=6.1us p99.9=12.0us max=40.2us", scaling ticks by
+// `nanos_per_tick`
+std::string formatLatency(const LatencyHistogram& histogram, double nanos_per_tick);
+
+} // namespace cme::sim::gateway
@@ -1,4 +1,5 @@
 #include "message_validator.h"
+#include "../sbe/ilink3_messages.h"
 
 namespace cme::sim::gateway {
 
@@ -52,6 +53,16 @@ MessageValidator::ValidationResult MessageValidator::validateNewOrder(const Orde
         }
     }
 
+    // Stop orders need a trigger price on the tick grid
+    if (order.order_type == OrderType::StopLimit || order.order_type == OrderType::StopMarket) {
+        if (order.stop_price.isNull() || !isValidPrice(order.security_id, order.stop_price)) {
+            result.valid = false;
+            result.reason = "Stop price missing or not on valid tick";
+            result.reject_reason = 15; // InvalidPriceIncrement
+            return result;
+        }
+    }
+
     // Check quantity
     if (!isValidQuantity(order.security_id, order.quantity)) {
         result.valid = false;
@@ -60,6 +71,14 @@ MessageValidator::ValidationResult MessageValidator::validateNewOrder(const Orde
         return result;
     }
 
+    // MinQty must be satisfiable by the order itself
+    if (order.min_qty > order.quantity) {
+        result.valid = false;
+        result.reason = "MinQty exceeds order quantity";
+        result.reject_reason = 13; // IncorrectQuantity
+        return result;
+    }
+
     return result;
 }
 
@@ -122,6 +141,42 @@ MessageValidator::ValidationResult MessageValidator::validateModify(
     return result;
 }
 
+MessageValidator::ValidationResult MessageValidator::validateMassAction(
+    uint8_t scope, SecurityId security_id, uint8_t side) const {
+
+    ValidationResult result;
+
+    // Instrument scope cancels one instrument; market segment and
+    // instrument group scopes are taken as every instrument the session
+    // trades, as the simulator has one segment and no group partitioning
+    if (scope != sbe::OrderMassActionRequest529::SCOPE_INSTRUMENT &&
+        scope != sbe::OrderMassActionRequest529::SCOPE_MARKET_SEGMENT &&
+        scope != sbe::OrderMassActionRequest529::SCOPE_INSTRUMENT_GROUP) {
+        result.valid = false;
+        result.reason = "Unsupported mass action scope";
+        result.reject_reason = 0;  // Mass action not supported
+        return result;
+    }
+
+    if (scope == sbe::OrderMassActionRequest529::SCOPE_INSTRUMENT &&
+        !isValidInstrument(security_id)) {
+        result.valid = false;
+        result.reason = "Unknown instrument";
+        result.reject_reason = 1;  // Invalid or unknown security
+        return result;
+    }
+
+    if (side != 0 && side != static_cast<uint8_t>(Side::Buy) &&
+        side != static_cast<uint8_t>(Side::Sell)) {
+        result.valid = false;
+        result.reason = "Invalid side";
+        result.reject_reason = 99;  // Other
+        return result;
+    }
+
+    return result;
+}
+
 bool MessageValidator::isValidInstrument(SecurityId id) const {
     return instrument_mgr_.findBySecurityId(id) != nullptr;
 }
@@ -21,6 +21,9 @@ public:
     ValidationResult validateCancel(OrderId order_id, SecurityId security_id) const;
     ValidationResult validateModify(OrderId order_id, SecurityId security_id,
                                     Price new_price, Quantity new_qty) const;
+    // reject_reason is a MassActionRejectReason
+    ValidationResult validateMassAction(uint8_t scope, SecurityId security_id,
+                                        uint8_t side) const;
 
 private:
     const InstrumentManager& instrument_mgr_;
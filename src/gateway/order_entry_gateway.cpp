@@ -2,25 +2,176 @@
 #include "../sbe/ilink3_messages.h"
 #include "../sbe/framing.h"
 #include "../sbe/message_header.h"
+#include "../common/clock.h"
+#include "../common/idle_strategy.h"
+#include "../common/io_thread.h"
+#include <algorithm>
 #include <cstring>
+#include <thread>
 
 namespace cme::sim::gateway {
 
+namespace {
+
+// New orders and mass actions failing validation/risk on the IO thread are
+// marked rejected and answered on the engine thread without reaching the
+// engine
+bool isPreRejected(const OrderCommand& cmd) {
+    if (cmd.type == OrderCommand::Type::MassCancel) {
+        return cmd.mass_action && cmd.mass_action->reject_reason.has_value();
+    }
+    if (cmd.risk_reject != RejectReason::None) return true;
+    return cmd.type == OrderCommand::Type::NewOrder &&
+           cmd.order.status == OrdStatus::Rejected;
+}
+
+// OrdRejReason / CxlRejReason codes the gateway sends itself
+constexpr uint16_t REJECT_EXCEEDS_LIMIT = 3;
+constexpr uint16_t REJECT_OTHER = 99;
+// MassActionRejectReason
+constexpr uint8_t MASS_ACTION_REJECT_OTHER = 99;
+
+// Wire reject codes for the engine-side risk checks
+uint16_t riskRejectCode(RejectReason reason) {
+    return reason == RejectReason::PositionLimit ? REJECT_EXCEEDS_LIMIT : REJECT_OTHER;
+}
+
+uint32_t countCancelled(std::span<const EngineEvent> events) {
+    uint32_t count = 0;
+    for (const auto& event : events) {
+        if (std::holds_alternative<OrderCancelled>(event)) ++count;
+    }
+    return count;
+}
+
+} // anonymous namespace
+
 OrderEntryGateway::OrderEntryGateway(InstrumentManager& instrument_mgr,
-                                     const config::RiskConfig& risk_config)
+                                     const config::RiskConfig& risk_config,
+                                     const config::EngineConfig& engine_config)
     : instrument_mgr_(instrument_mgr)
     , validator_(instrument_mgr)
-    , risk_manager_(risk_config) {}
+    , risk_manager_(risk_config)
+    , queue_capacity_(static_cast<std::size_t>(engine_config.command_queue_capacity))
+    , spin_when_full_(engine_config.queue_full_policy == "spin") {
+    shards_.push_back(makeShard());
+}
+
+void OrderEntryGateway::configureShards(
+    std::size_t count, std::unordered_map<SecurityId, std::size_t> shard_by_security) {
+    shards_.clear();
+    for (std::size_t i = 0; i < std::max<std::size_t>(count, 1); ++i) {
+        shards_.push_back(makeShard());
+    }
+    shard_by_security_ = std::move(shard_by_security);
+}
+
+void OrderEntryGateway::configureIoLanes(std::size_t io_threads) {
+    io_lanes_ = io_threads;
+    for (auto& shard : shards_) shard = makeShard();
+}
+
+std::unique_ptr<OrderEntryGateway::Shard> OrderEntryGateway::makeShard() const {
+    auto shard = std::make_unique<Shard>(queue_capacity_, risk_manager_.config(), instrument_mgr_);
+    for (std::size_t i = 0; i < io_lanes_; ++i) {
+        shard->lanes.push_back(std::make_unique<SPSCQueue<OrderCommand>>(queue_capacity_));
+    }
+    shard->lane_counts.assign(io_lanes_ + 1, 0);
+    return shard;
+}
+
+void OrderEntryGateway::attachJournal(std::size_t shard, journal::JournalWriter* writer) {
+    shards_.at(shard)->journal = writer;
+}
+
+void OrderEntryGateway::attachLiquidity(std::size_t shard, LiquidityProvider* provider) {
+    shards_.at(shard)->liquidity = provider;
+}
+
+void OrderEntryGateway::restoreRisk(std::size_t shard, const EngineSnapshot& snapshot,
+                                    std::span<const checkpoint::Position> positions) {
+    shards_.at(shard)->risk.restore(snapshot, positions);
+}
+
+void OrderEntryGateway::enableLatency(std::size_t shard) {
+    auto& latency = shards_.at(shard)->latency;
+    if (!latency) latency = std::make_unique<LatencyRecorder>();
+}
+
+OrderEntryGateway::Shard& OrderEntryGateway::shardFor(SecurityId security_id) {
+    auto it = shard_by_security_.find(security_id);
+    if (it == shard_by_security_.end() || it->second >= shards_.size()) {
+        return *shards_.front();
+    }
+    return *shards_[it->second];
+}
+
+bool OrderEntryGateway::tryPush(Shard& shard, OrderCommand&& cmd) {
+    int io = ioThreadIndex();
+    if (io >= 0 && static_cast<std::size_t>(io) < shard.lanes.size()) {
+        return shard.lanes[io]->tryPush(std::move(cmd));
+    }
+    return shard.command_queue.tryPush(std::move(cmd));
+}
+
+void OrderEntryGateway::push(Shard& shard, OrderCommand&& cmd) {
+    for (uint32_t spins = 0; !tryPush(shard, std::move(cmd)); ++spins) {
+        // Nobody will drain the ring again
+        if (stopping_.load(std::memory_order_relaxed)) return;
+        if (spins < 64) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void OrderEntryGateway::enqueue(Shard& shard, OrderCommand&& cmd) {
+    cmd.enqueued_ticks = Clock::ticks();
+    if (tryPush(shard, std::move(cmd))) return;
+    if (spin_when_full_) {
+        push(shard, std::move(cmd));
+        return;
+    }
+    throttle(cmd);
+}
+
+void OrderEntryGateway::throttle(const OrderCommand& cmd) {
+    throttled_.fetch_add(1, std::memory_order_relaxed);
+    if (!throttle_handler_) return;
+    OrderResponse resp;
+    resp.session_uuid = cmd.session_uuid;
+    if (cmd.type == OrderCommand::Type::NewOrder) {
+        resp.sbe_message = buildPreEngineReject(cmd.session_uuid, cmd.order.cl_ord_id,
+                                                cmd.security_id, REJECT_EXCEEDS_LIMIT,
+                                                RejectReason::Throttled).sbe_message;
+    } else if (cmd.type == OrderCommand::Type::MassCancel) {
+        const MassAction& action = *cmd.mass_action;
+        resp.sbe_message = exec_builder_.buildOrderMassActionReport(
+            cmd.session_uuid, action.order_request_id, action.security_id,
+            action.scope, action.side, 0, MASS_ACTION_REJECT_OTHER);
+    } else {
+        OrderCancelRejected reject{cmd.order_id, cmd.cl_ord_id, cmd.session_uuid,
+                                   REJECT_OTHER, RejectReason::Throttled};
+        resp.sbe_message = exec_builder_.buildOrderCancelReject(reject, cmd.session_uuid);
+    }
+    throttle_handler_(std::move(resp));
+}
 
 void OrderEntryGateway::onApplicationMessage(uint64_t session_uuid,
                                               uint16_t templateId,
-                                              const char* data, size_t len) {
+                                              const char* data, size_t len,
+                                              TokenBucket& rate_limit) {
+    // Each request is bounds-checked once when its view is wrapped; a
+    // truncated message carries nothing we could safely act on
     switch (templateId) {
         case sbe::NewOrderSingle514::TEMPLATE_ID: {
-            auto cmd = decodeNewOrderSingle(session_uuid, data, len);
+            sbe::NewOrderSingle514View msg;
+            if (!msg.wrap(data, len)) break;
+            auto cmd = decodeNewOrderSingle(session_uuid, msg);
 
             // Validate the order
-            auto val_result = validator_.validateNewOrder(*cmd.order);
+            auto val_result = validator_.validateNewOrder(cmd.order);
             if (!val_result.valid) {
                 // We cannot enqueue a reject command here since we're on an IO
                 // thread -- but we still need to notify the caller. For now we
@@ -31,48 +182,71 @@ void OrderEntryGateway::onApplicationMessage(uint64_t session_uuid,
                 //
                 // To keep things simple and thread-safe, we still enqueue and
                 // let the engine thread handle rejection.
-                cmd.order->status = OrdStatus::Rejected;
+                cmd.order.status = OrdStatus::Rejected;
             }
 
             // Rate check
-            auto rate_result = risk_manager_.checkRate(session_uuid);
+            auto rate_result = risk_manager_.checkRate(rate_limit);
             if (!rate_result.passed) {
-                cmd.order->status = OrdStatus::Rejected;
+                cmd.order.status = OrdStatus::Rejected;
             }
 
             // Risk check
-            auto risk_result = risk_manager_.checkOrder(*cmd.order);
+            auto risk_result = risk_manager_.checkOrder(cmd.order);
             if (!risk_result.passed) {
-                cmd.order->status = OrdStatus::Rejected;
+                cmd.order.status = OrdStatus::Rejected;
             }
 
-            command_queue_.push(std::move(cmd));
+            enqueue(shardFor(cmd.security_id), std::move(cmd));
             break;
         }
 
         case sbe::OrderCancelRequest516::TEMPLATE_ID: {
-            auto cmd = decodeCancelRequest(session_uuid, data, len);
+            sbe::OrderCancelRequest516View msg;
+            if (!msg.wrap(data, len)) break;
+            auto cmd = decodeCancelRequest(session_uuid, msg);
 
-            auto val_result = validator_.validateCancel(cmd.cancel_order_id, cmd.security_id);
+            auto val_result = validator_.validateCancel(cmd.order_id, cmd.security_id);
             if (!val_result.valid) {
                 // Still enqueue; processCommands will generate cancel reject
                 cmd.type = OrderCommand::Type::CancelOrder;
             }
 
-            command_queue_.push(std::move(cmd));
+            enqueue(shardFor(cmd.security_id), std::move(cmd));
             break;
         }
 
         case sbe::OrderCancelReplaceRequest515::TEMPLATE_ID: {
-            auto cmd = decodeModifyRequest(session_uuid, data, len);
+            sbe::OrderCancelReplaceRequest515View msg;
+            if (!msg.wrap(data, len)) break;
+            auto cmd = decodeModifyRequest(session_uuid, msg);
 
             auto val_result = validator_.validateModify(
-                cmd.cancel_order_id, cmd.security_id, cmd.new_price, cmd.new_qty);
+                cmd.order_id, cmd.security_id, cmd.new_price, cmd.new_qty);
             if (!val_result.valid) {
                 // Still enqueue; processCommands will handle
             }
 
-            command_queue_.push(std::move(cmd));
+            enqueue(shardFor(cmd.security_id), std::move(cmd));
+            break;
+        }
+
+        case sbe::OrderMassActionRequest529::TEMPLATE_ID: {
+            sbe::OrderMassActionRequest529View msg;
+            if (!msg.wrap(data, len)) break;
+            auto cmd = decodeMassActionRequest(session_uuid, msg);
+
+            MassAction& action = *cmd.mass_action;
+            auto val_result = validator_.validateMassAction(
+                action.scope, action.security_id, action.side);
+            if (!val_result.valid) {
+                // Answered by shard 0's engine thread
+                action.reject_reason = static_cast<uint8_t>(val_result.reject_reason);
+                enqueue(shardFor(0), std::move(cmd));
+                break;
+            }
+
+            enqueueMassCancel(std::move(cmd));
             break;
         }
 
@@ -82,191 +256,242 @@ void OrderEntryGateway::onApplicationMessage(uint64_t session_uuid,
     }
 }
 
-std::vector<OrderResponse> OrderEntryGateway::processCommands(
-    IMatchingEngine& engine, std::vector<EngineEvent>* engine_events) {
-    std::vector<OrderResponse> responses;
-
-    while (auto cmd_opt = command_queue_.tryPop()) {
-        auto& cmd = *cmd_opt;
+void OrderEntryGateway::onSessionDisconnected(uint64_t session_uuid) {
+    OrderCommand cmd;
+    cmd.type = OrderCommand::Type::MassCancel;
+    cmd.session_uuid = session_uuid;
+    enqueueMassCancel(std::move(cmd));
+}
 
-        switch (cmd.type) {
-            case OrderCommand::Type::NewOrder: {
-                // If pre-rejected during validation (on IO thread)
-                if (cmd.order->status == OrdStatus::Rejected) {
-                    OrderRejected reject_event;
-                    reject_event.cl_ord_id = cmd.order->cl_ord_id;
-                    reject_event.session_uuid = cmd.session_uuid;
-                    reject_event.reason = "Pre-trade risk check failed";
-                    reject_event.reject_reason_code = 3; // Other
+void OrderEntryGateway::enqueueMassCancel(OrderCommand cmd) {
+    // Mass cancels take risk off, so they wait for room rather than bounce
+    cmd.enqueued_ticks = Clock::ticks();
+    if (cmd.security_id != 0) {
+        push(shardFor(cmd.security_id), std::move(cmd));
+        return;
+    }
+    if (cmd.mass_action) cmd.mass_action->shards_left.store(shards_.size());
+    for (auto& shard : shards_) {
+        OrderCommand copy = cmd;
+        push(*shard, std::move(copy));
+    }
+}
 
-                    OrderResponse resp;
-                    resp.session_uuid = cmd.session_uuid;
-                    resp.sbe_message = exec_builder_.buildExecutionReportReject(
-                        reject_event, cmd.session_uuid);
-                    responses.push_back(std::move(resp));
-                    break;
-                }
+std::vector<OrderResponse> OrderEntryGateway::processCommands(
+    IMatchingEngine& engine, EventSink* engine_events, std::size_t shard) {
+    std::vector<OrderResponse> responses;
+    Shard& own = *shards_.at(shard);
+
+    // Drain the IO lanes round-robin, starting one lane further each pass
+    // and taking at most LANE_QUOTA from each, then the shared ring (at most
+    // one ring's worth, so producers outpacing the engine cannot keep a
+    // batch growing). New orders and modifies go through the shard's risk
+    // checks as they are drained; commands rejected there or on the IO
+    // thread never reach the engine.
+    own.pending.clear();
+    own.batch.clear();
+    LatencyRecorder* latency = own.latency.get();
+    auto take = [&](OrderCommand&& popped) {
+        if (latency) {
+            latency->record(LatencyStage::QueueWait, popped,
+                            Clock::ticks() - popped.enqueued_ticks);
+        }
+        own.pending.push_back(std::move(popped));
+        OrderCommand& cmd = own.pending.back();
+        if (isPreRejected(cmd)) return;
+        if (cmd.type == OrderCommand::Type::NewOrder) {
+            cmd.risk_reject = own.risk.checkNewOrder(cmd.order);
+        } else if (cmd.type == OrderCommand::Type::ModifyOrder) {
+            cmd.risk_reject = own.risk.checkModify(cmd.session_uuid, cmd.order_id,
+                                                   cmd.new_price, cmd.new_qty,
+                                                   cmd.risk_hold);
+        }
+        if (!isPreRejected(cmd)) own.batch.push_back(cmd);
+    };
+    const std::size_t lanes = own.lanes.size();
+    for (std::size_t k = 0; k < lanes; ++k) {
+        std::size_t lane = (own.next_lane + k) % lanes;
+        own.lane_counts[lane] += own.lanes[lane]->drain(take, LANE_QUOTA);
+    }
+    if (lanes > 0) own.next_lane = (own.next_lane + 1) % lanes;
+    own.lane_counts[lanes] += own.command_queue.drain(take, own.command_queue.capacity());
+    // Requotes of the built-in liquidity provider ride in the same batch
+    if (own.liquidity) {
+        own.quotes.clear();
+        own.liquidity->poll(Clock::epochNanos(), own.quotes);
+        for (const EngineCommand& quote : own.quotes) {
+            OrderCommand cmd;
+            static_cast<EngineCommand&>(cmd) = quote;
+            own.pending.push_back(std::move(cmd));
+            own.batch.push_back(quote);
+        }
+    }
+    if (own.pending.empty()) return responses;
+
+    // The engine appends straight into the caller's sink, or into a scratch
+    // sink that keeps its capacity between batches.
+    EventSink& sink = engine_events ? *engine_events : own.scratch_events;
+    if (!engine_events) own.scratch_events.clear();
+    if (!own.batch.empty()) {
+        // One engine-thread timestamp per batch; the journal records it so
+        // a replay stamps the same
+        Timestamp now = Clock::epochNanos();
+        for (EngineCommand& cmd : own.batch) {
+            if (cmd.type == EngineCommand::Type::NewOrder) cmd.order.timestamp = now;
+        }
+        engine.processBatch(own.batch, sink, own.ranges);
+        if (own.journal) own.journal->appendBatch(own.batch, sink, own.ranges);
+    }
 
-                auto events = engine.submitOrder(std::move(cmd.order));
-                if (engine_events) {
-                    engine_events->insert(engine_events->end(), events.begin(), events.end());
-                }
-                for (const auto& event : events) {
-                    // Determine which session(s) to route to
-                    std::visit([&](const auto& e) {
-                        using T = std::decay_t<decltype(e)>;
-                        if constexpr (std::is_same_v<T, OrderAccepted>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportNew(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderRejected>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportReject(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderFilled>) {
-                            // Send fill to maker
-                            {
-                                OrderResponse resp;
-                                resp.session_uuid = e.maker_session_uuid;
-                                resp.sbe_message = exec_builder_.buildExecutionReportFill(
-                                    e, e.maker_session_uuid, true);
-                                responses.push_back(std::move(resp));
-                            }
-                            // Send fill to taker
-                            {
-                                OrderResponse resp;
-                                resp.session_uuid = e.taker_session_uuid;
-                                resp.sbe_message = exec_builder_.buildExecutionReportFill(
-                                    e, e.taker_session_uuid, false);
-                                responses.push_back(std::move(resp));
-                            }
-                            // Update risk manager positions
-                            risk_manager_.onFill(e.maker_session_uuid, e.security_id,
-                                (e.aggressor_side == Side::Buy) ? Side::Sell : Side::Buy,
-                                e.trade_qty);
-                            risk_manager_.onFill(e.taker_session_uuid, e.security_id,
-                                e.aggressor_side, e.trade_qty);
-                        } else if constexpr (std::is_same_v<T, OrderCancelled>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportCancel(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderModified>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportModify(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderCancelRejected>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildOrderCancelReject(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, BookUpdate>) {
-                            // BookUpdate is for market data, not order entry responses
-                        }
-                    }, event);
-                }
-                break;
+    std::size_t next = 0;
+    for (const OrderCommand& cmd : own.pending) {
+        if (isPreRejected(cmd) && cmd.type == OrderCommand::Type::MassCancel) {
+            const MassAction& action = *cmd.mass_action;
+            OrderResponse resp;
+            resp.session_uuid = cmd.session_uuid;
+            resp.sbe_message = exec_builder_.buildOrderMassActionReport(
+                cmd.session_uuid, action.order_request_id, action.security_id,
+                action.scope, action.side, 0, action.reject_reason);
+            responses.push_back(std::move(resp));
+            continue;
+        }
+        if (isPreRejected(cmd) && cmd.type == OrderCommand::Type::ModifyOrder) {
+            OrderCancelRejected reject{cmd.order_id, cmd.cl_ord_id, cmd.session_uuid,
+                                       riskRejectCode(cmd.risk_reject), cmd.risk_reject};
+            OrderResponse resp;
+            resp.session_uuid = cmd.session_uuid;
+            resp.sbe_message = exec_builder_.buildOrderCancelReject(reject, cmd.session_uuid);
+            responses.push_back(std::move(resp));
+            continue;
+        }
+        if (isPreRejected(cmd)) {
+            OrderRejected reject_event;
+            reject_event.cl_ord_id = cmd.order.cl_ord_id;
+            reject_event.session_uuid = cmd.session_uuid;
+            if (cmd.risk_reject != RejectReason::None) {
+                reject_event.reason = cmd.risk_reject;
+                reject_event.reject_reason_code = riskRejectCode(cmd.risk_reject);
+            } else {
+                reject_event.reason = RejectReason::PreTradeRisk;
+                reject_event.reject_reason_code = REJECT_OTHER;
             }
 
-            case OrderCommand::Type::CancelOrder: {
-                auto events = engine.cancelOrder(
-                    cmd.cancel_order_id, cmd.security_id, cmd.session_uuid);
-                if (engine_events) {
-                    engine_events->insert(engine_events->end(), events.begin(), events.end());
-                }
-                for (const auto& event : events) {
-                    std::visit([&](const auto& e) {
-                        using T = std::decay_t<decltype(e)>;
-                        if constexpr (std::is_same_v<T, OrderCancelled>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportCancel(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderCancelRejected>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildOrderCancelReject(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, BookUpdate>) {
-                            // Market data event, skip
-                        } else {
-                            // Unexpected event type for cancel
-                        }
-                    }, event);
-                }
-                break;
+            OrderResponse resp;
+            resp.session_uuid = cmd.session_uuid;
+            resp.sbe_message = exec_builder_.buildExecutionReportReject(
+                reject_event, cmd.session_uuid);
+            responses.push_back(std::move(resp));
+            continue;
+        }
+        const EventRange& range = own.ranges[next++];
+        auto events = sink.range(range.first, range.count);
+        // The hold on a new order's (or a modify's added) quantity gives
+        // way to what the engine did with it
+        if (cmd.type == OrderCommand::Type::NewOrder) own.risk.releaseNewOrder(cmd.order);
+        if (cmd.type == OrderCommand::Type::ModifyOrder) own.risk.releaseModify(cmd.risk_hold);
+        own.risk.apply(events);
+        // The liquidity provider's own quotes are not client latency
+        bool timed = latency && cmd.session_uuid != LiquidityProvider::SESSION_UUID;
+        uint64_t encode_start = timed ? Clock::ticks() : 0;
+        routeEvents(events, responses);
+
+        // The exec reports of the cancelled orders go out first, then the
+        // mass action report once every shard has run the request
+        if (cmd.type == OrderCommand::Type::MassCancel && cmd.mass_action) {
+            MassAction& action = *cmd.mass_action;
+            action.affected.fetch_add(countCancelled(events));
+            if (action.shards_left.fetch_sub(1) == 1) {
+                OrderResponse resp;
+                resp.session_uuid = cmd.session_uuid;
+                resp.sbe_message = exec_builder_.buildOrderMassActionReport(
+                    cmd.session_uuid, action.order_request_id, action.security_id,
+                    action.scope, action.side, action.affected.load());
+                responses.push_back(std::move(resp));
             }
+        }
+        if (timed) {
+            latency->record(LatencyStage::Match, cmd, range.ticks);
+            latency->record(LatencyStage::Encode, cmd, Clock::ticks() - encode_start);
+        }
+    }
+
+    return responses;
+}
 
-            case OrderCommand::Type::ModifyOrder: {
-                auto events = engine.modifyOrder(
-                    cmd.cancel_order_id, cmd.security_id,
-                    cmd.new_price, cmd.new_qty, cmd.new_cl_ord_id);
-                if (engine_events) {
-                    engine_events->insert(engine_events->end(), events.begin(), events.end());
+void OrderEntryGateway::routeEvents(std::span<const EngineEvent> events,
+                                    std::vector<OrderResponse>& responses) {
+    // The liquidity provider's own orders get no exec reports
+    auto reported = [](uint64_t session_uuid) {
+        return session_uuid != LiquidityProvider::SESSION_UUID;
+    };
+    for (const auto& event : events) {
+        std::visit([&](const auto& e) {
+            using T = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<T, OrderFilled>) {
+                if (reported(e.maker_session_uuid)) {
+                    OrderResponse resp;
+                    resp.session_uuid = e.maker_session_uuid;
+                    resp.sbe_message = exec_builder_.buildExecutionReportFill(
+                        e, e.maker_session_uuid, true);
+                    responses.push_back(std::move(resp));
                 }
-                for (const auto& event : events) {
-                    std::visit([&](const auto& e) {
-                        using T = std::decay_t<decltype(e)>;
-                        if constexpr (std::is_same_v<T, OrderModified>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildExecutionReportModify(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderCancelRejected>) {
-                            OrderResponse resp;
-                            resp.session_uuid = e.session_uuid;
-                            resp.sbe_message = exec_builder_.buildOrderCancelReject(
-                                e, e.session_uuid);
-                            responses.push_back(std::move(resp));
-                        } else if constexpr (std::is_same_v<T, OrderFilled>) {
-                            // Modify can trigger fills
-                            {
-                                OrderResponse resp;
-                                resp.session_uuid = e.maker_session_uuid;
-                                resp.sbe_message = exec_builder_.buildExecutionReportFill(
-                                    e, e.maker_session_uuid, true);
-                                responses.push_back(std::move(resp));
-                            }
-                            {
-                                OrderResponse resp;
-                                resp.session_uuid = e.taker_session_uuid;
-                                resp.sbe_message = exec_builder_.buildExecutionReportFill(
-                                    e, e.taker_session_uuid, false);
-                                responses.push_back(std::move(resp));
-                            }
-                            risk_manager_.onFill(e.maker_session_uuid, e.security_id,
-                                (e.aggressor_side == Side::Buy) ? Side::Sell : Side::Buy,
-                                e.trade_qty);
-                            risk_manager_.onFill(e.taker_session_uuid, e.security_id,
-                                e.aggressor_side, e.trade_qty);
-                        } else if constexpr (std::is_same_v<T, BookUpdate>) {
-                            // Market data event, skip
-                        } else {
-                            // Other events not expected for modify
-                        }
-                    }, event);
+                if (reported(e.taker_session_uuid)) {
+                    OrderResponse resp;
+                    resp.session_uuid = e.taker_session_uuid;
+                    resp.sbe_message = exec_builder_.buildExecutionReportFill(
+                        e, e.taker_session_uuid, false);
+                    responses.push_back(std::move(resp));
                 }
-                break;
+            } else if constexpr (std::is_same_v<T, BookUpdate> || std::is_same_v<T, OrderTriggered>) {
+                // BookUpdate is for market data, not order entry responses.
+                // Stop election has no exec report of its own; the owner
+                // sees the fills/cancel that follow.
+            } else if (!reported(e.session_uuid)) {
+                return;
+            } else if constexpr (std::is_same_v<T, OrderAccepted>) {
+                OrderResponse resp;
+                resp.session_uuid = e.session_uuid;
+                resp.sbe_message = exec_builder_.buildExecutionReportNew(
+                    e, e.session_uuid);
+                responses.push_back(std::move(resp));
+            } else if constexpr (std::is_same_v<T, OrderRejected>) {
+                OrderResponse resp;
+                resp.session_uuid = e.session_uuid;
+                resp.sbe_message = exec_builder_.buildExecutionReportReject(
+                    e, e.session_uuid);
+                responses.push_back(std::move(resp));
+            } else if constexpr (std::is_same_v<T, OrderCancelled>) {
+                // Cancel requests, IOC/FOK remainders, SMP and elected stops
+                OrderResponse resp;
+                resp.session_uuid = e.session_uuid;
+                resp.sbe_message = exec_builder_.buildExecutionReportCancel(
+                    e, e.session_uuid);
+                responses.push_back(std::move(resp));
+            } else if constexpr (std::is_same_v<T, OrderModified>) {
+                OrderResponse resp;
+                resp.session_uuid = e.session_uuid;
+                resp.sbe_message = exec_builder_.buildExecutionReportModify(
+                    e, e.session_uuid);
+                responses.push_back(std::move(resp));
+            } else if constexpr (std::is_same_v<T, OrderCancelRejected>) {
+                OrderResponse resp;
+                resp.session_uuid = e.session_uuid;
+                resp.sbe_message = exec_builder_.buildOrderCancelReject(
+                    e, e.session_uuid);
+                responses.push_back(std::move(resp));
             }
-        }
+        }, event);
     }
-
-    return responses;
 }
 
 bool OrderEntryGateway::hasPendingCommands() const {
-    return !command_queue_.empty();
+    for (const auto& shard : shards_) {
+        if (!shard->command_queue.empty()) return true;
+        for (const auto& lane : shard->lanes) {
+            if (!lane->empty()) return true;
+        }
+    }
+    return false;
 }
 
 OrderResponse OrderEntryGateway::buildResponse(const EngineEvent& event,
@@ -278,77 +503,86 @@ OrderResponse OrderEntryGateway::buildResponse(const EngineEvent& event,
 }
 
 OrderCommand OrderEntryGateway::decodeNewOrderSingle(uint64_t session_uuid,
-                                                      const char* data, size_t len) {
+                                                      const sbe::NewOrderSingle514View& msg) {
     OrderCommand cmd;
     cmd.type = OrderCommand::Type::NewOrder;
     cmd.session_uuid = session_uuid;
 
-    sbe::NewOrderSingle514 sbe_msg;
-    sbe_msg.decode(data, 0);
-
-    auto order = std::make_unique<Order>();
-    order->session_uuid = session_uuid;
-    order->security_id = sbe_msg.securityID;
-    order->side = static_cast<Side>(sbe_msg.side);
-    order->order_type = static_cast<OrderType>(sbe_msg.ordType);
-    order->time_in_force = static_cast<TimeInForce>(sbe_msg.timeInForce);
-    order->price = Price{sbe_msg.price};
-    order->stop_price = Price{sbe_msg.stopPx};
-    order->quantity = static_cast<Quantity>(sbe_msg.orderQty);
-    order->display_qty = static_cast<Quantity>(sbe_msg.displayQty);
-    order->min_qty = static_cast<Quantity>(sbe_msg.minQty);
-    order->order_request_id = sbe_msg.orderRequestID;
+    Order& order = cmd.order;
+    order.session_uuid = session_uuid;
+    // SMP groups orders by session. UUIDs are handed out sequentially from
+    // 1, so the low 32 bits are a compact, non-zero tag per session.
+    order.smp_id = static_cast<uint32_t>(session_uuid);
+    order.security_id = msg.securityID();
+    order.side = static_cast<Side>(msg.side());
+    order.order_type = static_cast<OrderType>(msg.ordType());
+    order.time_in_force = static_cast<TimeInForce>(msg.timeInForce());
+    order.price = Price{msg.price()};
+    order.stop_price = Price{msg.stopPx()};
+    order.quantity = static_cast<Quantity>(msg.orderQty());
+    order.display_qty = static_cast<Quantity>(msg.displayQty());
+    order.min_qty = static_cast<Quantity>(msg.minQty());
+    order.order_request_id = msg.orderRequestID();
 
     // Read ClOrdID from fixed-size field
-    char clOrdBuf[21]{};
-    sbe::readFixedString(clOrdBuf, sbe_msg.clOrdID, 20);
-    order->cl_ord_id = clOrdBuf;
+    sbe::readFixedString(order.cl_ord_id, msg.clOrdID(), 20);
 
-    cmd.order = std::move(order);
-    cmd.security_id = sbe_msg.securityID;
+    cmd.security_id = order.security_id;
 
     return cmd;
 }
 
 OrderCommand OrderEntryGateway::decodeCancelRequest(uint64_t session_uuid,
-                                                     const char* data, size_t len) {
+                                                     const sbe::OrderCancelRequest516View& msg) {
     OrderCommand cmd;
     cmd.type = OrderCommand::Type::CancelOrder;
     cmd.session_uuid = session_uuid;
 
-    sbe::OrderCancelRequest516 sbe_msg;
-    sbe_msg.decode(data, 0);
+    cmd.order_id = msg.orderID();
+    cmd.security_id = msg.securityID();
+    cmd.order_request_id = msg.orderRequestID();
 
-    cmd.cancel_order_id = sbe_msg.orderID;
-    cmd.security_id = sbe_msg.securityID;
-    cmd.order_request_id = sbe_msg.orderRequestID;
-
-    char clOrdBuf[21]{};
-    sbe::readFixedString(clOrdBuf, sbe_msg.clOrdID, 20);
-    cmd.cl_ord_id = clOrdBuf;
+    sbe::readFixedString(cmd.cl_ord_id, msg.clOrdID(), 20);
 
     return cmd;
 }
 
-OrderCommand OrderEntryGateway::decodeModifyRequest(uint64_t session_uuid,
-                                                     const char* data, size_t len) {
+OrderCommand OrderEntryGateway::decodeModifyRequest(
+    uint64_t session_uuid, const sbe::OrderCancelReplaceRequest515View& msg) {
     OrderCommand cmd;
     cmd.type = OrderCommand::Type::ModifyOrder;
     cmd.session_uuid = session_uuid;
 
-    sbe::OrderCancelReplaceRequest515 sbe_msg;
-    sbe_msg.decode(data, 0);
+    cmd.order_id = msg.orderID();
+    cmd.security_id = msg.securityID();
+    cmd.new_price = Price{msg.price()};
+    cmd.new_qty = static_cast<Quantity>(msg.orderQty());
+    cmd.order_request_id = msg.orderRequestID();
+
+    sbe::readFixedString(cmd.cl_ord_id, msg.clOrdID(), 20);
+    cmd.new_cl_ord_id = cmd.cl_ord_id;
 
-    cmd.cancel_order_id = sbe_msg.orderID;
-    cmd.security_id = sbe_msg.securityID;
-    cmd.new_price = Price{sbe_msg.price};
-    cmd.new_qty = static_cast<Quantity>(sbe_msg.orderQty);
-    cmd.order_request_id = sbe_msg.orderRequestID;
+    return cmd;
+}
+
+OrderCommand OrderEntryGateway::decodeMassActionRequest(
+    uint64_t session_uuid, const sbe::OrderMassActionRequest529View& msg) {
+    OrderCommand cmd;
+    cmd.type = OrderCommand::Type::MassCancel;
+    cmd.session_uuid = session_uuid;
+
+    auto action = std::make_shared<MassAction>();
+    action->order_request_id = msg.orderRequestID();
+    action->scope = msg.massActionScope();
+    action->side = msg.side();
+    if (action->scope == sbe::OrderMassActionRequest529::SCOPE_INSTRUMENT) {
+        action->security_id = msg.securityID();
+    }
 
-    char clOrdBuf[21]{};
-    sbe::readFixedString(clOrdBuf, sbe_msg.clOrdID, 20);
-    cmd.cl_ord_id = clOrdBuf;
-    cmd.new_cl_ord_id = clOrdBuf;
+    cmd.order_request_id = action->order_request_id;
+    cmd.security_id = action->security_id;
+    if (action->side != 0) cmd.mass_side = static_cast<Side>(action->side);
+    cmd.mass_action = std::move(action);
 
     return cmd;
 }
@@ -357,7 +591,7 @@ OrderResponse OrderEntryGateway::buildPreEngineReject(uint64_t session_uuid,
                                                        const ClOrdId& cl_ord_id,
                                                        SecurityId security_id,
                                                        uint16_t reject_reason,
-                                                       const std::string& reason) {
+                                                       RejectReason reason) {
     OrderRejected reject_event;
     reject_event.cl_ord_id = cl_ord_id;
     reject_event.session_uuid = session_uuid;
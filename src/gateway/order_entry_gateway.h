@@ -2,43 +2,53 @@
 
 #include "../common/types.h"
 #include "../common/mpsc_queue.h"
+#include "../common/spsc_queue.h"
 #include "../engine/matching_engine.h"
 #include "../engine/order.h"
 #include "../engine/engine_event.h"
+#include "../engine/liquidity_provider.h"
 #include "../instruments/instrument_manager.h"
 #include "../config/exchange_config.h"
+#include "../journal/journal_writer.h"
+#include "../sbe/ilink3_messages.h"
 #include "message_validator.h"
 #include "risk_manager.h"
+#include "risk_stage.h"
 #include "exec_report_builder.h"
+#include "latency_recorder.h"
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <functional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace cme::sim::gateway {
 
-struct OrderCommand {
-    enum class Type { NewOrder, CancelOrder, ModifyOrder };
-    Type type = Type::NewOrder;
-    uint64_t session_uuid = 0;
-
-    // NewOrder fields
-    std::unique_ptr<Order> order;
-
-    // Cancel fields
-    OrderId cancel_order_id = 0;
-    SecurityId security_id = 0;
-    ClOrdId cl_ord_id;
+// An OrderMassActionRequest in flight. An all-instrument mass cancel runs
+// on every engine shard; the last shard to finish sends the report.
+struct MassAction {
     uint64_t order_request_id = 0;
+    SecurityId security_id = 0;
+    uint8_t scope = 0;
+    uint8_t side = 0;
+    std::optional<uint8_t> reject_reason;  // set if rejected on decode
+    std::atomic<std::size_t> shards_left{1};
+    std::atomic<uint32_t> affected{0};
+};
 
-    // Modify fields
-    Price new_price;
-    Quantity new_qty = 0;
-    ClOrdId new_cl_ord_id;
-
-    // Move-only due to unique_ptr
-    OrderCommand() = default;
-    OrderCommand(OrderCommand&&) = default;
-    OrderCommand& operator=(OrderCommand&&) = default;
+// A decoded order-entry message: the engine command plus the request
+// fields only the gateway needs
+struct OrderCommand : EngineCommand {
+    ClOrdId cl_ord_id;               // cancel/modify request's ClOrdID
+    uint64_t order_request_id = 0;
+    // MassCancel: the request to report on; null for cancel-on-disconnect
+    std::shared_ptr<MassAction> mass_action;
+    uint64_t enqueued_ticks = 0;     // Clock::ticks() when queued for the engine
+    RejectReason risk_reject = RejectReason::None;  // set by the shard's RiskStage
+    RiskStage::ModifyHold risk_hold;  // ModifyOrder: released once the engine ran it
 };
 
 struct OrderResponse {
@@ -48,23 +58,95 @@ struct OrderResponse {
 
 class OrderEntryGateway {
 public:
+    // `engine_config` sizes the per-shard command rings and picks what a
+    // full ring does
     OrderEntryGateway(InstrumentManager& instrument_mgr,
-                      const config::RiskConfig& risk_config);
+                      const config::RiskConfig& risk_config,
+                      const config::EngineConfig& engine_config = {});
+
+    // Where throttle rejects go when a shard's command ring is full and the
+    // policy is "reject". Called on the IO thread that submitted the
+    // command, so it must be safe against the engine threads' sends.
+    using ThrottleHandler = std::function<void(OrderResponse&&)>;
+    void setThrottleHandler(ThrottleHandler handler) { throttle_handler_ = std::move(handler); }
+    uint64_t throttledCount() const { return throttled_.load(std::memory_order_relaxed); }
 
     // Called by FIXP session when app message received (on IO thread)
-    // Decodes SBE, validates, enqueues to engine
+    // Decodes SBE, validates, enqueues to engine. `rate_limit` is the
+    // session's own bucket (see makeRateLimit()), only ever used on the
+    // session's IO thread.
     void onApplicationMessage(uint64_t session_uuid, uint16_t templateId,
-                              const char* data, size_t len);
+                              const char* data, size_t len, TokenBucket& rate_limit);
+
+    // Order-rate bucket for a new session, from the risk config
+    TokenBucket makeRateLimit() const { return risk_manager_.makeRateLimit(); }
+
+    // Split inbound commands across `count` engine shards, each with its own
+    // queue. Commands route by security ID; unknown securities go to shard 0.
+    // Must be called before any session delivers messages.
+    void configureShards(std::size_t count,
+                         std::unordered_map<SecurityId, std::size_t> shard_by_security);
+    std::size_t shardCount() const { return shards_.size(); }
+
+    // Give each of `io_threads` network IO threads its own single-producer
+    // lane into every shard, so they never contend with each other; other
+    // threads keep using the shard's shared ring. Sessions stay on one IO
+    // thread, so a session's commands stay in order. Call after
+    // configureShards(), before any session delivers messages.
+    void configureIoLanes(std::size_t io_threads);
+
+    // Commands `shard` has drained from each IO lane, then from the shared
+    // ring. Engine thread only, or after it stopped.
+    const std::vector<uint64_t>& laneCounts(std::size_t shard) const {
+        return shards_.at(shard)->lane_counts;
+    }
+
+    // Journal every batch `shard` hands its engine (null to stop). Set up
+    // before the shard's engine thread runs.
+    void attachJournal(std::size_t shard, journal::JournalWriter* writer);
+
+    // Add `provider`'s quotes to every batch `shard` runs (null to stop).
+    // No exec reports are built for the provider's own orders. Set up
+    // before the shard's engine thread runs.
+    void attachLiquidity(std::size_t shard, LiquidityProvider* provider);
+
+    // Record queue wait, match and exec-report encode latency of every
+    // client command on `shard`. The recorder belongs to the shard's engine
+    // thread; read it there, or after the thread stopped.
+    void enableLatency(std::size_t shard);
+    const LatencyRecorder* latency(std::size_t shard) const {
+        return shards_.at(shard)->latency.get();
+    }
+
+    // Seed `shard`'s engine-side risk with the open orders and last trades
+    // of its restored engine checkpoint and the checkpointed positions.
+    // Before the shard's engine thread runs.
+    void restoreRisk(std::size_t shard, const EngineSnapshot& snapshot,
+                     std::span<const checkpoint::Position> positions);
+    const RiskStage& riskStage(std::size_t shard) const { return shards_.at(shard)->risk; }
 
     // Called by engine thread to process commands
     // Returns responses to route back to sessions
     // If engine_events is non-null, all raw engine events are appended for market data
+    // In sharded mode each engine thread drains only its own shard.
+    // Everything queued is handed to the engine as one batch
+    // (IMatchingEngine::processBatch); responses follow arrival order.
     std::vector<OrderResponse> processCommands(IMatchingEngine& engine,
-                                               std::vector<EngineEvent>* engine_events = nullptr);
+                                               EventSink* engine_events = nullptr,
+                                               std::size_t shard = 0);
+
+    // Cancel every resting order of a session that has gone away, on all
+    // shards. Safe to call from any thread.
+    void onSessionDisconnected(uint64_t session_uuid);
 
-    // Check for pending commands
+    // Check for pending commands (on any shard)
     bool hasPendingCommands() const;
 
+    // The engine threads are about to stop draining: commands that find
+    // their ring full from now on are dropped instead of waited on.
+    // Call before joining the engine threads.
+    void stop() { stopping_.store(true, std::memory_order_relaxed); }
+
     // Build execution report from engine event and route to session
     OrderResponse buildResponse(const EngineEvent& event, uint64_t session_uuid);
 
@@ -74,17 +156,75 @@ private:
     RiskManager risk_manager_;
     ExecReportBuilder exec_builder_;
 
-    MPSCQueue<OrderCommand> command_queue_;
-
-    // Decode handlers
-    OrderCommand decodeNewOrderSingle(uint64_t session_uuid, const char* data, size_t len);
-    OrderCommand decodeCancelRequest(uint64_t session_uuid, const char* data, size_t len);
-    OrderCommand decodeModifyRequest(uint64_t session_uuid, const char* data, size_t len);
+    // Commands the engine takes from one lane per pass before moving on to
+    // the next, so a flooding IO thread cannot crowd out the others
+    static constexpr std::size_t LANE_QUOTA = 256;
+
+    // Inbound queues of one engine shard (a single shard unless configured):
+    // one SPSC lane per IO thread plus a shared ring for any other producer
+    struct Shard {
+        Shard(std::size_t queue_capacity, const config::RiskConfig& risk_config,
+              const InstrumentManager& instruments)
+            : command_queue(queue_capacity), risk(risk_config, instruments) {}
+
+        MPSCQueue<OrderCommand> command_queue;
+        std::vector<std::unique_ptr<SPSCQueue<OrderCommand>>> lanes;
+        // Owning engine thread only, reused across calls
+        EventSink scratch_events;
+        std::vector<OrderCommand> pending;   // drained, in arrival order
+        std::vector<EngineCommand> batch;    // the ones that go to the engine
+        std::vector<EventRange> ranges;
+        std::size_t next_lane = 0;           // where the next round-robin pass starts
+        std::vector<uint64_t> lane_counts;   // per lane, then the shared ring
+        journal::JournalWriter* journal = nullptr;
+        LiquidityProvider* liquidity = nullptr;
+        std::vector<EngineCommand> quotes;   // liquidity scratch
+        std::unique_ptr<LatencyRecorder> latency;
+        RiskStage risk;                      // position and price-band checks
+    };
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unordered_map<SecurityId, std::size_t> shard_by_security_;
+    std::size_t queue_capacity_;
+    std::size_t io_lanes_ = 0;
+    bool spin_when_full_;
+    ThrottleHandler throttle_handler_;
+    std::atomic<uint64_t> throttled_{0};
+    std::atomic<bool> stopping_{false};
+
+    Shard& shardFor(SecurityId security_id);
+    std::unique_ptr<Shard> makeShard() const;
+
+    // Producer side: the calling IO thread's lane, else the shared ring.
+    // tryPush leaves `cmd` alone when that queue is full; push waits,
+    // unless the gateway is stopping.
+    bool tryPush(Shard& shard, OrderCommand&& cmd);
+    void push(Shard& shard, OrderCommand&& cmd);
+
+    // Queue a client command, stamping enqueued_ticks; a full ring spins or
+    // throttles it per the configured policy
+    void enqueue(Shard& shard, OrderCommand&& cmd);
+    void throttle(const OrderCommand& cmd);
+
+    // Turn one command's engine events into exec reports
+    void routeEvents(std::span<const EngineEvent> events, std::vector<OrderResponse>& responses);
+
+    // Decode handlers: read the fields a command needs straight from the
+    // received buffer through an already-wrapped view
+    OrderCommand decodeNewOrderSingle(uint64_t session_uuid, const sbe::NewOrderSingle514View& msg);
+    OrderCommand decodeCancelRequest(uint64_t session_uuid, const sbe::OrderCancelRequest516View& msg);
+    OrderCommand decodeModifyRequest(uint64_t session_uuid,
+                                     const sbe::OrderCancelReplaceRequest515View& msg);
+    OrderCommand decodeMassActionRequest(uint64_t session_uuid,
+                                         const sbe::OrderMassActionRequest529View& msg);
+
+    // Queue a mass cancel on the shard owning its instrument, or on every
+    // shard when it covers all instruments
+    void enqueueMassCancel(OrderCommand cmd);
 
     // Build a reject response before submitting to engine
     OrderResponse buildPreEngineReject(uint64_t session_uuid, const ClOrdId& cl_ord_id,
                                        SecurityId security_id, uint16_t reject_reason,
-                                       const std::string& reason);
+                                       RejectReason reason);
 };
 
 } // namespace cme::sim::gateway
@@ -1,4 +1,5 @@
 #include "risk_manager.h"
+#include "../common/clock.h"
 #include <cmath>
 
 namespace cme::sim::gateway {
@@ -20,41 +21,21 @@ RiskManager::RiskResult RiskManager::checkOrder(const Order& order) const {
     return result;
 }
 
-RiskManager::RiskResult RiskManager::checkRate(uint64_t session_uuid) {
-    RiskResult result;
-    auto now = std::chrono::steady_clock::now();
-    auto& state = session_state_[session_uuid];
-
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        now - state.last_order_time);
-
-    if (elapsed.count() >= 1) {
-        // New second window
-        state.last_order_time = now;
-        state.orders_this_second = 1;
-    } else {
-        state.orders_this_second++;
-        if (state.orders_this_second > config_.max_orders_per_second) {
-            result.passed = false;
-            result.reason = "Rate limit exceeded: " +
-                            std::to_string(state.orders_this_second) +
-                            " orders/sec (max " +
-                            std::to_string(config_.max_orders_per_second) + ")";
-            return result;
-        }
-    }
-
-    return result;
+TokenBucket RiskManager::makeRateLimit() const {
+    int32_t burst = config_.max_order_burst > 0 ? config_.max_order_burst
+                                                : config_.max_orders_per_second;
+    return TokenBucket(static_cast<uint32_t>(config_.max_orders_per_second),
+                       static_cast<uint32_t>(burst), Clock::coarseMillis());
 }
 
-void RiskManager::onFill(uint64_t session_uuid, SecurityId /*security_id*/,
-                         Side side, Quantity qty) {
-    auto& state = session_state_[session_uuid];
-    if (side == Side::Buy) {
-        state.net_position += qty;
-    } else {
-        state.net_position -= qty;
+RiskManager::RiskResult RiskManager::checkRate(TokenBucket& bucket) const {
+    RiskResult result;
+    if (!bucket.tryTake(Clock::coarseMillis())) {
+        result.passed = false;
+        result.reason = "Rate limit exceeded: max " +
+                        std::to_string(config_.max_orders_per_second) + " orders/sec";
     }
+    return result;
 }
 
 } // namespace cme::sim::gateway
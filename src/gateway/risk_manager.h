@@ -3,8 +3,7 @@
 #include "../common/types.h"
 #include "../config/exchange_config.h"
 #include "../engine/order.h"
-#include <chrono>
-#include <unordered_map>
+#include "token_bucket.h"
 #include <string>
 
 namespace cme::sim::gateway {
@@ -13,26 +12,25 @@ class RiskManager {
 public:
     explicit RiskManager(const config::RiskConfig& config);
 
+    const config::RiskConfig& config() const { return config_; }
+
     struct RiskResult {
         bool passed = true;
         std::string reason;
     };
 
     RiskResult checkOrder(const Order& order) const;
-    RiskResult checkRate(uint64_t session_uuid);
 
-    void onFill(uint64_t session_uuid, SecurityId security_id,
-                Side side, Quantity qty);
+    // A new session's order-rate bucket: max_orders_per_second sustained,
+    // max_order_burst back to back. It starts full.
+    TokenBucket makeRateLimit() const;
+
+    // Take one new order from the session's bucket. Lock-free; call it on
+    // the IO thread that owns the bucket.
+    RiskResult checkRate(TokenBucket& bucket) const;
 
 private:
     config::RiskConfig config_;
-
-    struct SessionRiskState {
-        int64_t net_position = 0;
-        std::chrono::steady_clock::time_point last_order_time;
-        int orders_this_second = 0;
-    };
-    std::unordered_map<uint64_t, SessionRiskState> session_state_;
 };
 
 } // namespace cme::sim::gateway
@@ -0,0 +1,322 @@
+#include "risk_stage.h"
+#include "../engine/order_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <variant>
+
+namespace cme::sim::gateway {
+
+namespace {
+
+// Order types whose `price` is a limit (and so is held to the band)
+bool hasLimitPrice(OrderType type) {
+    return type == OrderType::Limit || type == OrderType::StopLimit;
+}
+
+} // anonymous namespace
+
+RiskStage::RiskStage(const config::RiskConfig& config, const InstrumentManager& instruments)
+    : band_pct_(config.max_price_deviation_pct) {
+    for (const Instrument& inst : instruments.getAllInstruments()) {
+        if (inst.security_id <= 0 || inst.security_id >= MAX_SECURITY_ID) continue;
+        auto id = static_cast<std::size_t>(inst.security_id);
+        if (id >= slot_by_security_.size()) slot_by_security_.resize(id + 1, NO_SLOT);
+        slot_by_security_[id] = static_cast<uint32_t>(instruments_.size());
+
+        InstrumentRisk risk;
+        risk.security_id = inst.security_id;
+        risk.max_position = inst.max_position > 0 ? inst.max_position
+                                                  : config.max_position_per_session;
+        risk.banded = !inst.isSpread();   // spreads trade around zero
+        instruments_.push_back(risk);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Checks
+// ---------------------------------------------------------------------------
+
+RejectReason RiskStage::checkNewOrder(const Order& order) {
+    if (exempt(order.session_uuid)) return RejectReason::None;
+    uint32_t slot = slotOf(order.security_id);
+    if (slot == NO_SLOT) return RejectReason::None;   // the engine rejects it
+
+    if (hasLimitPrice(order.order_type)) {
+        RejectReason band = checkBand(slot, order.price);
+        if (band != RejectReason::None) return band;
+    }
+    uint32_t row = acquireRow(order.session_uuid);
+    if (row == NO_ROW) return RejectReason::PreTradeRisk;
+    Cell& c = cell(row, slot);
+    RejectReason limit = checkPosition(&c, slot, order.side, order.quantity);
+    if (limit != RejectReason::None) {
+        releaseRow(row);
+        return limit;
+    }
+
+    openOf(c, order.side) += order.quantity;
+    return RejectReason::None;
+}
+
+void RiskStage::releaseNewOrder(const Order& order) {
+    if (exempt(order.session_uuid)) return;
+    uint32_t slot = slotOf(order.security_id);
+    uint32_t row = rowOf(order.session_uuid);
+    if (slot == NO_SLOT || row == NO_ROW) return;
+    openOf(cell(row, slot), order.side) -= order.quantity;
+    releaseRow(row);
+}
+
+RejectReason RiskStage::checkModify(uint64_t session_uuid, OrderId order_id,
+                                    Price new_price, Quantity new_qty, ModifyHold& hold) {
+    hold = ModifyHold{};
+    OrderHandle h = OrderPool::handleOf(order_id);
+    if (h >= open_orders_.size()) return RejectReason::None;
+    const OpenOrder& order = open_orders_[h];
+    if (order.order_id != order_id || order.session_uuid != session_uuid) {
+        return RejectReason::None;
+    }
+
+    if (order.limit) {
+        RejectReason band = checkBand(order.slot, new_price);
+        if (band != RejectReason::None) return band;
+    }
+    int64_t added = std::max<int64_t>(0, int64_t{new_qty} - order.filled) - order.leaves;
+    if (added <= 0) return RejectReason::None;
+    Cell& c = cell(order.row, order.slot);
+    RejectReason limit = checkPosition(&c, order.slot, order.side, added);
+    if (limit != RejectReason::None) return limit;
+
+    openOf(c, order.side) += added;
+    hold = ModifyHold{session_uuid, instruments_[order.slot].security_id, order.side, added};
+    return RejectReason::None;
+}
+
+void RiskStage::releaseModify(const ModifyHold& hold) {
+    if (hold.qty == 0) return;
+    uint32_t slot = slotOf(hold.security_id);
+    uint32_t row = rowOf(hold.session_uuid);
+    if (slot == NO_SLOT || row == NO_ROW) return;
+    openOf(cell(row, slot), hold.side) -= hold.qty;
+    releaseRow(row);
+}
+
+RejectReason RiskStage::checkBand(uint32_t slot, Price price) const {
+    const InstrumentRisk& inst = instruments_[slot];
+    if (!inst.banded || !inst.has_band) return RejectReason::None;
+    if (price.mantissa < inst.band_low || price.mantissa > inst.band_high) {
+        return RejectReason::PriceBand;
+    }
+    return RejectReason::None;
+}
+
+RejectReason RiskStage::checkPosition(const Cell* cell, uint32_t slot, Side side,
+                                      int64_t added) const {
+    int64_t position = cell ? cell->position : 0;
+    int64_t open = cell ? (side == Side::Buy ? cell->open_buy : cell->open_sell) : 0;
+    // Worst case: everything open on this side fills
+    int64_t exposure = (side == Side::Buy ? position : -position) + open + added;
+    return exposure > instruments_[slot].max_position ? RejectReason::PositionLimit
+                                                      : RejectReason::None;
+}
+
+// ---------------------------------------------------------------------------
+// Bookkeeping
+// ---------------------------------------------------------------------------
+
+void RiskStage::apply(std::span<const EngineEvent> events) {
+    for (const auto& event : events) {
+        std::visit([&](const auto& e) {
+            using T = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<T, OrderAccepted>) {
+                uint32_t slot = slotOf(e.security_id);
+                if (exempt(e.session_uuid) || slot == NO_SLOT) return;
+                open(e.order_id, e.session_uuid, slot, e.side,
+                     hasLimitPrice(e.order_type), 0, e.quantity);
+            } else if constexpr (std::is_same_v<T, OrderFilled>) {
+                uint32_t slot = slotOf(e.security_id);
+                if (slot == NO_SLOT) return;
+                setLastTrade(slot, e.trade_price);
+                Side maker_side = e.aggressor_side == Side::Buy ? Side::Sell : Side::Buy;
+                fill(e.maker_order_id, e.maker_session_uuid, slot, maker_side,
+                     e.trade_qty, e.maker_leaves_qty);
+                fill(e.taker_order_id, e.taker_session_uuid, slot, e.aggressor_side,
+                     e.trade_qty, e.taker_leaves_qty);
+            } else if constexpr (std::is_same_v<T, OrderCancelled>) {
+                if (OpenOrder* order = findOpen(e.order_id)) close(*order);
+            } else if constexpr (std::is_same_v<T, OrderModified>) {
+                OpenOrder* order = findOpen(e.order_id);
+                if (!order) return;
+                openOf(cell(order->row, order->slot), order->side) +=
+                    int64_t{e.leaves_qty} - order->leaves;
+                order->filled = e.cum_qty;
+                order->leaves = e.leaves_qty;
+                if (order->leaves <= 0) {
+                    order->order_id = 0;
+                    releaseRow(order->row);
+                }
+            }
+            // Rejects never opened anything; elections and cancel rejects
+            // change no quantities; book updates are market data
+        }, event);
+    }
+}
+
+void RiskStage::restore(const EngineSnapshot& snapshot,
+                        std::span<const checkpoint::Position> positions) {
+    for (const auto& book : snapshot.books) {
+        uint32_t slot = slotOf(book.security_id);
+        if (slot != NO_SLOT && !book.state.last_trade_price.isNull()) {
+            setLastTrade(slot, book.state.last_trade_price);
+        }
+    }
+    for (const Order& order : snapshot.orders) {
+        uint32_t slot = slotOf(order.security_id);
+        if (exempt(order.session_uuid) || slot == NO_SLOT) continue;
+        open(order.order_id, order.session_uuid, slot, order.side,
+             hasLimitPrice(order.order_type), order.filled_qty, order.remainingQty());
+    }
+    for (const checkpoint::Position& p : positions) {
+        uint32_t slot = slotOf(p.security_id);
+        if (exempt(p.session_uuid) || slot == NO_SLOT || p.net_position == 0) continue;
+        uint32_t row = acquireRow(p.session_uuid);
+        if (row != NO_ROW) cell(row, slot).position = p.net_position;
+    }
+}
+
+std::vector<checkpoint::Position> RiskStage::positions() const {
+    std::vector<checkpoint::Position> out;
+    if (instruments_.empty()) return out;
+    for (std::size_t i = 0; i < cells_.size(); ++i) {
+        if (cells_[i].position == 0) continue;   // free rows are all zero
+        out.push_back({session_by_row_[i / instruments_.size()],
+                       instruments_[i % instruments_.size()].security_id,
+                       cells_[i].position});
+    }
+    // Rows are handed out in no particular order
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+        return a.session_uuid != b.session_uuid ? a.session_uuid < b.session_uuid
+                                                : a.security_id < b.security_id;
+    });
+    return out;
+}
+
+void RiskStage::setLastTrade(uint32_t slot, Price price) {
+    InstrumentRisk& inst = instruments_[slot];
+    auto width = static_cast<int64_t>(
+        std::abs(static_cast<double>(price.mantissa)) * band_pct_ / 100.0);
+    inst.has_band = true;
+    inst.band_low = price.mantissa - width;
+    inst.band_high = price.mantissa + width;
+}
+
+RiskStage::OpenOrder* RiskStage::findOpen(OrderId order_id) {
+    OrderHandle h = OrderPool::handleOf(order_id);
+    if (h >= open_orders_.size() || open_orders_[h].order_id != order_id) return nullptr;
+    return &open_orders_[h];
+}
+
+void RiskStage::open(OrderId order_id, uint64_t session_uuid, uint32_t slot, Side side,
+                     bool limit, Quantity filled, Quantity leaves) {
+    OrderHandle h = OrderPool::handleOf(order_id);
+    if (h >= open_orders_.size()) open_orders_.resize(h + 1);
+    OpenOrder& order = open_orders_[h];
+    // Engines without an order pool can wrap onto a slot still in use
+    if (order.order_id != 0) close(order);
+
+    uint32_t row = acquireRow(session_uuid);
+    if (row == NO_ROW) return;
+    order = OpenOrder{order_id, session_uuid, row, slot, side, limit, filled, leaves};
+    openOf(cell(row, slot), side) += leaves;
+}
+
+void RiskStage::close(OpenOrder& order) {
+    openOf(cell(order.row, order.slot), order.side) -= order.leaves;
+    order.order_id = 0;
+    releaseRow(order.row);
+}
+
+void RiskStage::fill(OrderId order_id, uint64_t session_uuid, uint32_t slot, Side side,
+                     Quantity qty, Quantity leaves) {
+    if (exempt(session_uuid)) return;
+    uint32_t row = acquireRow(session_uuid);
+    if (row == NO_ROW) return;
+    Cell& c = cell(row, slot);
+    c.position += side == Side::Buy ? qty : -int64_t{qty};
+
+    if (OpenOrder* order = findOpen(order_id)) {
+        openOf(c, side) -= int64_t{order->leaves} - leaves;
+        order->filled += qty;
+        order->leaves = leaves;
+        if (leaves <= 0) order->order_id = 0;
+    }
+    releaseRow(row);
+}
+
+// ---------------------------------------------------------------------------
+// Lookups
+// ---------------------------------------------------------------------------
+
+uint32_t RiskStage::slotOf(SecurityId security_id) const {
+    if (security_id <= 0 || static_cast<std::size_t>(security_id) >= slot_by_security_.size()) {
+        return NO_SLOT;
+    }
+    return slot_by_security_[static_cast<std::size_t>(security_id)];
+}
+
+uint32_t RiskStage::rowOf(uint64_t session_uuid) const {
+    auto it = row_by_session_.find(session_uuid);
+    return it == row_by_session_.end() ? NO_ROW : it->second;
+}
+
+uint32_t RiskStage::acquireRow(uint64_t session_uuid) {
+    auto it = row_by_session_.find(session_uuid);
+    if (it != row_by_session_.end()) return it->second;
+
+    uint32_t row;
+    if (!free_rows_.empty()) {
+        row = free_rows_.back();
+        free_rows_.pop_back();
+        session_by_row_[row] = session_uuid;
+    } else if (session_by_row_.size() < MAX_SESSIONS) {
+        row = static_cast<uint32_t>(session_by_row_.size());
+        session_by_row_.push_back(session_uuid);
+        cells_.resize(cells_.size() + instruments_.size());
+    } else {
+        return NO_ROW;
+    }
+    row_by_session_.emplace(session_uuid, row);
+    return row;
+}
+
+void RiskStage::releaseRow(uint32_t row) {
+    const Cell* first = &cells_[row * instruments_.size()];
+    bool idle = std::all_of(first, first + instruments_.size(), [](const Cell& c) {
+        return c.position == 0 && c.open_buy == 0 && c.open_sell == 0;
+    });
+    auto it = row_by_session_.find(session_by_row_[row]);
+    if (!idle || it == row_by_session_.end() || it->second != row) return;
+    row_by_session_.erase(it);
+    free_rows_.push_back(row);
+}
+
+const RiskStage::Cell* RiskStage::findCell(uint64_t session_uuid, uint32_t slot) const {
+    uint32_t row = rowOf(session_uuid);
+    return row == NO_ROW ? nullptr : &cells_[row * instruments_.size() + slot];
+}
+
+int64_t RiskStage::position(uint64_t session_uuid, SecurityId security_id) const {
+    uint32_t slot = slotOf(security_id);
+    const Cell* c = slot == NO_SLOT ? nullptr : findCell(session_uuid, slot);
+    return c ? c->position : 0;
+}
+
+int64_t RiskStage::openQty(uint64_t session_uuid, SecurityId security_id, Side side) const {
+    uint32_t slot = slotOf(security_id);
+    const Cell* c = slot == NO_SLOT ? nullptr : findCell(session_uuid, slot);
+    if (!c) return 0;
+    return side == Side::Buy ? c->open_buy : c->open_sell;
+}
+
+} // namespace cme::sim::gateway
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../checkpoint/checkpoint.h"
+#include "../common/types.h"
+#include "../config/exchange_config.h"
+#include "../engine/engine_event.h"
+#include "../engine/full_matching_engine.h"
+#include "../engine/liquidity_provider.h"
+#include "../engine/order.h"
+#include "../instruments/instrument_manager.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace cme::sim::gateway {
+
+// ---------------------------------------------------------------------------
+// Pre-trade risk of one engine shard, run on its engine thread.
+//
+// That thread is the only writer of everything here, so nothing is locked.
+// A new order (or a cancel/replace) is checked against
+//   - a price band of max_price_deviation_pct around the instrument's last
+//     trade (outrights only; no band before the first trade), and
+//   - the session's worst-case position in the instrument: its filled
+//     position plus every open order on the order's side, against the
+//     instrument's max_position (risk.max_position_per_session if unset).
+//
+// An order that passes (or the quantity a cancel/replace adds) is held as
+// open straight away, so later orders in the same batch see it. Once the
+// engine has run it, releaseNewOrder()/releaseModify() drop the hold and
+// apply() books what actually happened: accepts open quantity, fills move
+// it into the position, cancels release it.
+//
+// State is flat arrays: instruments get dense slots through a table
+// indexed by security ID, each session a row of per-instrument cells, and
+// each open order the entry of its order pool handle (the low 24 bits of
+// its OrderId). Session rows are dense: a map hands one out on a session's
+// first order and takes it back once the session is flat with nothing
+// open, so a long run of short sessions reuses the same rows. The
+// liquidity provider's orders are the only ones not checked.
+// ---------------------------------------------------------------------------
+class RiskStage {
+public:
+    RiskStage(const config::RiskConfig& config, const InstrumentManager& instruments);
+
+    // RejectReason::None if the order may go to the engine; its quantity
+    // is then held as open until releaseNewOrder(). PreTradeRisk if all
+    // MAX_SESSIONS rows are taken.
+    RejectReason checkNewOrder(const Order& order);
+    void releaseNewOrder(const Order& order);
+
+    // What a cancel/replace that passed holds as open until the engine has
+    // run it (nothing if it adds no quantity)
+    struct ModifyHold {
+        uint64_t session_uuid = 0;
+        SecurityId security_id = 0;
+        Side side = Side::Buy;
+        int64_t qty = 0;
+    };
+
+    // A cancel/replace of one of the session's open orders: the new price
+    // against the band, any quantity it adds against the position limit.
+    // Orders this stage does not know are left to the engine. Like a new
+    // order, the added quantity is held (in `hold`) until releaseModify().
+    RejectReason checkModify(uint64_t session_uuid, OrderId order_id,
+                             Price new_price, Quantity new_qty, ModifyHold& hold);
+    void releaseModify(const ModifyHold& hold);
+
+    // Book one command's engine events
+    void apply(std::span<const EngineEvent> events);
+
+    // Seed from a restored checkpoint: the engine's resting orders count
+    // as open, each book's last trade sets its band, and the positions of
+    // this shard's instruments are loaded back (others are skipped)
+    void restore(const EngineSnapshot& snapshot,
+                 std::span<const checkpoint::Position> positions);
+
+    // Every non-flat position, for a checkpoint
+    std::vector<checkpoint::Position> positions() const;
+
+    // Filled position (+long/-short) and open quantity of a session in an
+    // instrument; 0 for ones not tracked
+    int64_t position(uint64_t session_uuid, SecurityId security_id) const;
+    int64_t openQty(uint64_t session_uuid, SecurityId security_id, Side side) const;
+
+    // Sessions holding a row right now
+    std::size_t trackedSessions() const { return row_by_session_.size(); }
+
+    // Most sessions with a position or open orders at once
+    static constexpr std::size_t MAX_SESSIONS = std::size_t{1} << 20;
+
+private:
+    // Instruments with security IDs past this are not tracked
+    static constexpr SecurityId MAX_SECURITY_ID = SecurityId{1} << 20;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+    struct InstrumentRisk {
+        SecurityId security_id = 0;
+        int64_t max_position = 0;
+        bool banded = false;        // outrights only
+        bool has_band = false;      // set by the first trade
+        int64_t band_low = 0;       // Price mantissas, inclusive
+        int64_t band_high = 0;
+    };
+
+    struct Cell {
+        int64_t position = 0;
+        int64_t open_buy = 0;
+        int64_t open_sell = 0;
+    };
+
+    struct OpenOrder {
+        OrderId order_id = 0;       // 0 = free
+        uint64_t session_uuid = 0;
+        uint32_t row = 0;           // held while the order is open
+        uint32_t slot = 0;
+        Side side = Side::Buy;
+        bool limit = false;         // has a limit price to band
+        Quantity filled = 0;
+        Quantity leaves = 0;
+    };
+
+    static bool exempt(uint64_t session_uuid) {
+        return session_uuid == LiquidityProvider::SESSION_UUID;
+    }
+    uint32_t slotOf(SecurityId security_id) const;
+    uint32_t rowOf(uint64_t session_uuid) const;       // NO_ROW if it has none
+    uint32_t acquireRow(uint64_t session_uuid);        // NO_ROW if all are taken
+    void releaseRow(uint32_t row);                     // if flat with nothing open
+    Cell& cell(uint32_t row, uint32_t slot) { return cells_[row * instruments_.size() + slot]; }
+    const Cell* findCell(uint64_t session_uuid, uint32_t slot) const;
+    static int64_t& openOf(Cell& cell, Side side) {
+        return side == Side::Buy ? cell.open_buy : cell.open_sell;
+    }
+
+    RejectReason checkBand(uint32_t slot, Price price) const;
+    RejectReason checkPosition(const Cell* cell, uint32_t slot, Side side, int64_t added) const;
+    void setLastTrade(uint32_t slot, Price price);
+
+    OpenOrder* findOpen(OrderId order_id);
+    void open(OrderId order_id, uint64_t session_uuid, uint32_t slot, Side side, bool limit,
+              Quantity filled, Quantity leaves);
+    void close(OpenOrder& order);
+    void fill(OrderId order_id, uint64_t session_uuid, uint32_t slot, Side side,
+              Quantity qty, Quantity leaves);
+
+    double band_pct_;
+    std::vector<uint32_t> slot_by_security_;
+    std::vector<InstrumentRisk> instruments_;
+    std::unordered_map<uint64_t, uint32_t> row_by_session_;
+    std::vector<uint64_t> session_by_row_;
+    std::vector<uint32_t> free_rows_;
+    std::vector<Cell> cells_;             // row per tracked session, cell per slot
+    std::vector<OpenOrder> open_orders_;  // by order pool handle
+};
+
+} // namespace cme::sim::gateway
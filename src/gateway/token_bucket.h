@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cme::sim::gateway {
+
+// ---------------------------------------------------------------------------
+// Order-rate token bucket for one session.
+//
+// Holds up to `burst` orders' worth of tokens and refills at `rate` per
+// second from a coarse millisecond clock. Tokens are counted in thousandths,
+// so a refill is one multiply with no rounding drift between calls.
+//
+// Not thread-safe: a bucket belongs to its session and is only touched on
+// the IO thread that session lives on.
+// ---------------------------------------------------------------------------
+class TokenBucket {
+public:
+    TokenBucket(uint32_t rate_per_second, uint32_t burst, uint64_t now_ms)
+        : rate_(rate_per_second)
+        , capacity_(static_cast<uint64_t>(burst) * UNIT)
+        , tokens_(capacity_)
+        , last_ms_(now_ms) {}
+
+    // Take one order's token; false (taking nothing) when the bucket is empty
+    bool tryTake(uint64_t now_ms) {
+        refill(now_ms);
+        if (tokens_ < UNIT) return false;
+        tokens_ -= UNIT;
+        return true;
+    }
+
+    // Whole tokens left as of the last tryTake()
+    uint64_t available() const { return tokens_ / UNIT; }
+
+private:
+    static constexpr uint64_t UNIT = 1000;
+
+    void refill(uint64_t now_ms) {
+        if (now_ms <= last_ms_) return;
+        // rate_ tokens per second is rate_ thousandths per millisecond
+        tokens_ = std::min(capacity_, tokens_ + (now_ms - last_ms_) * rate_);
+        last_ms_ = now_ms;
+    }
+
+    uint64_t rate_;
+    uint64_t capacity_;
+    uint64_t tokens_;
+    uint64_t last_ms_;
+};
+
+} // namespace cme::sim::gateway
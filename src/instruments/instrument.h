@@ -13,6 +13,11 @@ struct Instrument {
     std::string asset;             // e.g. "ES"
     int channel_id;
 
+    // Calendar spreads: buying the spread buys the front leg and sells the
+    // back leg. Both are 0 for outrights.
+    SecurityId front_leg_id = 0;
+    SecurityId back_leg_id = 0;
+
     // Pricing
     double tick_size;              // minimum price increment (e.g. 0.25 for ES)
     double contract_multiplier;    // e.g. 50 for ES
@@ -22,6 +27,7 @@ struct Instrument {
     // Quantity limits
     Quantity min_trade_vol = 1;
     Quantity max_trade_vol = 10000;
+    int64_t max_position = 0;      // per session, worst case; 0 = risk default
 
     // Contract info
     std::string maturity_month_year; // e.g. "202503"
@@ -30,6 +36,8 @@ struct Instrument {
     // Trading status
     SecurityTradingStatus trading_status = SecurityTradingStatus::PreOpen;
 
+    bool isSpread() const { return front_leg_id != 0; }
+
     // Convert a floating-point tick size to mantissa in the Price fixed-point space
     int64_t tickMantissa() const {
         return static_cast<int64_t>(tick_size * 1e9);
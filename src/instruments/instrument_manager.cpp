@@ -43,6 +43,7 @@ void InstrumentManager::loadFromConfig(
         inst.display_factor = ic.display_factor;
         inst.min_trade_vol = ic.min_trade_vol;
         inst.max_trade_vol = ic.max_trade_vol;
+        inst.max_position = ic.max_position;
         inst.maturity_month_year = ic.maturity_month_year;
         inst.trading_status = SecurityTradingStatus::PreOpen;
 
@@ -58,6 +59,19 @@ void InstrumentManager::loadFromConfig(
 
         instruments_.push_back(std::move(inst));
     }
+
+    // Resolve spread legs once every outright is known
+    for (const auto& ic : instrument_configs) {
+        if (ic.legs.size() != 2) continue;
+        const Instrument* front = findBySymbol(ic.legs[0]);
+        const Instrument* back = findBySymbol(ic.legs[1]);
+        if (!front || !back) continue;
+        Instrument& spread = instruments_[by_security_id_[ic.security_id]];
+        spread.front_leg_id = front->security_id;
+        spread.back_leg_id = back->security_id;
+        spread.security_group = front->security_group;
+        spread.asset = front->asset;
+    }
 }
 
 const Instrument* InstrumentManager::findBySecurityId(SecurityId id) const {
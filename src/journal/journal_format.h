@@ -0,0 +1,102 @@
+#pragma once
+#include "../common/types.h"
+#include "../engine/engine_event.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace cme::sim::journal {
+
+// ---------------------------------------------------------------------------
+// On-disk layout of an engine journal (one file per engine shard).
+//
+//   FileHeader
+//   InstrumentEntry[instrument_count]   the engine's books, in add order
+//   SpreadEntry[spread_count]
+//   (zero padding to RECORDS_OFFSET)
+//   CommandRecord...                    every command the engine ran
+//
+// All structs are written as raw host-endian bytes. Records are fixed-size
+// and start with MARKER; the file grows in zero-filled chunks, so the first
+// record without the marker ends the journal even if the writer never got
+// to trim the file (e.g. the process was killed).
+// ---------------------------------------------------------------------------
+
+inline constexpr char MAGIC[8] = {'C', 'M', 'E', 'J', 'R', 'N', 'L', '1'};
+inline constexpr uint32_t VERSION = 1;
+inline constexpr std::size_t RECORDS_OFFSET = 4096;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t instrument_count;
+    uint32_t spread_count;
+    int32_t implied_depth;
+    uint8_t shard_id;
+    uint8_t pad[3];
+    uint64_t created_ns;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct InstrumentEntry {
+    int32_t security_id;
+    int32_t max_published_depth;
+    int64_t tick_mantissa;
+    uint64_t ladder_ticks;
+    uint8_t backend;       // BookBackend
+    uint8_t smp_mode;      // SmpMode
+    uint8_t pad[6];
+};
+static_assert(sizeof(InstrumentEntry) == 32);
+
+struct SpreadEntry {
+    int32_t spread_id;
+    int32_t front_id;
+    int32_t back_id;
+};
+static_assert(sizeof(SpreadEntry) == 12);
+
+// One EngineCommand as the engine ran it
+struct CommandRecord {
+    static constexpr uint16_t MARKER = 0xC3D1;
+
+    uint16_t marker;
+    uint8_t type;              // EngineCommand::Type
+    uint8_t side;              // NewOrder side; MassCancel side (0 = both)
+    uint8_t order_type;
+    uint8_t time_in_force;
+    uint8_t pad[2];
+    uint64_t batch_seq;        // records of one processBatch call share it
+    uint64_t session_uuid;
+    uint64_t timestamp;        // NewOrder: time the engine thread stamped
+    uint64_t order_id;         // NewOrder: ID the engine assigned (0 if
+                               // rejected); Cancel/Modify: the target
+    int32_t security_id;
+    uint32_t smp_id;
+    int64_t price;
+    int64_t stop_price;
+    int64_t new_price;
+    int32_t quantity;
+    int32_t display_qty;
+    int32_t min_qty;
+    int32_t new_qty;
+    char cl_ord_id[ClOrdId::CAPACITY];
+    char new_cl_ord_id[ClOrdId::CAPACITY];
+};
+// Two cache lines; a power of two, so records never straddle a page
+static_assert(sizeof(CommandRecord) == 128);
+static_assert(std::is_trivially_copyable_v<CommandRecord>);
+
+// The ID a new order's events show the engine assigned (0 if rejected)
+inline OrderId assignedOrderId(std::span<const EngineEvent> events) {
+    for (const auto& event : events) {
+        if (const auto* accepted = std::get_if<OrderAccepted>(&event)) return accepted->order_id;
+        if (std::holds_alternative<OrderRejected>(event)) return 0;
+    }
+    return 0;
+}
+
+} // namespace cme::sim::journal
@@ -0,0 +1,138 @@
+#include "journal_reader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cme::sim::journal {
+
+namespace {
+
+EngineCommand toCommand(const CommandRecord& rec) {
+    EngineCommand cmd;
+    cmd.type = static_cast<EngineCommand::Type>(rec.type);
+    cmd.session_uuid = rec.session_uuid;
+    cmd.security_id = rec.security_id;
+
+    switch (cmd.type) {
+        case EngineCommand::Type::NewOrder: {
+            Order& o = cmd.order;
+            o.session_uuid = rec.session_uuid;
+            o.smp_id = rec.smp_id;
+            o.security_id = rec.security_id;
+            o.side = static_cast<Side>(rec.side);
+            o.order_type = static_cast<OrderType>(rec.order_type);
+            o.time_in_force = static_cast<TimeInForce>(rec.time_in_force);
+            o.price = Price{rec.price};
+            o.stop_price = Price{rec.stop_price};
+            o.quantity = rec.quantity;
+            o.display_qty = rec.display_qty;
+            o.min_qty = rec.min_qty;
+            o.timestamp = rec.timestamp;
+            o.cl_ord_id = ClOrdId::fromWire(rec.cl_ord_id);
+            break;
+        }
+        case EngineCommand::Type::CancelOrder:
+            cmd.order_id = rec.order_id;
+            break;
+        case EngineCommand::Type::ModifyOrder:
+            cmd.order_id = rec.order_id;
+            cmd.new_price = Price{rec.new_price};
+            cmd.new_qty = rec.new_qty;
+            cmd.new_cl_ord_id = ClOrdId::fromWire(rec.new_cl_ord_id);
+            break;
+        case EngineCommand::Type::MassCancel:
+            if (rec.side != 0) cmd.mass_side = static_cast<Side>(rec.side);
+            break;
+    }
+    return cmd;
+}
+
+} // anonymous namespace
+
+JournalReader::JournalReader(std::string path)
+    : path_(std::move(path)) {}
+
+JournalReader::~JournalReader() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+bool JournalReader::open() {
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < RECORDS_OFFSET) {
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    data_ = static_cast<const char*>(p);
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.record_size != sizeof(CommandRecord)) {
+        return false;
+    }
+    std::size_t table_size = sizeof(FileHeader) +
+                             std::size_t{header.instrument_count} * sizeof(InstrumentEntry) +
+                             std::size_t{header.spread_count} * sizeof(SpreadEntry);
+    if (table_size > RECORDS_OFFSET) return false;
+
+    layout_ = EngineLayout{};
+    layout_.shard_id = header.shard_id;
+    layout_.implied_depth = header.implied_depth;
+    created_ns_ = header.created_ns;
+
+    std::size_t pos = sizeof(header);
+    for (uint32_t i = 0; i < header.instrument_count; ++i) {
+        InstrumentEntry entry;
+        std::memcpy(&entry, data_ + pos, sizeof(entry));
+        pos += sizeof(entry);
+        BookConfig config;
+        config.backend = static_cast<BookBackend>(entry.backend);
+        config.tick_mantissa = entry.tick_mantissa;
+        config.ladder_ticks = static_cast<std::size_t>(entry.ladder_ticks);
+        config.max_published_depth = entry.max_published_depth;
+        config.smp_mode = static_cast<SmpMode>(entry.smp_mode);
+        layout_.instruments.emplace_back(entry.security_id, config);
+    }
+    for (uint32_t i = 0; i < header.spread_count; ++i) {
+        SpreadEntry entry;
+        std::memcpy(&entry, data_ + pos, sizeof(entry));
+        pos += sizeof(entry);
+        layout_.spreads.push_back({entry.spread_id, entry.front_id, entry.back_id});
+    }
+
+    // Records run up to the first one without a marker (zero fill past
+    // the last record if the writer was not closed cleanly)
+    records_ = reinterpret_cast<const CommandRecord*>(data_ + RECORDS_OFFSET);
+    std::size_t capacity = (size_ - RECORDS_OFFSET) / sizeof(CommandRecord);
+    record_count_ = 0;
+    while (record_count_ < capacity && records_[record_count_].marker == CommandRecord::MARKER) {
+        ++record_count_;
+    }
+    next_ = 0;
+    return true;
+}
+
+bool JournalReader::nextBatch(JournalBatch& batch) {
+    batch.commands.clear();
+    batch.expected_ids.clear();
+    if (next_ >= record_count_) return false;
+
+    batch.batch_seq = records_[next_].batch_seq;
+    while (next_ < record_count_ && records_[next_].batch_seq == batch.batch_seq) {
+        const CommandRecord& rec = records_[next_++];
+        batch.commands.push_back(toCommand(rec));
+        batch.expected_ids.push_back(
+            rec.type == static_cast<uint8_t>(EngineCommand::Type::NewOrder) ? rec.order_id : 0);
+    }
+    return true;
+}
+
+} // namespace cme::sim::journal
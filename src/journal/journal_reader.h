@@ -0,0 +1,57 @@
+#pragma once
+#include "journal_format.h"
+#include "../engine/full_matching_engine.h"
+#include "../engine/matching_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cme::sim::journal {
+
+// One journaled processBatch call, decoded back into engine commands.
+// expected_ids[i] is the OrderId the engine gave commands[i] when it was
+// recorded (NewOrder only; 0 otherwise or if it was rejected).
+struct JournalBatch {
+    uint64_t batch_seq = 0;
+    std::vector<EngineCommand> commands;
+    std::vector<OrderId> expected_ids;
+};
+
+// ---------------------------------------------------------------------------
+// Reads a journal written by JournalWriter. The file is mapped read-only;
+// records are decoded batch by batch.
+// ---------------------------------------------------------------------------
+class JournalReader {
+public:
+    explicit JournalReader(std::string path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Map the file and check its header. False if it is not a journal.
+    bool open();
+
+    // Layout of the engine that wrote the journal
+    const EngineLayout& layout() const { return layout_; }
+    uint64_t createdNs() const { return created_ns_; }
+    std::size_t recordCount() const { return record_count_; }
+
+    // Decode the next batch into `batch`; false at the end of the journal
+    bool nextBatch(JournalBatch& batch);
+    void rewind() { next_ = 0; }
+
+private:
+    std::string path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    EngineLayout layout_;
+    uint64_t created_ns_ = 0;
+    const CommandRecord* records_ = nullptr;
+    std::size_t record_count_ = 0;
+    std::size_t next_ = 0;
+};
+
+} // namespace cme::sim::journal
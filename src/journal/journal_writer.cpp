@@ -0,0 +1,219 @@
+#include "journal_writer.h"
+#include "../common/clock.h"
+#include "../common/cpu_affinity.h"
+#include "../common/idle_strategy.h"
+#include "../common/logger.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace cme::sim::journal {
+
+namespace {
+
+CommandRecord toRecord(const EngineCommand& cmd, uint64_t batch_seq, OrderId assigned_id) {
+    CommandRecord rec{};
+    rec.marker = CommandRecord::MARKER;
+    rec.type = static_cast<uint8_t>(cmd.type);
+    rec.batch_seq = batch_seq;
+    rec.session_uuid = cmd.session_uuid;
+    rec.security_id = cmd.security_id;
+
+    switch (cmd.type) {
+        case EngineCommand::Type::NewOrder: {
+            const Order& o = cmd.order;
+            rec.side = static_cast<uint8_t>(o.side);
+            rec.order_type = static_cast<uint8_t>(o.order_type);
+            rec.time_in_force = static_cast<uint8_t>(o.time_in_force);
+            rec.timestamp = o.timestamp;
+            rec.order_id = assigned_id;
+            rec.security_id = o.security_id;
+            rec.smp_id = o.smp_id;
+            rec.price = o.price.mantissa;
+            rec.stop_price = o.stop_price.mantissa;
+            rec.quantity = o.quantity;
+            rec.display_qty = o.display_qty;
+            rec.min_qty = o.min_qty;
+            o.cl_ord_id.toWire(rec.cl_ord_id);
+            break;
+        }
+        case EngineCommand::Type::CancelOrder:
+            rec.order_id = cmd.order_id;
+            break;
+        case EngineCommand::Type::ModifyOrder:
+            rec.order_id = cmd.order_id;
+            rec.new_price = cmd.new_price.mantissa;
+            rec.new_qty = cmd.new_qty;
+            cmd.new_cl_ord_id.toWire(rec.new_cl_ord_id);
+            break;
+        case EngineCommand::Type::MassCancel:
+            rec.side = cmd.mass_side ? static_cast<uint8_t>(*cmd.mass_side) : 0;
+            break;
+    }
+    return rec;
+}
+
+bool writeAll(int fd, const char* data, std::size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t n = ::pwrite(fd, data, len, offset);
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<std::size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+JournalWriter::JournalWriter(std::string path, EngineLayout layout, std::size_t queue_capacity)
+    : path_(std::move(path))
+    , layout_(std::move(layout))
+    , queue_(queue_capacity) {}
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+bool JournalWriter::open() {
+    // Header, instrument and spread tables share the first page
+    std::size_t table_size = sizeof(FileHeader) +
+                             layout_.instruments.size() * sizeof(InstrumentEntry) +
+                             layout_.spreads.size() * sizeof(SpreadEntry);
+    if (table_size > RECORDS_OFFSET) return false;
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+
+    std::vector<char> page(RECORDS_OFFSET, 0);
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.record_size = sizeof(CommandRecord);
+    header.instrument_count = static_cast<uint32_t>(layout_.instruments.size());
+    header.spread_count = static_cast<uint32_t>(layout_.spreads.size());
+    header.implied_depth = layout_.implied_depth;
+    header.shard_id = layout_.shard_id;
+    header.created_ns = Clock::epochNanos();
+    std::memcpy(page.data(), &header, sizeof(header));
+
+    std::size_t pos = sizeof(header);
+    for (const auto& [security_id, config] : layout_.instruments) {
+        InstrumentEntry entry{};
+        entry.security_id = security_id;
+        entry.max_published_depth = config.max_published_depth;
+        entry.tick_mantissa = config.tick_mantissa;
+        entry.ladder_ticks = config.ladder_ticks;
+        entry.backend = static_cast<uint8_t>(config.backend);
+        entry.smp_mode = static_cast<uint8_t>(config.smp_mode);
+        std::memcpy(page.data() + pos, &entry, sizeof(entry));
+        pos += sizeof(entry);
+    }
+    for (const auto& spread : layout_.spreads) {
+        SpreadEntry entry{spread.spread_id, spread.front_id, spread.back_id};
+        std::memcpy(page.data() + pos, &entry, sizeof(entry));
+        pos += sizeof(entry);
+    }
+
+    write_offset_ = RECORDS_OFFSET;
+    if (!writeAll(fd_, page.data(), page.size(), 0) || !mapWindow(RECORDS_OFFSET)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void JournalWriter::start(int cpu) {
+    if (fd_ < 0 || thread_.joinable()) return;
+    running_.store(true);
+    thread_ = std::thread(&JournalWriter::run, this, cpu);
+}
+
+void JournalWriter::close() {
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+    if (fd_ < 0) return;
+
+    // Whatever the thread left (or everything, if it never ran)
+    while (const CommandRecord* rec = queue_.front()) {
+        write(*rec);
+        queue_.pop();
+    }
+    if (window_) ::munmap(window_, WINDOW_SIZE);
+    window_ = nullptr;
+    if (::ftruncate(fd_, static_cast<off_t>(write_offset_)) != 0) {
+        getLogger("JOURNAL")->warn("{}: could not trim to {} bytes", path_, write_offset_);
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void JournalWriter::appendBatch(std::span<const EngineCommand> commands, const EventSink& events,
+                                std::span<const EventRange> ranges) {
+    uint64_t batch_seq = next_batch_seq_++;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const EngineCommand& cmd = commands[i];
+        OrderId assigned = 0;
+        if (cmd.type == EngineCommand::Type::NewOrder) {
+            assigned = assignedOrderId(events.range(ranges[i].first, ranges[i].count));
+        }
+        CommandRecord rec = toRecord(cmd, batch_seq, assigned);
+        while (!queue_.tryPush(rec)) {
+            producer_stalls_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JournalWriter::run(int cpu) {
+    if (!pinCurrentThread(cpu)) {
+        getLogger("JOURNAL")->warn("Journal writer: could not pin to CPU {}", cpu);
+    }
+    IdleStrategy idle(IdleMode::Sleep, 0, std::chrono::microseconds(100));
+    while (true) {
+        bool did_work = false;
+        while (const CommandRecord* rec = queue_.front()) {
+            write(*rec);
+            queue_.pop();
+            did_work = true;
+        }
+        if (!running_.load(std::memory_order_acquire)) break;
+        idle.idle(did_work);
+    }
+}
+
+bool JournalWriter::mapWindow(uint64_t offset) {
+    if (window_) ::munmap(window_, WINDOW_SIZE);
+    window_ = nullptr;
+    if (::ftruncate(fd_, static_cast<off_t>(offset + WINDOW_SIZE)) != 0) return false;
+    void* p = ::mmap(nullptr, WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                     static_cast<off_t>(offset));
+    if (p == MAP_FAILED) return false;
+    window_ = static_cast<char*>(p);
+    window_offset_ = offset;
+    return true;
+}
+
+void JournalWriter::write(const CommandRecord& record) {
+    if (!window_ || write_offset_ >= window_offset_ + WINDOW_SIZE) {
+        if (!mapWindow(write_offset_)) {
+            getLogger("JOURNAL")->error("{}: could not map at offset {}; record dropped",
+                                        path_, write_offset_);
+            return;
+        }
+    }
+    // Marker last: a record cut short by a kill reads as the end
+    char* dest = window_ + (write_offset_ - window_offset_);
+    std::memcpy(dest + sizeof(record.marker),
+                reinterpret_cast<const char*>(&record) + sizeof(record.marker),
+                sizeof(record) - sizeof(record.marker));
+    std::memcpy(dest, &record.marker, sizeof(record.marker));
+    write_offset_ += sizeof(record);
+    records_written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace cme::sim::journal
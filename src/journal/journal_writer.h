@@ -0,0 +1,79 @@
+#pragma once
+#include "journal_format.h"
+#include "../common/spsc_queue.h"
+#include "../engine/full_matching_engine.h"
+#include "../engine/matching_engine.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace cme::sim::journal {
+
+// ---------------------------------------------------------------------------
+// Append-only binary journal of the commands one engine shard runs.
+//
+// The engine thread turns each batch into fixed-size CommandRecords and
+// hands them over an SPSC queue; a writer thread copies them into the file
+// through a memory-mapped window that it moves forward (growing the file)
+// as it fills. The engine thread never touches the file. If the queue is
+// full the engine thread waits for room rather than drop a record, since a
+// journal with a gap cannot be replayed.
+//
+// Written pages live in the page cache, so records the writer has copied
+// survive the process being killed; close() trims the file to its records.
+// ---------------------------------------------------------------------------
+class JournalWriter {
+public:
+    JournalWriter(std::string path, EngineLayout layout, std::size_t queue_capacity = 65536);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Create (truncate) the file and write its header. False on any I/O error.
+    bool open();
+
+    // Start the writer thread, pinned to `cpu` if not -1
+    void start(int cpu = -1);
+
+    // Write out everything queued, stop the writer thread and trim the file
+    void close();
+
+    // Engine thread: journal one processBatch call. ranges[i] locates
+    // commands[i]'s events in `events` (for the IDs new orders were given).
+    void appendBatch(std::span<const EngineCommand> commands, const EventSink& events,
+                     std::span<const EventRange> ranges);
+
+    const std::string& path() const { return path_; }
+    uint64_t recordsWritten() const { return records_written_.load(std::memory_order_relaxed); }
+    // Times the engine thread found the queue full and had to wait
+    uint64_t producerStalls() const { return producer_stalls_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t WINDOW_SIZE = std::size_t{64} << 20;
+
+    std::string path_;
+    EngineLayout layout_;
+    SPSCQueue<CommandRecord> queue_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    int fd_ = -1;
+    uint64_t next_batch_seq_ = 1;  // engine thread only
+
+    // Writer thread only
+    char* window_ = nullptr;       // mapping of [window_offset_, +WINDOW_SIZE)
+    uint64_t window_offset_ = 0;
+    uint64_t write_offset_ = 0;    // file offset of the next record
+
+    std::atomic<uint64_t> records_written_{0};
+    std::atomic<uint64_t> producer_stalls_{0};
+
+    void run(int cpu);
+    bool mapWindow(uint64_t offset);
+    void write(const CommandRecord& record);
+};
+
+} // namespace cme::sim::journal
@@ -5,22 +5,33 @@
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "config/config_loader.h"
 #include "config/exchange_config.h"
 #include "common/asio_compat.h"
+#include "common/clock.h"
+#include "common/cpu_affinity.h"
+#include "common/idle_strategy.h"
 #include "common/logger.h"
 #include "common/types.h"
 #include "network/io_context_pool.h"
 #include "network/tcp_acceptor.h"
 #include "fixp/session_manager.h"
 #include "gateway/order_entry_gateway.h"
+#include "engine/book_snapshot_source.h"
 #include "engine/full_matching_engine.h"
 #include "engine/engine_event.h"
+#include "engine/liquidity_provider.h"
+#include "journal/journal_writer.h"
+#include "checkpoint/checkpoint.h"
 #include "market_data/market_data_publisher.h"
 #include "instruments/instrument_manager.h"
 
@@ -118,35 +129,92 @@ static void printBanner(const ExchangeConfig& cfg,
     std::cout << std::endl;
 }
 
+// ---------------------------------------------------------------------------
+// engine.smp_mode (validated by validateConfig) to the book setting
+// ---------------------------------------------------------------------------
+static SmpMode smpModeFromName(const std::string& name) {
+    if (name == "cancel_resting")   return SmpMode::CancelResting;
+    if (name == "cancel_aggressor") return SmpMode::CancelAggressor;
+    if (name == "cancel_both")      return SmpMode::CancelBoth;
+    return SmpMode::None;
+}
+
+// ---------------------------------------------------------------------------
+// Full matching engine with one order book per configured instrument.
+// channel_id != 0 limits it to that channel's instruments (one shard).
+// ---------------------------------------------------------------------------
+static std::unique_ptr<FullMatchingEngine> createFullMatchingEngine(
+        const ExchangeConfig& cfg, const InstrumentManager& instruments,
+        int channel_id = 0, uint8_t shard_id = 0) {
+    auto engine = std::make_unique<FullMatchingEngine>(shard_id, cfg.engine.implied_depth);
+    for (const auto& ic : cfg.instruments) {
+        const Instrument* inst = instruments.findBySecurityId(ic.security_id);
+        if (!inst) continue;
+        if (channel_id != 0 && inst->channel_id != channel_id) continue;
+
+        BookConfig book_cfg;
+        book_cfg.max_published_depth = cfg.engine.md_book_depth;
+        book_cfg.smp_mode = smpModeFromName(cfg.engine.smp_mode);
+        if (ic.book_type == "ladder") {
+            book_cfg.backend = BookBackend::TickLadder;
+            book_cfg.tick_mantissa = inst->tickMantissa();
+            book_cfg.ladder_ticks = static_cast<std::size_t>(ic.ladder_ticks);
+        }
+        engine->addInstrument(ic.security_id, book_cfg);
+    }
+    // Spreads and their legs share a channel (validated), hence a shard
+    for (const auto& inst : instruments.getAllInstruments()) {
+        if (!inst.isSpread()) continue;
+        if (channel_id != 0 && inst.channel_id != channel_id) continue;
+        engine->addSpread(inst.security_id, inst.front_leg_id, inst.back_leg_id);
+    }
+    return engine;
+}
+
 // ---------------------------------------------------------------------------
 // Book snapshot provider for market data snapshot cycler
 // ---------------------------------------------------------------------------
+// Books are copied by their own engine thread (see BookSnapshotSource)
 static SnapshotCycler::BookSnapshotProvider makeBookSnapshotProvider(
-        FullMatchingEngine& engine) {
-    return [&engine](SecurityId sec_id,
+        std::vector<BookSnapshotSource*> sources) {
+    return [sources = std::move(sources)](SecurityId sec_id,
                      std::vector<std::pair<Price, Quantity>>& bids,
                      std::vector<std::pair<Price, Quantity>>& asks,
                      std::vector<int>& bid_counts,
                      std::vector<int>& ask_counts) {
-        const OrderBook* book = engine.getOrderBook(sec_id);
-        if (!book) return;
-
-        bids.clear();
-        asks.clear();
-        bid_counts.clear();
-        ask_counts.clear();
-
-        for (auto& [price, level] : book->bidLevels()) {
-            bids.emplace_back(price, level.total_quantity);
-            bid_counts.push_back(level.order_count);
-        }
-        for (auto& [price, level] : book->askLevels()) {
-            asks.emplace_back(price, level.total_quantity);
-            ask_counts.push_back(level.order_count);
+        BookSnapshotSource::Image image;
+        for (BookSnapshotSource* source : sources) {
+            if (!source->hasBook(sec_id)) continue;
+            if (!source->request(sec_id, image)) {
+                spdlog::warn("Snapshot of security {} timed out", sec_id);
+                return;
+            }
+            break;
         }
+
+        bids = std::move(image.bids);
+        asks = std::move(image.asks);
+        bid_counts = std::move(image.bid_counts);
+        ask_counts = std::move(image.ask_counts);
     };
 }
 
+// ---------------------------------------------------------------------------
+// One log line per instrument, command type and stage with latency data
+// ---------------------------------------------------------------------------
+static void logLatency(spdlog::logger& logger, const InstrumentManager& instrument_mgr,
+                       std::size_t shard_idx, const LatencyRecorder& latency) {
+    const double nanos_per_tick = Clock::nanosPerTick();
+    latency.forEach([&](SecurityId sec_id, EngineCommand::Type type, LatencyStage stage,
+                        const LatencyHistogram& histogram) {
+        const Instrument* inst = instrument_mgr.findBySecurityId(sec_id);
+        logger.info("Latency shard {} {} {} {}: {}", shard_idx,
+                    inst ? inst->symbol : (sec_id == 0 ? "*" : std::to_string(sec_id)),
+                    commandTypeName(type), latencyStageName(stage),
+                    formatLatency(histogram, nanos_per_tick));
+    });
+}
+
 // ---------------------------------------------------------------------------
 // Main
 // ---------------------------------------------------------------------------
@@ -189,43 +257,177 @@ int main(int argc, char* argv[]) {
                                         SecurityTradingStatus::PreOpen);
     }
 
-    // 5. Create matching engine based on mode
-    std::unique_ptr<IMatchingEngine> engine;
-    FullMatchingEngine* full_engine_ptr = nullptr;
+    // 5. Create matching engine(s) based on mode. With shard_by_channel each
+    //    MDP channel gets its own engine, books and engine thread; otherwise a
+    //    single shard (channel 0) owns every book.
+    struct EngineShard {
+        int channel_id = 0;
+        std::unique_ptr<IMatchingEngine> engine;
+        FullMatchingEngine* full_engine = nullptr;
+        std::unique_ptr<LiquidityProvider> liquidity;
+        std::unique_ptr<BookSnapshotSource> snapshots;   // for the snapshot cycler
+    };
+    std::vector<EngineShard> shards;
 
-    if (cfg.engine.mode == "full_matching") {
-        auto full_engine = std::make_unique<FullMatchingEngine>();
-        for (auto& inst : instrument_mgr.getAllInstruments()) {
-            full_engine->addInstrument(inst.security_id);
-        }
-        full_engine_ptr = full_engine.get();
-        engine = std::move(full_engine);
-        logger->info("Created Full Matching Engine with {} order books",
-                     instrument_mgr.getAllInstruments().size());
-    } else if (cfg.engine.mode == "synthetic") {
+    if (cfg.engine.mode == "synthetic") {
         // Synthetic engine is optional -- if not linked, fall back to full matching
         logger->warn("Synthetic engine mode requested but not yet available; "
                      "falling back to full_matching mode");
         cfg.engine.mode = "full_matching";
-        auto full_engine = std::make_unique<FullMatchingEngine>();
-        for (auto& inst : instrument_mgr.getAllInstruments()) {
-            full_engine->addInstrument(inst.security_id);
-        }
-        full_engine_ptr = full_engine.get();
-        engine = std::move(full_engine);
-    } else {
+    }
+    if (cfg.engine.mode != "full_matching") {
         logger->error("Unknown engine mode: {}", cfg.engine.mode);
         return EXIT_FAILURE;
     }
 
+    if (cfg.engine.shard_by_channel && cfg.channels.size() > 1) {
+        for (const auto& ch : cfg.channels) {
+            auto full_engine = createFullMatchingEngine(
+                cfg, instrument_mgr, ch.channel_id, static_cast<uint8_t>(shards.size()));
+            FullMatchingEngine* ptr = full_engine.get();
+            shards.push_back({ch.channel_id, std::move(full_engine), ptr, nullptr, nullptr});
+        }
+        logger->info("Created {} Full Matching Engine shards (one per channel)",
+                     shards.size());
+    } else {
+        auto full_engine = createFullMatchingEngine(cfg, instrument_mgr);
+        FullMatchingEngine* ptr = full_engine.get();
+        shards.push_back({0, std::move(full_engine), ptr, nullptr, nullptr});
+        logger->info("Created Full Matching Engine with {} order books",
+                     instrument_mgr.getAllInstruments().size());
+    }
+    const bool sharded = shards.size() > 1;
+
     // 6. Create FIXP session manager
     SessionManager session_mgr(cfg.session.max_sessions);
     logger->info("Session manager created (max sessions: {})",
                  cfg.session.max_sessions);
 
     // 7. Create order entry gateway
-    OrderEntryGateway gateway(instrument_mgr, cfg.risk);
-    logger->info("Order entry gateway created");
+    OrderEntryGateway gateway(instrument_mgr, cfg.risk, cfg.engine);
+
+    // Engine threads send exec reports; with the "reject" queue policy IO
+    // threads send throttle rejects too, so sends are serialized whenever
+    // more than one thread can make them
+    std::mutex session_send_mutex;
+    const bool serialize_sends = sharded || cfg.engine.queue_full_policy == "reject";
+    gateway.setThrottleHandler([&](OrderResponse&& resp) {
+        std::lock_guard<std::mutex> lock(session_send_mutex);
+        if (auto session = session_mgr.findSession(resp.session_uuid)) {
+            session->sendApplicationMessage(resp.sbe_message.data(), resp.sbe_message.size());
+        }
+    });
+    if (sharded) {
+        std::unordered_map<SecurityId, std::size_t> shard_by_security;
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            for (const Instrument* inst :
+                     instrument_mgr.getInstrumentsByChannel(shards[i].channel_id)) {
+                shard_by_security[inst->security_id] = i;
+            }
+        }
+        gateway.configureShards(shards.size(), std::move(shard_by_security));
+    }
+    gateway.configureIoLanes(static_cast<std::size_t>(cfg.network.io_threads));
+    logger->info("Order entry gateway created ({} shard(s) x {} IO lane(s) of {}, {} when full)",
+                 gateway.shardCount(), cfg.network.io_threads,
+                 cfg.engine.command_queue_capacity, cfg.engine.queue_full_policy);
+
+    // Warm start: put the last checkpoint's books, counters and positions back
+    if (cfg.checkpoint.enabled && cfg.checkpoint.load_on_start) {
+        if (!std::filesystem::exists(cfg.checkpoint.path)) {
+            logger->info("No checkpoint at {}; starting with empty books", cfg.checkpoint.path);
+        } else {
+            auto load_start = std::chrono::steady_clock::now();
+            checkpoint::Checkpoint ckpt;
+            std::string error;
+            if (!checkpoint::loadCheckpoint(cfg.checkpoint.path, ckpt, error)) {
+                logger->error("Cannot load checkpoint: {}", error);
+                return EXIT_FAILURE;
+            }
+            if (ckpt.engines.size() != shards.size()) {
+                logger->error("Checkpoint {} has {} engine shard(s), configured {}",
+                              cfg.checkpoint.path, ckpt.engines.size(), shards.size());
+                return EXIT_FAILURE;
+            }
+            std::size_t orders = 0;
+            for (std::size_t i = 0; i < shards.size(); ++i) {
+                if (!shards[i].full_engine->restore(ckpt.engines[i])) {
+                    logger->error("Checkpoint {} does not fit engine shard {}'s books",
+                                  cfg.checkpoint.path, i);
+                    return EXIT_FAILURE;
+                }
+                gateway.restoreRisk(i, ckpt.engines[i], ckpt.positions);
+                orders += ckpt.engines[i].orders.size();
+            }
+            session_mgr.setNextUuid(ckpt.next_session_uuid);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - load_start).count();
+            logger->info("Restored checkpoint {}: {} resting orders, {} positions in {} ms",
+                         cfg.checkpoint.path, orders, ckpt.positions.size(), ms);
+        }
+    }
+
+    // Journal every command each engine shard runs, for offline replay
+    std::vector<std::unique_ptr<journal::JournalWriter>> journals;
+    if (cfg.journal.enabled) {
+        std::error_code ec;
+        std::filesystem::create_directories(cfg.journal.path, ec);
+        if (ec) {
+            logger->error("Cannot create journal directory {}: {}", cfg.journal.path,
+                          ec.message());
+            return EXIT_FAILURE;
+        }
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            auto path = std::filesystem::path(cfg.journal.path) /
+                        ("shard-" + std::to_string(i) + ".journal");
+            auto writer = std::make_unique<journal::JournalWriter>(
+                path.string(), shards[i].full_engine->layout(),
+                static_cast<std::size_t>(cfg.journal.queue_capacity));
+            if (!writer->open()) {
+                logger->error("Cannot open journal {}", path.string());
+                return EXIT_FAILURE;
+            }
+            writer->start(cfg.journal.cpu);
+            gateway.attachJournal(i, writer.get());
+            journals.push_back(std::move(writer));
+        }
+        logger->info("Journaling engine commands to {} ({} file(s))", cfg.journal.path,
+                     journals.size());
+    }
+
+    // Seed books with the built-in market maker, on the shard owning each
+    // quoted instrument
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        auto provider = std::make_unique<LiquidityProvider>(i + 1);
+        for (const auto& ic : cfg.instruments) {
+            if (!ic.liquidity.enabled) continue;
+            if (shards[i].channel_id != 0 && ic.channel_id != shards[i].channel_id) continue;
+            const Instrument* inst = instrument_mgr.findBySymbol(ic.symbol);
+            if (!inst) continue;
+            LiquidityParams params;
+            params.reference = inst->roundToTick(Price::fromDouble(ic.liquidity.reference_price));
+            params.tick_mantissa = inst->tickMantissa();
+            params.depth = ic.liquidity.depth;
+            params.spread_ticks = ic.liquidity.spread_ticks;
+            params.level_ticks = ic.liquidity.level_ticks;
+            params.qty = ic.liquidity.qty;
+            params.requote_ns = static_cast<uint64_t>(ic.liquidity.requote_ms) * 1'000'000;
+            params.walk_ticks = ic.liquidity.walk_ticks;
+            provider->addInstrument(inst->security_id, params);
+            logger->info("Liquidity provider quoting {} around {} ({} levels a side, every {} ms)",
+                         ic.symbol, ic.liquidity.reference_price, params.depth,
+                         ic.liquidity.requote_ms);
+        }
+        if (provider->instrumentCount() == 0) continue;
+        gateway.attachLiquidity(i, provider.get());
+        shards[i].liquidity = std::move(provider);
+    }
+
+    if (cfg.latency.enabled) {
+        for (std::size_t i = 0; i < shards.size(); ++i) gateway.enableLatency(i);
+        logger->info("Recording engine latency ({} ns per tick), reported every {} s",
+                     Clock::nanosPerTick(), cfg.latency.report_interval_s);
+    }
 
     // 8. Create network layer
     IoContextPool io_pool(cfg.network.io_threads);
@@ -241,10 +443,17 @@ int main(int argc, char* argv[]) {
     boost::asio::io_context md_io_ctx;
     MarketDataPublisher md_publisher(cfg.channels, instrument_mgr, md_io_ctx);
 
-    // Set up book snapshot provider if we have a full matching engine
-    if (full_engine_ptr) {
-        md_publisher.setBookSnapshotProvider(
-            makeBookSnapshotProvider(*full_engine_ptr));
+    // Set up book snapshot provider over every engine shard
+    {
+        std::vector<BookSnapshotSource*> sources;
+        for (auto& shard : shards) {
+            if (!shard.full_engine) continue;
+            shard.snapshots = std::make_unique<BookSnapshotSource>(*shard.full_engine);
+            sources.push_back(shard.snapshots.get());
+        }
+        if (!sources.empty()) {
+            md_publisher.setBookSnapshotProvider(makeBookSnapshotProvider(std::move(sources)));
+        }
     }
 
     // 10. Wire TCP connections to FIXP sessions
@@ -256,10 +465,13 @@ int main(int argc, char* argv[]) {
             conn->send(reinterpret_cast<const uint8_t*>(data), len);
         };
 
-        // AppMessageCallback: session -> gateway
-        AppMessageCallback app_cb = [&gateway](uint64_t uuid, uint16_t templateId,
-                                               const char* data, size_t len) {
-            gateway.onApplicationMessage(uuid, templateId, data, len);
+        // AppMessageCallback: session -> gateway. The session's order-rate
+        // bucket lives in the callback, which only runs on this connection's
+        // IO thread.
+        AppMessageCallback app_cb = [&gateway, rate_limit = gateway.makeRateLimit()](
+                                        uint64_t uuid, uint16_t templateId,
+                                        const char* data, size_t len) mutable {
+            gateway.onApplicationMessage(uuid, templateId, data, len, rate_limit);
         };
 
         auto session = session_mgr.createSession(send_cb, app_cb);
@@ -292,7 +504,7 @@ int main(int argc, char* argv[]) {
                 }
             },
             // on_disconnect: clean up session
-            [&session_mgr, session_uuid, logger](TcpConnection::Ptr conn) {
+            [&session_mgr, &gateway, &cfg, session_uuid, logger](TcpConnection::Ptr conn) {
                 logger->info("TCP disconnect from {} (session UUID={})",
                              conn->remote_endpoint_str(), session_uuid);
                 auto sess = session_mgr.findSession(session_uuid);
@@ -300,6 +512,11 @@ int main(int argc, char* argv[]) {
                     sess->terminate();
                 }
                 session_mgr.removeSession(session_uuid);
+                // The engine threads pull the session's orders; their exec
+                // reports find no session and are dropped
+                if (cfg.session.cancel_on_disconnect) {
+                    gateway.onSessionDisconnected(session_uuid);
+                }
             }
         );
     });
@@ -315,6 +532,7 @@ int main(int argc, char* argv[]) {
     printBanner(cfg, instrument_mgr);
 
     // 13. Start IO context pool (network threads)
+    io_pool.setCpuAffinity(cfg.cpu_affinity.io);
     io_pool.start();
     logger->info("IO context pool started ({} threads)", cfg.network.io_threads);
 
@@ -326,11 +544,14 @@ int main(int argc, char* argv[]) {
     });
 
     // 14. Start market data publisher background threads
-    md_publisher.start();
+    md_publisher.start(cfg.cpu_affinity.market_data);
     logger->info("Market data publisher started");
 
     // Run md_io_ctx in a background thread
-    std::thread md_io_thread([&md_io_ctx]() {
+    std::thread md_io_thread([&md_io_ctx, &cfg, logger]() {
+        if (!pinCurrentThread(cfg.cpu_affinity.market_data)) {
+            logger->warn("MD io thread: could not pin to CPU {}", cfg.cpu_affinity.market_data);
+        }
         boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
             guard = boost::asio::make_work_guard(md_io_ctx);
         md_io_ctx.run();
@@ -343,40 +564,82 @@ int main(int argc, char* argv[]) {
     }
     logger->info("All instruments opened for trading");
 
-    // 16. Engine thread (single-threaded hot path)
-    std::thread engine_thread([&]() {
-        logger->info("Engine thread started");
+    // 16. Engine threads: one single-threaded hot path per shard. Shards
+    //     share no books; only session sends need serializing between them.
+    std::vector<std::thread> engine_threads;
+    for (std::size_t shard_idx = 0; shard_idx < shards.size(); ++shard_idx) {
+        engine_threads.emplace_back([&, shard_idx]() {
+            EngineShard& shard = shards[shard_idx];
+            const auto& engine_cpus = cfg.cpu_affinity.engine;
+            int cpu = shard_idx < engine_cpus.size() ? engine_cpus[shard_idx] : -1;
+            if (!pinCurrentThread(cpu)) {
+                logger->warn("Engine thread {}: could not pin to CPU {}", shard_idx, cpu);
+            }
+            logger->info("Engine thread {} started (channel {}, idle strategy {})",
+                         shard_idx, shard.channel_id, cfg.engine.idle_strategy);
+
+            // Reused every iteration so the hot loop does not reallocate
+            EventSink md_events;
+            IdleStrategy idle(*idleModeFromName(cfg.engine.idle_strategy),
+                              cfg.engine.idle_spin_count,
+                              std::chrono::microseconds(cfg.engine.idle_sleep_us));
+
+            // Periodic latency report, written from here so the histograms
+            // stay engine-thread only
+            const LatencyRecorder* latency = gateway.latency(shard_idx);
+            const uint64_t report_ns =
+                static_cast<uint64_t>(cfg.latency.report_interval_s) * 1'000'000'000ULL;
+            uint64_t next_report = Clock::steadyNanos() + report_ns;
+
+            while (g_running.load(std::memory_order_relaxed)) {
+                // Drain this shard's commands from gateway, run through engine
+                md_events.clear();
+                auto responses = gateway.processCommands(*shard.engine, &md_events,
+                                                         shard_idx);
+
+                // Route responses back to FIXP sessions
+                if (!responses.empty()) {
+                    std::unique_lock<std::mutex> lock(session_send_mutex, std::defer_lock);
+                    if (serialize_sends) lock.lock();
+                    for (auto& resp : responses) {
+                        auto session = session_mgr.findSession(resp.session_uuid);
+                        if (session) {
+                            session->sendApplicationMessage(resp.sbe_message.data(),
+                                                            resp.sbe_message.size());
+                        }
+                    }
+                }
 
-        while (g_running.load(std::memory_order_relaxed)) {
-            // Drain commands from gateway, run through engine
-            std::vector<EngineEvent> md_events;
-            auto responses = gateway.processCommands(*engine, &md_events);
-
-            // Route responses back to FIXP sessions
-            for (auto& resp : responses) {
-                auto session = session_mgr.findSession(resp.session_uuid);
-                if (session) {
-                    session->sendApplicationMessage(resp.sbe_message.data(),
-                                                    resp.sbe_message.size());
+                // Publish market data for all engine events (BookUpdate, OrderFilled, etc.)
+                if (!md_events.empty()) {
+                    if (sharded) {
+                        md_publisher.publishChannelEvents(shard.channel_id, md_events.events());
+                    } else {
+                        md_publisher.publishEvents(md_events.events());
+                    }
                 }
-            }
 
-            // Publish market data for all engine events (BookUpdate, OrderFilled, etc.)
-            if (!md_events.empty()) {
-                md_publisher.publishEvents(md_events);
-            }
+                // Copy a book for the snapshot cycler if it is waiting on one
+                if (shard.snapshots) shard.snapshots->serve();
+
+                if (latency && report_ns != 0 && Clock::steadyNanos() >= next_report) {
+                    logLatency(*logger, instrument_mgr, shard_idx, *latency);
+                    next_report += report_ns;
+                }
 
-            // Brief sleep if no work to avoid busy spin
-            if (responses.empty()) {
-                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                // Back off per the configured idle strategy when there was no work
+                idle.idle(!responses.empty() || !md_events.empty());
             }
-        }
 
-        logger->info("Engine thread stopping");
-    });
+            logger->info("Engine thread {} stopping", shard_idx);
+        });
+    }
 
     // 17. Session keepalive timer thread
     std::thread timer_thread([&]() {
+        if (!pinCurrentThread(cfg.cpu_affinity.timer)) {
+            logger->warn("Timer thread: could not pin to CPU {}", cfg.cpu_affinity.timer);
+        }
         while (g_running.load(std::memory_order_relaxed)) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
             session_mgr.onTimerTick();
@@ -407,11 +670,67 @@ int main(int argc, char* argv[]) {
     logger->info("All instruments closed");
 
     // c. Stop engine thread
-    // g_running is already false, engine_thread will exit its loop
-    if (engine_thread.joinable()) {
-        engine_thread.join();
+    // g_running is already false, engine threads will exit their loops.
+    // IO threads still run until step f: keep them from waiting on full rings.
+    gateway.stop();
+    for (auto& engine_thread : engine_threads) {
+        if (engine_thread.joinable()) {
+            engine_thread.join();
+        }
+    }
+    for (auto& shard : shards) {
+        if (shard.snapshots) shard.snapshots->close();
     }
     logger->info("Engine thread stopped");
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        const auto& counts = gateway.laneCounts(i);
+        std::string per_lane;
+        for (std::size_t lane = 0; lane < counts.size(); ++lane) {
+            per_lane += (lane + 1 < counts.size() ? " io" + std::to_string(lane) : " other") +
+                        "=" + std::to_string(counts[lane]);
+        }
+        logger->info("Engine shard {} commands drained:{}", i, per_lane);
+    }
+    if (gateway.throttledCount() > 0) {
+        logger->warn("{} commands throttled on full engine queues", gateway.throttledCount());
+    }
+
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        if (const LatencyRecorder* latency = gateway.latency(i)) {
+            logLatency(*logger, instrument_mgr, i, *latency);
+        }
+    }
+
+    // Engines are idle: checkpoint them for the next start
+    if (cfg.checkpoint.enabled && cfg.checkpoint.save_on_shutdown) {
+        checkpoint::Checkpoint ckpt;
+        std::size_t orders = 0;
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            ckpt.engines.push_back(shards[i].full_engine->snapshot());
+            orders += ckpt.engines.back().orders.size();
+            auto positions = gateway.riskStage(i).positions();
+            ckpt.positions.insert(ckpt.positions.end(), positions.begin(), positions.end());
+        }
+        ckpt.next_session_uuid = session_mgr.nextUuid();
+
+        std::error_code ec;
+        auto dir = std::filesystem::path(cfg.checkpoint.path).parent_path();
+        if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+        std::string error;
+        if (checkpoint::saveCheckpoint(cfg.checkpoint.path, ckpt, error)) {
+            logger->info("Checkpoint saved to {} ({} resting orders)", cfg.checkpoint.path,
+                         orders);
+        } else {
+            logger->error("Cannot save checkpoint: {}", error);
+        }
+    }
+
+    // Flush and close the journals
+    for (auto& writer : journals) {
+        writer->close();
+        logger->info("Journal {}: {} records, {} producer stalls", writer->path(),
+                     writer->recordsWritten(), writer->producerStalls());
+    }
 
     // d. Stop timer thread
     if (timer_thread.joinable()) {
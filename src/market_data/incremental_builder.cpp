@@ -12,12 +12,13 @@ std::vector<uint8_t> IncrementalBuilder::buildBookRefresh(
     const std::vector<EngineEvent>& book_updates,
     Timestamp transact_time) {
 
-    sbe::MDIncrementalRefreshBook46 msg;
-    msg.transactTime = transact_time;
-    msg.matchEventIndicator =
-        static_cast<uint8_t>(MatchEventIndicator::LastQuoteMsg) |
-        static_cast<uint8_t>(MatchEventIndicator::EndOfEvent);
+    // One message per instrument, in the order instruments first appear;
+    // each keeps its updates in event order. A mass cancel's updates thus
+    // reach a subscriber as one message per book rather than interleaved.
+    std::vector<std::vector<sbe::MDIncrementalRefreshBook46::Entry>> buckets;
+    std::unordered_map<SecurityId, std::size_t> bucket_of;
 
+    bool has_implied = false;
     for (const auto& ev : book_updates) {
         const auto* bu = std::get_if<BookUpdate>(&ev);
         if (!bu) continue;
@@ -30,16 +31,50 @@ std::vector<uint8_t> IncrementalBuilder::buildBookRefresh(
         entry.numberOfOrders = bu->new_order_count;
         entry.mdPriceLevel = static_cast<uint8_t>(bu->price_level_index);
         entry.mdUpdateAction = static_cast<uint8_t>(bu->update_action);
-        entry.mdEntryType = (bu->side == Side::Buy)
-                                ? static_cast<char>(MDEntryType::Bid)
-                                : static_cast<char>(MDEntryType::Offer);
-        msg.entries.push_back(entry);
+        if (bu->implied) {
+            entry.mdEntryType = (bu->side == Side::Buy)
+                                    ? static_cast<char>(MDEntryType::ImpliedBid)
+                                    : static_cast<char>(MDEntryType::ImpliedOffer);
+            has_implied = true;
+        } else {
+            entry.mdEntryType = (bu->side == Side::Buy)
+                                    ? static_cast<char>(MDEntryType::Bid)
+                                    : static_cast<char>(MDEntryType::Offer);
+        }
+
+        auto [it, inserted] = bucket_of.try_emplace(bu->security_id, buckets.size());
+        if (inserted) buckets.emplace_back();
+        buckets[it->second].push_back(entry);
     }
 
-    if (msg.entries.empty()) return {};
+    if (buckets.empty()) return {};
 
-    std::vector<uint8_t> buf(msg.encodedLength());
-    msg.encode(reinterpret_cast<char*>(buf.data()), 0);
+    // The entry group count is a uint8, so a longer bucket spans messages.
+    // Only the last message closes the event.
+    constexpr std::size_t MAX_ENTRIES = 255;
+    std::vector<uint8_t> buf;
+    sbe::MDIncrementalRefreshBook46 msg;
+    msg.transactTime = transact_time;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        const auto& entries = buckets[b];
+        for (std::size_t first = 0; first < entries.size(); first += MAX_ENTRIES) {
+            std::size_t last = std::min(first + MAX_ENTRIES, entries.size());
+            msg.entries.assign(entries.begin() + first, entries.begin() + last);
+            msg.matchEventIndicator = 0;
+            if (b + 1 == buckets.size() && last == entries.size()) {
+                msg.matchEventIndicator =
+                    static_cast<uint8_t>(MatchEventIndicator::LastQuoteMsg) |
+                    static_cast<uint8_t>(MatchEventIndicator::EndOfEvent);
+                if (has_implied) {
+                    msg.matchEventIndicator |= static_cast<uint8_t>(MatchEventIndicator::LastImpliedMsg);
+                }
+            }
+
+            std::size_t offset = buf.size();
+            buf.resize(offset + msg.encodedLength());
+            msg.encode(reinterpret_cast<char*>(buf.data()), offset);
+        }
+    }
     return buf;
 }
 
@@ -11,8 +11,9 @@ namespace cme::sim::market_data {
 /// Builds MDP 3.0 incremental refresh messages from engine events.
 class IncrementalBuilder {
 public:
-    /// Build MDIncrementalRefreshBook46 from BookUpdate events.
-    /// Returns SBE-encoded message bytes (without packet header).
+    /// Build MDIncrementalRefreshBook46 messages from BookUpdate events, one
+    /// per instrument (split further past 255 entries). Returns the
+    /// SBE-encoded messages back-to-back (without packet header).
     std::vector<uint8_t> buildBookRefresh(
         const std::vector<EngineEvent>& book_updates,
         Timestamp transact_time);
@@ -1,4 +1,5 @@
 #include "market_data/market_data_publisher.h"
+#include "common/cpu_affinity.h"
 #include <spdlog/spdlog.h>
 #include <chrono>
 
@@ -20,6 +21,7 @@ MarketDataPublisher::MarketDataPublisher(
         auto pub = std::make_unique<ChannelPublisher>(
             ch_cfg.channel_id, ch_cfg, io_ctx);
         channel_publishers_[ch_cfg.channel_id] = std::move(pub);
+        channel_events_[ch_cfg.channel_id];
     }
 
     spdlog::info("MarketDataPublisher created with {} channels, {} instruments",
@@ -35,8 +37,11 @@ void MarketDataPublisher::publishEvents(const std::vector<EngineEvent>& events)
 
     Timestamp ts = FeedSender::now();
 
-    // Group events by channel
-    std::unordered_map<int, std::vector<EngineEvent>> by_channel;
+    // Group events by channel. The per-channel buffers are reused across
+    // calls; events are trivially copyable, so this is a plain copy.
+    for (auto& [channel_id, ch_events] : channel_events_) {
+        ch_events.clear();
+    }
 
     for (const auto& ev : events) {
         SecurityId sec_id = 0;
@@ -52,13 +57,15 @@ void MarketDataPublisher::publishEvents(const std::vector<EngineEvent>& events)
         }
 
         int channel = getChannelForSecurity(sec_id);
-        if (channel != 0) {
-            by_channel[channel].push_back(ev);
+        auto buf = channel_events_.find(channel);
+        if (buf != channel_events_.end()) {
+            buf->second.push_back(ev);
         }
     }
 
     // Publish each channel's events
-    for (auto& [channel_id, ch_events] : by_channel) {
+    for (auto& [channel_id, ch_events] : channel_events_) {
+        if (ch_events.empty()) continue;
         auto it = channel_publishers_.find(channel_id);
         if (it != channel_publishers_.end()) {
             it->second->publishIncrementalUpdates(ch_events, ts);
@@ -66,7 +73,16 @@ void MarketDataPublisher::publishEvents(const std::vector<EngineEvent>& events)
     }
 }
 
-void MarketDataPublisher::start() {
+void MarketDataPublisher::publishChannelEvents(int channel_id,
+                                               const std::vector<EngineEvent>& events) {
+    if (events.empty()) return;
+    auto it = channel_publishers_.find(channel_id);
+    if (it != channel_publishers_.end()) {
+        it->second->publishIncrementalUpdates(events, FeedSender::now());
+    }
+}
+
+void MarketDataPublisher::start(int cpu) {
     if (running_.exchange(true)) return;
 
     // Initialize snapshot cyclers for each channel
@@ -79,12 +95,12 @@ void MarketDataPublisher::start() {
                 sec_ids.push_back(inst->security_id);
             }
             pub->initSnapshotCycler(sec_ids, book_provider_);
-            pub->snapshotCycler().start();
+            pub->snapshotCycler().start(cpu);
         }
     }
 
     // Start instrument definition replay thread
-    instdef_thread_ = std::thread(&MarketDataPublisher::instdefReplayLoop, this);
+    instdef_thread_ = std::thread(&MarketDataPublisher::instdefReplayLoop, this, cpu);
 
     spdlog::info("MarketDataPublisher started");
 }
@@ -122,7 +138,10 @@ int MarketDataPublisher::getChannelForSecurity(SecurityId sec_id) const {
     return (it != security_to_channel_.end()) ? it->second : 0;
 }
 
-void MarketDataPublisher::instdefReplayLoop() {
+void MarketDataPublisher::instdefReplayLoop(int cpu) {
+    if (!pinCurrentThread(cpu)) {
+        spdlog::warn("Instrument definition replay: could not pin to CPU {}", cpu);
+    }
     spdlog::info("Instrument definition replay thread started");
 
     while (running_.load(std::memory_order_relaxed)) {
@@ -29,8 +29,14 @@ public:
     /// Process engine events and publish to appropriate channel feeds.
     void publishEvents(const std::vector<EngineEvent>& events);
 
-    /// Start background threads (snapshot cycling, instrument def replay).
-    void start();
+    /// Publish events that all belong to one channel, skipping the
+    /// security-to-channel grouping. Used by per-channel engine shards;
+    /// each channel must only be fed from one thread.
+    void publishChannelEvents(int channel_id, const std::vector<EngineEvent>& events);
+
+    /// Start background threads (snapshot cycling, instrument def replay),
+    /// pinned to @p cpu unless it is negative.
+    void start(int cpu = -1);
 
     /// Stop all background threads.
     void stop();
@@ -44,6 +50,8 @@ public:
 private:
     std::unordered_map<int, std::unique_ptr<ChannelPublisher>> channel_publishers_;
     std::unordered_map<SecurityId, int> security_to_channel_;
+    // Per-channel staging for publishEvents (engine thread only)
+    std::unordered_map<int, std::vector<EngineEvent>> channel_events_;
     const InstrumentManager& instrument_mgr_;
 
     SnapshotCycler::BookSnapshotProvider book_provider_;
@@ -51,7 +59,7 @@ private:
     std::thread instdef_thread_;
 
     int getChannelForSecurity(SecurityId sec_id) const;
-    void instdefReplayLoop();
+    void instdefReplayLoop(int cpu);
 };
 
 } // namespace cme::sim::market_data
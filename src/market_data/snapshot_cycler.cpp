@@ -1,4 +1,5 @@
 #include "market_data/snapshot_cycler.h"
+#include "common/cpu_affinity.h"
 #include <spdlog/spdlog.h>
 #include <chrono>
 
@@ -42,9 +43,9 @@ void SnapshotCycler::runCycle(uint32_t last_incremental_seq_num) {
     }
 }
 
-void SnapshotCycler::start() {
+void SnapshotCycler::start(int cpu) {
     if (running_.exchange(true)) return; // already running
-    thread_ = std::thread(&SnapshotCycler::run, this);
+    thread_ = std::thread(&SnapshotCycler::run, this, cpu);
     spdlog::info("SnapshotCycler started for {} instruments", instruments_.size());
 }
 
@@ -56,7 +57,10 @@ void SnapshotCycler::stop() {
     spdlog::info("SnapshotCycler stopped");
 }
 
-void SnapshotCycler::run() {
+void SnapshotCycler::run(int cpu) {
+    if (!pinCurrentThread(cpu)) {
+        spdlog::warn("SnapshotCycler: could not pin to CPU {}", cpu);
+    }
     while (running_.load(std::memory_order_relaxed)) {
         uint32_t seq = last_incr_seq_.load(std::memory_order_relaxed);
         runCycle(seq);
@@ -34,8 +34,9 @@ public:
     /// the background thread.
     void runCycle(uint32_t last_incremental_seq_num);
 
-    /// Start continuous snapshot cycling on a background thread.
-    void start();
+    /// Start continuous snapshot cycling on a background thread, pinned to
+    /// @p cpu unless it is negative.
+    void start(int cpu = -1);
 
     /// Stop the background thread.
     void stop();
@@ -60,7 +61,7 @@ private:
     std::thread thread_;
     uint32_t cycle_count_ = 0;
 
-    void run();
+    void run(int cpu);
 };
 
 } // namespace cme::sim::market_data
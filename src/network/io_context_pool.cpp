@@ -1,4 +1,6 @@
 #include "network/io_context_pool.h"
+#include "common/cpu_affinity.h"
+#include "common/io_thread.h"
 
 #include <spdlog/spdlog.h>
 #include <stdexcept>
@@ -36,7 +38,12 @@ void IoContextPool::start() {
 
     threads_.reserve(io_contexts_.size());
     for (std::size_t i = 0; i < io_contexts_.size(); ++i) {
-        threads_.emplace_back([this, i] {
+        int cpu = i < cpus_.size() ? cpus_[i] : -1;
+        threads_.emplace_back([this, i, cpu] {
+            if (!pinCurrentThread(cpu)) {
+                spdlog::warn("IoContext thread {}: could not pin to CPU {}", i, cpu);
+            }
+            setIoThreadIndex(static_cast<int>(i));
             spdlog::debug("IoContext thread {} started", i);
             io_contexts_[i]->run();
             spdlog::debug("IoContext thread {} stopped", i);
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace cme::sim::network {
@@ -21,6 +22,10 @@ public:
     IoContextPool(const IoContextPool&) = delete;
     IoContextPool& operator=(const IoContextPool&) = delete;
 
+    /// Pin thread i to cpus[i] when started (-1 or a missing entry = not
+    /// pinned). Call before start().
+    void setCpuAffinity(std::vector<int> cpus) { cpus_ = std::move(cpus); }
+
     /// Start all threads. Each thread calls io_context::run().
     void start();
 
@@ -38,6 +43,7 @@ private:
     std::vector<std::unique_ptr<boost::asio::io_context>> io_contexts_;
     std::vector<work_guard_t> work_guards_;
     std::vector<std::thread> threads_;
+    std::vector<int> cpus_;
     std::size_t next_io_context_{0};
 };
 
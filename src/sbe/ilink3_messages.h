@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <cstring>
 #include "message_header.h"
+#include "../common/types.h"
 
 namespace cme::sim::sbe {
 
@@ -21,6 +22,41 @@ inline void readFixedString(char* dest, const char* src, size_t len) {
     dest[len] = '\0';
 }
 
+// ClOrdId overloads: copy the fixed field directly, no intermediate buffer
+inline void writeFixedString(char* dest, const ClOrdId& src, size_t len) {
+    src.toWire(dest, len);
+}
+
+inline void readFixedString(ClOrdId& dest, const char* src, size_t len) {
+    dest = ClOrdId::fromWire(src, len);
+}
+
+// Read-only flyweight over a received message. wrap() checks once that the
+// whole fixed block is present; the accessors then read each field straight
+// from the caller's buffer, which must outlive the view.
+template <typename Msg>
+class MessageView {
+public:
+    bool wrap(const char* buffer, size_t len) {
+        if (len < MessageHeader::SIZE + Msg::BLOCK_LENGTH) return false;
+        body_ = buffer + MessageHeader::SIZE;
+        return true;
+    }
+
+protected:
+    template <typename T>
+    T get(size_t offset) const {
+        T value;
+        std::memcpy(&value, body_ + offset, sizeof(T));
+        return value;
+    }
+
+    const char* at(size_t offset) const { return body_ + offset; }
+
+private:
+    const char* body_ = nullptr;
+};
+
 // ============================================================================
 // Negotiate (templateId=500)
 // ============================================================================
@@ -540,6 +576,22 @@ struct NewOrderSingle514 {
     size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
 };
 
+// Zero-copy view of NewOrderSingle514: only the fields the gateway reads
+struct NewOrderSingle514View : MessageView<NewOrderSingle514> {
+    int64_t price() const { return get<int64_t>(0); }
+    uint32_t orderQty() const { return get<uint32_t>(8); }
+    int32_t securityID() const { return get<int32_t>(12); }
+    uint8_t side() const { return get<uint8_t>(16); }
+    uint32_t seqNum() const { return get<uint32_t>(17); }
+    const char* clOrdID() const { return at(41); }          // [20]
+    uint64_t orderRequestID() const { return get<uint64_t>(69); }
+    int64_t stopPx() const { return get<int64_t>(85); }
+    uint32_t minQty() const { return get<uint32_t>(98); }
+    uint32_t displayQty() const { return get<uint32_t>(102); }
+    uint8_t ordType() const { return get<uint8_t>(108); }
+    uint8_t timeInForce() const { return get<uint8_t>(109); }
+};
+
 // ============================================================================
 // OrderCancelReplaceRequest (templateId=515)
 // ============================================================================
@@ -661,6 +713,21 @@ struct OrderCancelReplaceRequest515 {
     size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
 };
 
+// Zero-copy view of OrderCancelReplaceRequest515: only the fields the gateway reads
+struct OrderCancelReplaceRequest515View : MessageView<OrderCancelReplaceRequest515> {
+    int64_t price() const { return get<int64_t>(0); }
+    uint32_t orderQty() const { return get<uint32_t>(8); }
+    int32_t securityID() const { return get<int32_t>(12); }
+    uint8_t side() const { return get<uint8_t>(16); }
+    uint32_t seqNum() const { return get<uint32_t>(17); }
+    const char* clOrdID() const { return at(41); }          // [20]
+    uint64_t orderID() const { return get<uint64_t>(69); }
+    int64_t stopPx() const { return get<int64_t>(77); }
+    uint64_t orderRequestID() const { return get<uint64_t>(85); }
+    uint8_t ordType() const { return get<uint8_t>(116); }
+    uint8_t timeInForce() const { return get<uint8_t>(117); }
+};
+
 // ============================================================================
 // OrderCancelRequest (templateId=516)
 // ============================================================================
@@ -730,6 +797,114 @@ struct OrderCancelRequest516 {
     size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
 };
 
+// Zero-copy view of OrderCancelRequest516: only the fields the gateway reads
+struct OrderCancelRequest516View : MessageView<OrderCancelRequest516> {
+    uint64_t orderID() const { return get<uint64_t>(0); }
+    uint32_t seqNum() const { return get<uint32_t>(17); }
+    const char* clOrdID() const { return at(41); }          // [20]
+    int32_t securityID() const { return get<int32_t>(61); }
+    uint8_t side() const { return get<uint8_t>(65); }
+    uint64_t orderRequestID() const { return get<uint64_t>(66); }
+};
+
+// ============================================================================
+// OrderMassActionRequest (templateId=529)
+// ============================================================================
+struct OrderMassActionRequest529 {
+    static constexpr uint16_t TEMPLATE_ID = 529;
+    //   0  PartyDetailsListReqID(8)
+    //   8  OrderRequestID(8)
+    //  16  ManualOrderIndicator(1)
+    //  17  SeqNum(4)
+    //  21  SenderID[20]
+    //  41  SendingTimeEpoch(8)
+    //  49  SecurityGroup[6]
+    //  55  Location[5]
+    //  60  SecurityID(4)
+    //  64  MassActionScope(1)
+    //  65  MarketSegmentID(1)
+    //  66  MassCancelRequestType(1)
+    //  67  Side(1)
+    //  68  OrdType(1)
+    //  69  TimeInForce(1)
+    //  70  LiquidityFlag(1)
+    static constexpr uint16_t BLOCK_LENGTH = 71;
+
+    static constexpr uint8_t SCOPE_INSTRUMENT = 1;
+    static constexpr uint8_t SCOPE_MARKET_SEGMENT = 9;
+    static constexpr uint8_t SCOPE_INSTRUMENT_GROUP = 10;
+
+    uint64_t partyDetailsListReqID = 0;
+    uint64_t orderRequestID = 0;
+    uint8_t manualOrderIndicator = 0;
+    uint32_t seqNum = 0;
+    char senderID[20]{};
+    uint64_t sendingTimeEpoch = 0;
+    char securityGroup[6]{};
+    char location[5]{};
+    int32_t securityID = 0;
+    uint8_t massActionScope = 0;
+    uint8_t marketSegmentID = 0;
+    uint8_t massCancelRequestType = 0;
+    uint8_t side = 0;                    // 0 = both sides
+    char ordType = 0;
+    uint8_t timeInForce = 0;
+    uint8_t liquidityFlag = 0;
+
+    size_t encode(char* buffer, size_t offset) const {
+        MessageHeader::encodeILink3(buffer + offset, BLOCK_LENGTH, TEMPLATE_ID);
+        char* b = buffer + offset + MessageHeader::SIZE;
+        std::memcpy(b + 0,  &partyDetailsListReqID, 8);
+        std::memcpy(b + 8,  &orderRequestID, 8);
+        std::memcpy(b + 16, &manualOrderIndicator, 1);
+        std::memcpy(b + 17, &seqNum, 4);
+        std::memcpy(b + 21, senderID, 20);
+        std::memcpy(b + 41, &sendingTimeEpoch, 8);
+        std::memcpy(b + 49, securityGroup, 6);
+        std::memcpy(b + 55, location, 5);
+        std::memcpy(b + 60, &securityID, 4);
+        std::memcpy(b + 64, &massActionScope, 1);
+        std::memcpy(b + 65, &marketSegmentID, 1);
+        std::memcpy(b + 66, &massCancelRequestType, 1);
+        std::memcpy(b + 67, &side, 1);
+        std::memcpy(b + 68, &ordType, 1);
+        std::memcpy(b + 69, &timeInForce, 1);
+        std::memcpy(b + 70, &liquidityFlag, 1);
+        return MessageHeader::SIZE + BLOCK_LENGTH;
+    }
+
+    void decode(const char* buffer, size_t offset) {
+        const char* b = buffer + offset + MessageHeader::SIZE;
+        std::memcpy(&partyDetailsListReqID, b + 0, 8);
+        std::memcpy(&orderRequestID, b + 8, 8);
+        std::memcpy(&manualOrderIndicator, b + 16, 1);
+        std::memcpy(&seqNum, b + 17, 4);
+        std::memcpy(senderID, b + 21, 20);
+        std::memcpy(&sendingTimeEpoch, b + 41, 8);
+        std::memcpy(securityGroup, b + 49, 6);
+        std::memcpy(location, b + 55, 5);
+        std::memcpy(&securityID, b + 60, 4);
+        std::memcpy(&massActionScope, b + 64, 1);
+        std::memcpy(&marketSegmentID, b + 65, 1);
+        std::memcpy(&massCancelRequestType, b + 66, 1);
+        std::memcpy(&side, b + 67, 1);
+        std::memcpy(&ordType, b + 68, 1);
+        std::memcpy(&timeInForce, b + 69, 1);
+        std::memcpy(&liquidityFlag, b + 70, 1);
+    }
+
+    size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
+};
+
+// Zero-copy view of OrderMassActionRequest529: only the fields the gateway reads
+struct OrderMassActionRequest529View : MessageView<OrderMassActionRequest529> {
+    uint64_t orderRequestID() const { return get<uint64_t>(8); }
+    uint32_t seqNum() const { return get<uint32_t>(17); }
+    int32_t securityID() const { return get<int32_t>(60); }
+    uint8_t massActionScope() const { return get<uint8_t>(64); }
+    uint8_t side() const { return get<uint8_t>(67); }
+};
+
 // ============================================================================
 // ExecutionReportNew (templateId=522)
 // ============================================================================
@@ -1642,4 +1817,105 @@ struct OrderCancelReject535 {
     size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
 };
 
+// ============================================================================
+// OrderMassActionReport (templateId=562)
+// ============================================================================
+struct OrderMassActionReport562 {
+    static constexpr uint16_t TEMPLATE_ID = 562;
+    //   0  SeqNum(4)
+    //   4  UUID(8)
+    //  12  SenderID[20]
+    //  32  PartyDetailsListReqID(8)
+    //  40  TransactTime(8)
+    //  48  SendingTimeEpoch(8)
+    //  56  OrderRequestID(8)
+    //  64  Location[5]
+    //  69  SecurityGroup[6]
+    //  75  MassActionReportID(8)
+    //  83  SecurityID(4)
+    //  87  MassActionType(1)
+    //  88  MassActionScope(1)
+    //  89  MassActionResponse(1)
+    //  90  TotalAffectedOrders(4)
+    //  94  LastFragment(1)
+    //  95  MassActionRejectReason(1)
+    //  96  Side(1)
+    //  97  ManualOrderIndicator(1)
+    static constexpr uint16_t BLOCK_LENGTH = 98;
+
+    static constexpr uint8_t TYPE_CANCEL = 3;
+    static constexpr uint8_t RESPONSE_REJECTED = 0;
+    static constexpr uint8_t RESPONSE_ACCEPTED = 1;
+
+    uint32_t seqNum = 0;
+    uint64_t uuid = 0;
+    char senderID[20]{};
+    uint64_t partyDetailsListReqID = 0;
+    uint64_t transactTime = 0;
+    uint64_t sendingTimeEpoch = 0;
+    uint64_t orderRequestID = 0;
+    char location[5]{};
+    char securityGroup[6]{};
+    uint64_t massActionReportID = 0;
+    int32_t securityID = 0;
+    uint8_t massActionType = TYPE_CANCEL;
+    uint8_t massActionScope = 0;
+    uint8_t massActionResponse = RESPONSE_ACCEPTED;
+    uint32_t totalAffectedOrders = 0;
+    uint8_t lastFragment = 1;
+    uint8_t massActionRejectReason = 0;
+    uint8_t side = 0;
+    uint8_t manualOrderIndicator = 0;
+
+    size_t encode(char* buffer, size_t offset) const {
+        MessageHeader::encodeILink3(buffer + offset, BLOCK_LENGTH, TEMPLATE_ID);
+        char* b = buffer + offset + MessageHeader::SIZE;
+        std::memcpy(b + 0,  &seqNum, 4);
+        std::memcpy(b + 4,  &uuid, 8);
+        std::memcpy(b + 12, senderID, 20);
+        std::memcpy(b + 32, &partyDetailsListReqID, 8);
+        std::memcpy(b + 40, &transactTime, 8);
+        std::memcpy(b + 48, &sendingTimeEpoch, 8);
+        std::memcpy(b + 56, &orderRequestID, 8);
+        std::memcpy(b + 64, location, 5);
+        std::memcpy(b + 69, securityGroup, 6);
+        std::memcpy(b + 75, &massActionReportID, 8);
+        std::memcpy(b + 83, &securityID, 4);
+        std::memcpy(b + 87, &massActionType, 1);
+        std::memcpy(b + 88, &massActionScope, 1);
+        std::memcpy(b + 89, &massActionResponse, 1);
+        std::memcpy(b + 90, &totalAffectedOrders, 4);
+        std::memcpy(b + 94, &lastFragment, 1);
+        std::memcpy(b + 95, &massActionRejectReason, 1);
+        std::memcpy(b + 96, &side, 1);
+        std::memcpy(b + 97, &manualOrderIndicator, 1);
+        return MessageHeader::SIZE + BLOCK_LENGTH;
+    }
+
+    void decode(const char* buffer, size_t offset) {
+        const char* b = buffer + offset + MessageHeader::SIZE;
+        std::memcpy(&seqNum, b + 0, 4);
+        std::memcpy(&uuid, b + 4, 8);
+        std::memcpy(senderID, b + 12, 20);
+        std::memcpy(&partyDetailsListReqID, b + 32, 8);
+        std::memcpy(&transactTime, b + 40, 8);
+        std::memcpy(&sendingTimeEpoch, b + 48, 8);
+        std::memcpy(&orderRequestID, b + 56, 8);
+        std::memcpy(location, b + 64, 5);
+        std::memcpy(securityGroup, b + 69, 6);
+        std::memcpy(&massActionReportID, b + 75, 8);
+        std::memcpy(&securityID, b + 83, 4);
+        std::memcpy(&massActionType, b + 87, 1);
+        std::memcpy(&massActionScope, b + 88, 1);
+        std::memcpy(&massActionResponse, b + 89, 1);
+        std::memcpy(&totalAffectedOrders, b + 90, 4);
+        std::memcpy(&lastFragment, b + 94, 1);
+        std::memcpy(&massActionRejectReason, b + 95, 1);
+        std::memcpy(&side, b + 96, 1);
+        std::memcpy(&manualOrderIndicator, b + 97, 1);
+    }
+
+    size_t encodedLength() const { return MessageHeader::SIZE + BLOCK_LENGTH; }
+};
+
 } // namespace cme::sim::sbe
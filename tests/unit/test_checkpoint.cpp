@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "checkpoint/checkpoint.h"
+#include "engine/full_matching_engine.h"
+#include "common/types.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace cme::sim;
+
+namespace {
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("test_checkpoint_" + std::to_string(::getpid()) + ".ckpt")).string();
+    }
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    std::string path_;
+};
+
+EngineLayout testLayout() {
+    EngineLayout layout;
+    layout.shard_id = 1;
+    BookConfig ladder;
+    ladder.backend = BookBackend::TickLadder;
+    ladder.tick_mantissa = Price::fromDouble(0.25).mantissa;
+    layout.instruments = {{1, {}}, {2, ladder}, {3, {}}};
+    layout.spreads = {{3, 1, 2}};
+    return layout;
+}
+
+Order limitOrder(SecurityId sec, Side side, double price, Quantity qty, uint64_t session = 100) {
+    Order o;
+    o.security_id = sec;
+    o.session_uuid = session;
+    o.side = side;
+    o.price = Price::fromDouble(price);
+    o.quantity = qty;
+    o.cl_ord_id = "CL";
+    return o;
+}
+
+OrderId acceptedId(const std::vector<EngineEvent>& events) {
+    for (const auto& e : events) {
+        if (auto* a = std::get_if<OrderAccepted>(&e)) return a->order_id;
+    }
+    return 0;
+}
+
+// Price, visible qty and order IDs of every level, best first
+using LevelImage = std::vector<std::tuple<int64_t, Quantity, std::vector<OrderId>>>;
+
+template <typename BookSideT>
+LevelImage levels(const BookSideT& side) {
+    LevelImage out;
+    for (const auto& [price, level] : side) {
+        std::vector<OrderId> ids;
+        for (const Order* order : level) ids.push_back(order->order_id);
+        out.emplace_back(price.mantissa, level.total_quantity, ids);
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+TEST_F(CheckpointTest, RestoredEngineContinuesWhereTheOldOneStopped) {
+    FullMatchingEngine original(testLayout());
+    for (int i = 0; i < 3; ++i) {
+        original.submitOrder(limitOrder(1, Side::Buy, 99.0, 2, 100 + i));
+        original.submitOrder(limitOrder(1, Side::Sell, 101.0 + i, 3, 100 + i));
+        original.submitOrder(limitOrder(2, Side::Sell, 50.0 + 0.25 * i, 4));
+        original.submitOrder(limitOrder(2, Side::Buy, 49.0, 1));
+    }
+    // Trade once so the book has a last price and trade IDs have moved
+    original.submitOrder(limitOrder(1, Side::Sell, 99.0, 1, 200));
+
+    Order iceberg = limitOrder(1, Side::Sell, 101.0, 10);
+    iceberg.display_qty = 2;
+    OrderId iceberg_id = acceptedId(original.submitOrder(iceberg));
+    Order stop = limitOrder(1, Side::Buy, 103.0, 1);
+    stop.order_type = OrderType::StopLimit;
+    stop.stop_price = Price::fromDouble(102.0);
+    OrderId stop_id = acceptedId(original.submitOrder(stop));
+    ASSERT_NE(iceberg_id, 0u);
+    ASSERT_NE(stop_id, 0u);
+
+    checkpoint::Checkpoint saved;
+    saved.engines.push_back(original.snapshot());
+    saved.next_session_uuid = 201;
+    saved.positions = {{100, 1, 1}, {200, 1, -1}};
+    std::string error;
+    ASSERT_TRUE(checkpoint::saveCheckpoint(path_, saved, error)) << error;
+
+    checkpoint::Checkpoint loaded;
+    ASSERT_TRUE(checkpoint::loadCheckpoint(path_, loaded, error)) << error;
+    EXPECT_EQ(loaded.next_session_uuid, 201u);
+    EXPECT_EQ(loaded.positions, saved.positions);
+    ASSERT_EQ(loaded.engines.size(), 1u);
+
+    FullMatchingEngine restored(testLayout());
+    ASSERT_TRUE(restored.restore(loaded.engines[0]));
+    EXPECT_FALSE(restored.restore(loaded.engines[0]));  // already has orders
+    EXPECT_EQ(restored.restingOrderCount(), original.restingOrderCount());
+    EXPECT_EQ(restored.sessionOrderCount(100), original.sessionOrderCount(100));
+
+    // Same levels, quantities and time priority; the ladder book too
+    for (SecurityId sec : {1, 2}) {
+        const OrderBook* a = original.getOrderBook(sec);
+        const OrderBook* b = restored.getOrderBook(sec);
+        EXPECT_EQ(levels(b->bidLevels()), levels(a->bidLevels())) << "book " << sec;
+        EXPECT_EQ(levels(b->askLevels()), levels(a->askLevels())) << "book " << sec;
+        EXPECT_EQ(b->stopOrderCount(), a->stopOrderCount());
+        EXPECT_EQ(b->lastTradePrice(), a->lastTradePrice());
+    }
+    // Implied spread prices come back without being published again
+    const auto& implied = restored.impliedEngine().implied(3, Side::Buy);
+    EXPECT_EQ(implied.count, original.impliedEngine().implied(3, Side::Buy).count);
+    EXPECT_GT(implied.count, 0);
+
+    // From here on both engines do exactly the same: a sweep through the
+    // iceberg electing the stop, then a new order and a cancel by old ID
+    auto sweep = [](FullMatchingEngine& engine) {
+        std::vector<EngineEvent> events = engine.submitOrder(limitOrder(1, Side::Buy, 102.0, 20, 300));
+        auto more = engine.submitOrder(limitOrder(2, Side::Buy, 49.0, 1, 300));
+        events.insert(events.end(), more.begin(), more.end());
+        auto cancel = engine.cancelOrder(OrderPool::makeOrderId(1, 0, 1), 1, 100);
+        events.insert(events.end(), cancel.begin(), cancel.end());
+        return events;
+    };
+    auto expected = sweep(original);
+    auto got = sweep(restored);
+    ASSERT_EQ(got.size(), expected.size());
+    for (std::size_t i = 0; i < got.size(); ++i) {
+        ASSERT_EQ(got[i].index(), expected[i].index()) << "event " << i;
+        if (auto* f = std::get_if<OrderFilled>(&expected[i])) {
+            const auto& g = std::get<OrderFilled>(got[i]);
+            EXPECT_EQ(g.trade_id, f->trade_id);
+            EXPECT_EQ(g.maker_order_id, f->maker_order_id);
+            EXPECT_EQ(g.taker_order_id, f->taker_order_id);
+            EXPECT_EQ(g.trade_price, f->trade_price);
+            EXPECT_EQ(g.trade_qty, f->trade_qty);
+        } else if (auto* u = std::get_if<BookUpdate>(&expected[i])) {
+            EXPECT_EQ(std::get<BookUpdate>(got[i]).rpt_seq, u->rpt_seq);
+        } else if (auto* a = std::get_if<OrderAccepted>(&expected[i])) {
+            EXPECT_EQ(std::get<OrderAccepted>(got[i]).order_id, a->order_id);
+        }
+    }
+    EXPECT_TRUE(std::any_of(got.begin(), got.end(), [](const EngineEvent& e) {
+        return std::holds_alternative<OrderTriggered>(e);
+    }));
+}
+
+TEST_F(CheckpointTest, RejectsTruncatedAndMismatchedCheckpoints) {
+    FullMatchingEngine original(testLayout());
+    original.submitOrder(limitOrder(2, Side::Buy, 49.0, 1));
+    checkpoint::Checkpoint saved;
+    saved.engines.push_back(original.snapshot());
+    std::string error;
+    ASSERT_TRUE(checkpoint::saveCheckpoint(path_, saved, error)) << error;
+
+    checkpoint::Checkpoint loaded;
+    ASSERT_TRUE(checkpoint::loadCheckpoint(path_, loaded, error)) << error;
+
+    // Another shard, or an engine without the order's book, cannot take it
+    EngineLayout other = testLayout();
+    other.shard_id = 2;
+    FullMatchingEngine wrong_shard(other);
+    EXPECT_FALSE(wrong_shard.restore(loaded.engines[0]));
+    other.shard_id = 1;
+    other.instruments.erase(other.instruments.begin() + 1);
+    other.spreads.clear();
+    FullMatchingEngine missing_book(other);
+    EXPECT_FALSE(missing_book.restore(loaded.engines[0]));
+    EXPECT_EQ(missing_book.restingOrderCount(), 0u);
+
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 8);
+    EXPECT_FALSE(checkpoint::loadCheckpoint(path_, loaded, error));
+    EXPECT_NE(error.find("truncated"), std::string::npos) << error;
+
+    std::ofstream(path_, std::ios::binary | std::ios::trunc) << "not a checkpoint";
+    EXPECT_FALSE(checkpoint::loadCheckpoint(path_, loaded, error));
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include "engine/full_matching_engine.h"
+#include "engine/implied_engine.h"
+#include "market_data/incremental_builder.h"
+#include "sbe/mdp3_messages.h"
+#include "common/types.h"
+#include <vector>
+
+using namespace cme::sim;
+
+namespace {
+
+constexpr SecurityId FRONT = 1;
+constexpr SecurityId BACK = 2;
+constexpr SecurityId SPREAD = 3;  // FRONT - BACK
+
+Order limitOrder(SecurityId security_id, Side side, double price, Quantity qty) {
+    Order o;
+    o.security_id = security_id;
+    o.session_uuid = 100;
+    o.side = side;
+    o.price = Price::fromDouble(price);
+    o.quantity = qty;
+    o.cl_ord_id = "CL";
+    return o;
+}
+
+OrderId acceptedId(const std::vector<EngineEvent>& events) {
+    for (const auto& e : events) {
+        if (auto* a = std::get_if<OrderAccepted>(&e)) return a->order_id;
+    }
+    return 0;
+}
+
+std::vector<BookUpdate> impliedUpdates(const std::vector<EngineEvent>& events) {
+    std::vector<BookUpdate> out;
+    for (const auto& e : events) {
+        if (auto* bu = std::get_if<BookUpdate>(&e); bu && bu->implied) out.push_back(*bu);
+    }
+    return out;
+}
+
+class ImpliedEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (SecurityId id : {FRONT, BACK, SPREAD}) engine_.addInstrument(id);
+        ASSERT_TRUE(engine_.addSpread(SPREAD, FRONT, BACK));
+    }
+
+    const ImpliedEngine::Levels& implied(SecurityId id, Side side) const {
+        return engine_.impliedEngine().implied(id, side);
+    }
+
+    FullMatchingEngine engine_;
+};
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// Implied-in: spread levels walk the front bids against the back offers
+// ---------------------------------------------------------------------------
+TEST_F(ImpliedEngineTest, ImpliedInPairsLegLevelsBestFirst) {
+    engine_.submitOrder(limitOrder(FRONT, Side::Buy, 100.00, 5));
+    engine_.submitOrder(limitOrder(FRONT, Side::Buy, 99.75, 10));
+    EXPECT_EQ(implied(SPREAD, Side::Buy).count, 0);  // no back offer yet
+
+    auto events = engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.00, 3));
+    auto updates = impliedUpdates(events);
+    ASSERT_EQ(updates.size(), 1u);  // back offer exhausted after 3 lots
+    EXPECT_EQ(updates[0].security_id, SPREAD);
+    EXPECT_EQ(updates[0].update_action, MDUpdateAction::New);
+    EXPECT_EQ(updates[0].price, Price::fromDouble(1.00));
+    EXPECT_EQ(updates[0].new_qty, 3);
+
+    engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.25, 4));
+    const auto& bids = implied(SPREAD, Side::Buy);
+    ASSERT_EQ(bids.count, 2);
+    EXPECT_EQ(bids.level[0].price, Price::fromDouble(1.00));
+    EXPECT_EQ(bids.level[0].qty, 3);
+    EXPECT_EQ(bids.level[1].price, Price::fromDouble(0.75));  // 100 - 99.25 for the 2 left
+    EXPECT_EQ(bids.level[1].qty, 2);
+    EXPECT_EQ(implied(SPREAD, Side::Sell).count, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Implied-out: legs are implied from the spread's direct book
+// ---------------------------------------------------------------------------
+TEST_F(ImpliedEngineTest, ImpliedOutFromSpreadAndOtherLeg) {
+    engine_.submitOrder(limitOrder(SPREAD, Side::Buy, 1.00, 4));
+    engine_.submitOrder(limitOrder(BACK, Side::Buy, 98.00, 10));
+    engine_.submitOrder(limitOrder(FRONT, Side::Sell, 101.00, 2));
+
+    // Buy spread + buy back = buy front
+    const auto& front_bids = implied(FRONT, Side::Buy);
+    ASSERT_EQ(front_bids.count, 1);
+    EXPECT_EQ(front_bids.level[0].price, Price::fromDouble(99.00));
+    EXPECT_EQ(front_bids.level[0].qty, 4);
+
+    // Sell front + buy spread = sell back
+    const auto& back_asks = implied(BACK, Side::Sell);
+    ASSERT_EQ(back_asks.count, 1);
+    EXPECT_EQ(back_asks.level[0].price, Price::fromDouble(100.00));
+    EXPECT_EQ(back_asks.level[0].qty, 2);
+
+    // Implied-in from the direct front offer and back bid
+    const auto& spread_asks = implied(SPREAD, Side::Sell);
+    ASSERT_EQ(spread_asks.count, 1);
+    EXPECT_EQ(spread_asks.level[0].price, Price::fromDouble(3.00));
+
+    // The implied front bid and back offer do not feed back into the spread
+    EXPECT_EQ(implied(SPREAD, Side::Buy).count, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Only updates within the implied depth recompute; changes are diffed
+// ---------------------------------------------------------------------------
+TEST_F(ImpliedEngineTest, DeepUpdatesAreSkippedAndChangesDiffed) {
+    OrderId top = acceptedId(engine_.submitOrder(limitOrder(FRONT, Side::Buy, 100.00, 5)));
+    engine_.submitOrder(limitOrder(FRONT, Side::Buy, 99.75, 5));
+    engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.00, 20));
+    engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.25, 5));
+    const auto& bids = implied(SPREAD, Side::Buy);
+    ASSERT_EQ(bids.count, 2);  // 1.00x5, 0.75x5
+
+    // Third levels are past the implied depth of 2
+    EXPECT_TRUE(impliedUpdates(engine_.submitOrder(limitOrder(FRONT, Side::Buy, 99.50, 5))).empty());
+    EXPECT_TRUE(impliedUpdates(engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.50, 5))).empty());
+
+    // Same prices, more size at level 2: one Change
+    auto updates = impliedUpdates(engine_.submitOrder(limitOrder(FRONT, Side::Buy, 99.75, 1)));
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].update_action, MDUpdateAction::Change);
+    EXPECT_EQ(updates[0].price_level_index, 2);
+    EXPECT_EQ(updates[0].new_qty, 6);
+
+    // Front's best bid goes: both levels are overlaid with new prices
+    updates = impliedUpdates(engine_.cancelOrder(top, FRONT, 100));
+    ASSERT_EQ(updates.size(), 2u);
+    EXPECT_EQ(updates[0].update_action, MDUpdateAction::Overlay);
+    EXPECT_EQ(updates[1].update_action, MDUpdateAction::Overlay);
+    EXPECT_EQ(bids.level[0].price, Price::fromDouble(0.75));
+    EXPECT_EQ(bids.level[0].qty, 6);
+    EXPECT_EQ(bids.level[1].price, Price::fromDouble(0.50));
+    EXPECT_EQ(bids.level[1].qty, 5);
+
+    // Lifting every back offer empties the spread bid, deepest level first
+    updates = impliedUpdates(engine_.submitOrder(limitOrder(BACK, Side::Buy, 99.50, 30)));
+    std::vector<int> deleted;
+    for (const auto& u : updates) {
+        if (u.security_id == SPREAD && u.update_action == MDUpdateAction::Delete) {
+            deleted.push_back(u.price_level_index);
+        }
+    }
+    EXPECT_EQ(deleted, (std::vector<int>{2, 1}));
+    EXPECT_EQ(bids.count, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Implied levels go out as MDP implied entries, one message per instrument
+// ---------------------------------------------------------------------------
+TEST_F(ImpliedEngineTest, PublishedAsImpliedEntries) {
+    engine_.submitOrder(limitOrder(FRONT, Side::Buy, 100.00, 5));
+    auto events = engine_.submitOrder(limitOrder(BACK, Side::Sell, 99.00, 5));
+
+    market_data::IncrementalBuilder builder;
+    auto bytes = builder.buildBookRefresh(events, 0);
+    ASSERT_FALSE(bytes.empty());
+    const char* data = reinterpret_cast<const char*>(bytes.data());
+
+    sbe::MDIncrementalRefreshBook46 back;
+    back.decode(data, 0);
+    ASSERT_EQ(back.entries.size(), 1u);
+    EXPECT_EQ(back.entries[0].securityID, BACK);
+    EXPECT_EQ(back.entries[0].mdEntryType, static_cast<char>(MDEntryType::Offer));
+    EXPECT_EQ(back.matchEventIndicator, 0);  // the event continues
+
+    sbe::MDIncrementalRefreshBook46 spread;
+    spread.decode(data, back.encodedLength());
+    EXPECT_EQ(back.encodedLength() + spread.encodedLength(), bytes.size());
+    EXPECT_TRUE(spread.matchEventIndicator & static_cast<uint8_t>(MatchEventIndicator::LastImpliedMsg));
+    EXPECT_TRUE(spread.matchEventIndicator & static_cast<uint8_t>(MatchEventIndicator::EndOfEvent));
+    ASSERT_EQ(spread.entries.size(), 1u);
+    EXPECT_EQ(spread.entries[0].securityID, SPREAD);
+    EXPECT_EQ(spread.entries[0].mdEntryType, static_cast<char>(MDEntryType::ImpliedBid));
+    EXPECT_EQ(spread.entries[0].mdEntryPx, Price::fromDouble(1.00).mantissa);
+}
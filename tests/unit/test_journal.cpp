@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "journal/journal_reader.h"
+#include "journal/journal_writer.h"
+#include "engine/full_matching_engine.h"
+#include "engine/matching_engine.h"
+#include "common/types.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace cme::sim;
+
+namespace {
+
+class JournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("test_journal_" + std::to_string(::getpid()) + ".journal")).string();
+    }
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    std::string path_;
+};
+
+EngineCommand newOrder(SecurityId sec, Side side, double price, Quantity qty, uint64_t ts) {
+    EngineCommand cmd;
+    cmd.session_uuid = 100;
+    cmd.order.session_uuid = 100;
+    cmd.order.security_id = sec;
+    cmd.order.side = side;
+    cmd.order.price = Price::fromDouble(price);
+    cmd.order.quantity = qty;
+    cmd.order.timestamp = ts;
+    cmd.order.cl_ord_id = "CL" + std::to_string(ts);
+    return cmd;
+}
+
+OrderId acceptedId(const EventSink& events, const EventRange& range) {
+    return journal::assignedOrderId(events.range(range.first, range.count));
+}
+
+// What replay must reproduce: the kind of every event, and every ID
+std::vector<std::pair<std::size_t, OrderId>> fingerprint(const EventSink& events) {
+    std::vector<std::pair<std::size_t, OrderId>> out;
+    for (const auto& e : events) {
+        OrderId id = 0;
+        if (auto* a = std::get_if<OrderAccepted>(&e)) id = a->order_id;
+        if (auto* f = std::get_if<OrderFilled>(&e)) id = f->maker_order_id ^ f->taker_order_id;
+        if (auto* c = std::get_if<OrderCancelled>(&e)) id = c->order_id;
+        out.emplace_back(e.index(), id);
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+TEST_F(JournalTest, ReplayReproducesOrderIdsAndEvents) {
+    EngineLayout layout;
+    layout.shard_id = 2;
+    BookConfig wide;
+    wide.max_published_depth = 5;
+    layout.instruments = {{1, {}}, {2, wide}};
+
+    FullMatchingEngine recorded(layout);
+    journal::JournalWriter writer(path_, recorded.layout(), 16);
+    ASSERT_TRUE(writer.open());
+    writer.start();
+
+    EventSink events;
+    std::vector<EventRange> ranges;
+    std::vector<std::vector<std::pair<std::size_t, OrderId>>> expected;
+    auto run = [&](const std::vector<EngineCommand>& commands) {
+        events.clear();
+        recorded.processBatch(commands, events, ranges);
+        writer.appendBatch(commands, events, ranges);
+        expected.push_back(fingerprint(events));
+    };
+
+    // Enough commands to wrap the 16-record queue several times
+    run({newOrder(1, Side::Sell, 101.0, 5, 10), newOrder(2, Side::Sell, 50.0, 5, 10),
+         newOrder(1, Side::Buy, 99.0, 5, 10)});
+    OrderId ask = acceptedId(events, ranges[0]);
+    OrderId bid = acceptedId(events, ranges[2]);
+    ASSERT_NE(ask, 0u);
+
+    for (int i = 0; i < 20; ++i) {
+        run({newOrder(1, Side::Buy, 98.0 - i, 1, 20 + i), newOrder(9, Side::Buy, 1.0, 1, 20 + i)});
+    }
+
+    EngineCommand modify;
+    modify.type = EngineCommand::Type::ModifyOrder;
+    modify.session_uuid = 100;
+    modify.security_id = 1;
+    modify.order_id = bid;
+    modify.new_price = Price::fromDouble(101.0);
+    modify.new_qty = 3;
+    modify.new_cl_ord_id = "MOD";
+    EngineCommand cancel;
+    cancel.type = EngineCommand::Type::CancelOrder;
+    cancel.session_uuid = 100;
+    cancel.security_id = 1;
+    cancel.order_id = ask;
+    EngineCommand mass;
+    mass.type = EngineCommand::Type::MassCancel;
+    mass.session_uuid = 100;
+    mass.security_id = 2;
+    mass.mass_side = Side::Sell;
+    run({modify, cancel, mass, newOrder(2, Side::Buy, 50.0, 1, 99)});
+
+    writer.close();
+    EXPECT_EQ(writer.recordsWritten(), 3u + 20 * 2 + 4);
+
+    journal::JournalReader reader(path_);
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(reader.recordCount(), writer.recordsWritten());
+    EXPECT_EQ(reader.layout().shard_id, 2);
+    ASSERT_EQ(reader.layout().instruments.size(), 2u);
+    EXPECT_EQ(reader.layout().instruments[1].first, 2);
+    EXPECT_EQ(reader.layout().instruments[1].second.max_published_depth, 5);
+
+    // A fresh engine fed the same batches does exactly the same thing
+    FullMatchingEngine replayed(reader.layout());
+    journal::JournalBatch batch;
+    std::size_t n = 0;
+    while (reader.nextBatch(batch)) {
+        ASSERT_LT(n, expected.size());
+        events.clear();
+        replayed.processBatch(batch.commands, events, ranges);
+        EXPECT_EQ(fingerprint(events), expected[n]) << "batch " << batch.batch_seq;
+        for (std::size_t i = 0; i < batch.commands.size(); ++i) {
+            if (batch.commands[i].type != EngineCommand::Type::NewOrder) continue;
+            EXPECT_EQ(acceptedId(events, ranges[i]), batch.expected_ids[i]);
+            EXPECT_EQ(batch.commands[i].order.timestamp,
+                      n == 0 ? 10u : (n <= 20 ? 20u + (n - 1) : 99u));
+        }
+        ++n;
+    }
+    EXPECT_EQ(n, expected.size());
+    EXPECT_EQ(replayed.restingOrderCount(), recorded.restingOrderCount());
+}
+
+TEST_F(JournalTest, ZeroFilledTailEndsTheJournal) {
+    EngineLayout layout;
+    layout.instruments = {{1, {}}};
+    FullMatchingEngine engine(layout);
+    {
+        journal::JournalWriter writer(path_, engine.layout());
+        ASSERT_TRUE(writer.open());
+        EventSink events;
+        std::vector<EventRange> ranges;
+        std::vector<EngineCommand> commands = {newOrder(1, Side::Buy, 100.0, 1, 1)};
+        engine.processBatch(commands, events, ranges);
+        writer.appendBatch(commands, events, ranges);
+        // Never started: close() writes out what is queued
+    }
+
+    // What a killed writer leaves behind: the file grown past its records
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::app);
+        std::string zeros(sizeof(journal::CommandRecord) * 3, '\0');
+        out.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    }
+
+    journal::JournalReader reader(path_);
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(reader.recordCount(), 1u);
+    journal::JournalBatch batch;
+    ASSERT_TRUE(reader.nextBatch(batch));
+    ASSERT_EQ(batch.commands.size(), 1u);
+    EXPECT_EQ(batch.commands[0].order.cl_ord_id, ClOrdId("CL1"));
+    EXPECT_FALSE(reader.nextBatch(batch));
+
+    std::ofstream(path_, std::ios::binary | std::ios::trunc) << "not a journal";
+    journal::JournalReader garbage(path_);
+    EXPECT_FALSE(garbage.open());
+}
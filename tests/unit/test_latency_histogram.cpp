@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "common/latency_histogram.h"
+#include "gateway/latency_recorder.h"
+#include "engine/full_matching_engine.h"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+using namespace cme::sim;
+using namespace cme::sim::gateway;
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueWithinSixPercent) {
+    std::size_t previous = 0;
+    for (uint64_t v = 1; v < (1ULL << 42); v = v * 17 / 16 + 1) {
+        std::size_t bucket = LatencyHistogram::bucketOf(v);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        EXPECT_GE(bucket, previous) << v;
+        previous = bucket;
+        if (v < (1ULL << 40)) {
+            uint64_t top = LatencyHistogram::bucketTop(bucket);
+            EXPECT_GE(top, v);
+            EXPECT_LE(top - v, v / 16) << v;
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(UINT64_MAX), LatencyHistogram::BUCKETS - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesAndMerge) {
+    LatencyHistogram low;
+    LatencyHistogram high;
+    for (uint64_t v = 1; v <= 1000; ++v) low.record(v);
+    for (int i = 0; i < 10; ++i) high.record(1'000'000);
+
+    EXPECT_EQ(low.count(), 1000u);
+    EXPECT_EQ(low.min(), 1u);
+    EXPECT_EQ(low.max(), 1000u);
+    EXPECT_DOUBLE_EQ(low.mean(), 500.5);
+    EXPECT_NEAR(static_cast<double>(low.percentile(50.0)), 500.0, 500.0 / 16);
+    EXPECT_NEAR(static_cast<double>(low.percentile(99.0)), 990.0, 990.0 / 16);
+    EXPECT_EQ(low.percentile(100.0), 1000u);
+
+    low.merge(high);
+    EXPECT_EQ(low.count(), 1010u);
+    EXPECT_EQ(low.max(), 1'000'000u);
+    EXPECT_EQ(low.percentile(99.0), LatencyHistogram::bucketTop(LatencyHistogram::bucketOf(1000)));
+    EXPECT_EQ(low.percentile(99.9), 1'000'000u);
+
+    low.reset();
+    EXPECT_EQ(low.count(), 0u);
+    EXPECT_EQ(low.percentile(50.0), 0u);
+}
+
+TEST(LatencyHistogramTest, RecorderKeysByInstrumentTypeAndStage) {
+    EngineLayout layout;
+    layout.instruments = {{1, {}}, {2, {}}};
+    FullMatchingEngine engine(layout);
+
+    std::vector<EngineCommand> batch(3);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        Order& o = batch[i].order;
+        o.security_id = i == 2 ? 2 : 1;
+        o.session_uuid = 100;
+        o.side = Side::Buy;
+        o.price = Price::fromDouble(100.0);
+        o.quantity = 1;
+        o.cl_ord_id = "CL";
+    }
+    batch.back().type = EngineCommand::Type::MassCancel;
+    batch.back().security_id = 2;
+
+    EventSink events;
+    std::vector<EventRange> ranges;
+    engine.processBatch(batch, events, ranges);
+
+    LatencyRecorder recorder;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        recorder.record(LatencyStage::Match, batch[i], ranges[i].ticks);
+    }
+    recorder.record(LatencyStage::QueueWait, batch[0], 5);
+
+    std::vector<std::tuple<SecurityId, EngineCommand::Type, LatencyStage, uint64_t>> seen;
+    recorder.forEach([&](SecurityId sec, EngineCommand::Type type, LatencyStage stage,
+                         const LatencyHistogram& h) { seen.emplace_back(sec, type, stage, h.count()); });
+    std::sort(seen.begin(), seen.end());
+    using Row = std::tuple<SecurityId, EngineCommand::Type, LatencyStage, uint64_t>;
+    EXPECT_EQ(seen, (std::vector<Row>{
+        {1, EngineCommand::Type::NewOrder, LatencyStage::QueueWait, 1},
+        {1, EngineCommand::Type::NewOrder, LatencyStage::Match, 2},
+        {2, EngineCommand::Type::MassCancel, LatencyStage::Match, 1},
+    }));
+    EXPECT_GT(Clock::nanosPerTick(), 0.0);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "engine/liquidity_provider.h"
+#include "engine/full_matching_engine.h"
+#include "common/types.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace cme::sim;
+
+namespace {
+
+LiquidityParams esParams() {
+    LiquidityParams params;
+    params.reference = Price::fromDouble(5000.0);
+    params.tick_mantissa = Price::fromDouble(0.25).mantissa;
+    params.depth = 3;
+    params.spread_ticks = 2;
+    params.level_ticks = 2;
+    params.qty = 7;
+    params.requote_ns = 1000;
+    return params;
+}
+
+template <typename BookSideT>
+std::vector<std::pair<double, Quantity>> levels(const BookSideT& side) {
+    std::vector<std::pair<double, Quantity>> out;
+    for (const auto& [price, level] : side) out.emplace_back(price.toDouble(), level.total_quantity);
+    return out;
+}
+
+} // anonymous namespace
+
+TEST(LiquidityProviderTest, QuotesLadderAroundReference) {
+    LiquidityProvider provider;
+    provider.addInstrument(1, esParams());
+
+    std::vector<EngineCommand> commands;
+    EXPECT_EQ(provider.poll(10'000, commands), 1u);
+    ASSERT_EQ(commands.size(), 7u);  // pull, then 3 bids and 3 offers
+    EXPECT_EQ(commands[0].type, EngineCommand::Type::MassCancel);
+    EXPECT_EQ(commands[0].security_id, 1u);
+    for (const EngineCommand& cmd : commands) {
+        EXPECT_EQ(cmd.session_uuid, LiquidityProvider::SESSION_UUID);
+    }
+
+    EngineLayout layout;
+    layout.instruments = {{1, {}}};
+    FullMatchingEngine engine(layout);
+    EventSink events;
+    std::vector<EventRange> ranges;
+    engine.processBatch(commands, events, ranges);
+
+    const OrderBook* book = engine.getOrderBook(1);
+    using Levels = std::vector<std::pair<double, Quantity>>;
+    EXPECT_EQ(levels(book->bidLevels()), (Levels{{4999.75, 7}, {4999.25, 7}, {4998.75, 7}}));
+    EXPECT_EQ(levels(book->askLevels()), (Levels{{5000.25, 7}, {5000.75, 7}, {5001.25, 7}}));
+
+    // Nothing until the requote interval is up
+    commands.clear();
+    EXPECT_EQ(provider.poll(10'500, commands), 0u);
+    EXPECT_TRUE(commands.empty());
+
+    // A requote replaces the ladder instead of stacking on it, including
+    // after part of it traded away
+    Order lift;
+    lift.security_id = 1;
+    lift.session_uuid = 100;
+    lift.side = Side::Buy;
+    lift.price = Price::fromDouble(5000.25);
+    lift.quantity = 4;
+    lift.cl_ord_id = "LIFT";
+    engine.submitOrder(lift);
+
+    EXPECT_EQ(provider.poll(11'000, commands), 1u);
+    events.clear();
+    engine.processBatch(commands, events, ranges);
+    EXPECT_EQ(engine.restingOrderCount(), 6u);
+    EXPECT_EQ(engine.sessionOrderCount(LiquidityProvider::SESSION_UUID), 6u);
+    EXPECT_EQ(levels(book->askLevels()).front(), (std::pair<double, Quantity>{5000.25, 7}));
+}
+
+TEST(LiquidityProviderTest, ReferenceWalksOnTheTickGrid) {
+    LiquidityParams params = esParams();
+    params.reference = Price::fromDouble(5000.1);  // snapped down to 5000.00
+    params.walk_ticks = 3;
+    LiquidityProvider provider(42);
+    provider.addInstrument(1, params);
+
+    const int64_t tick = params.tick_mantissa;
+    std::vector<EngineCommand> commands;
+    provider.poll(0, commands);
+    EXPECT_EQ(provider.reference(1), Price::fromDouble(5000.0));  // first quote does not move
+
+    Price previous = provider.reference(1);
+    bool moved = false;
+    for (uint64_t now = 1000; now <= 100'000; now += 1000) {
+        commands.clear();
+        ASSERT_EQ(provider.poll(now, commands), 1u);
+        Price ref = provider.reference(1);
+        EXPECT_EQ(ref.mantissa % tick, 0);
+        EXPECT_LE(std::abs(ref.mantissa - previous.mantissa), 3 * tick);
+        moved |= ref != previous;
+        previous = ref;
+        for (const EngineCommand& cmd : commands) {
+            if (cmd.type == EngineCommand::Type::NewOrder) {
+                EXPECT_EQ(cmd.order.price.mantissa % tick, 0);
+            }
+        }
+    }
+    EXPECT_TRUE(moved);
+    EXPECT_TRUE(provider.reference(2).isNull());
+}
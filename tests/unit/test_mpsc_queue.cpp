@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "common/mpsc_queue.h"
+#include "common/spsc_queue.h"
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace cme::sim;
+
+TEST(MPSCQueueTest, BoundedRingRejectsWhenFullAndDrainsInOrder) {
+    MPSCQueue<std::unique_ptr<int>> queue(5);
+    EXPECT_EQ(queue.capacity(), 8u);
+    EXPECT_TRUE(queue.empty());
+
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(queue.tryPush(std::make_unique<int>(i)));
+    auto extra = std::make_unique<int>(8);
+    EXPECT_FALSE(queue.tryPush(std::move(extra)));
+    ASSERT_TRUE(extra);  // a failed push leaves the value with the caller
+
+    auto first = queue.tryPop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(**first, 0);
+    EXPECT_TRUE(queue.tryPush(std::move(extra)));  // the freed slot wraps around
+
+    std::vector<int> seen;
+    EXPECT_EQ(queue.drain([&](std::unique_ptr<int>&& v) { seen.push_back(*v); }, 3), 3u);
+    EXPECT_EQ(queue.drain([&](std::unique_ptr<int>&& v) { seen.push_back(*v); }), 5u);
+    EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.tryPop().has_value());
+}
+
+TEST(MPSCQueueTest, ProducersKeepTheirOwnOrderThroughASmallRing) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    MPSCQueue<std::pair<int, int>> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) queue.push({p, i});
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    bool in_order = true;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        std::size_t n = queue.drain([&](std::pair<int, int>&& v) {
+            in_order &= v.second == next[v.first]++;
+        });
+        if (n == 0) std::this_thread::yield();
+        received += static_cast<int>(n);
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(next, std::vector<int>(PRODUCERS, PER_PRODUCER));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueTest, DrainRespectsQuotaAndKeepsOrder) {
+    constexpr int ITEMS = 20000;
+    SPSCQueue<int> lane(64);
+
+    std::thread producer([&lane] {
+        for (int i = 0; i < ITEMS; ++i) {
+            while (!lane.tryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    int next = 0;
+    bool in_order = true;
+    bool within_quota = true;
+    while (next < ITEMS) {
+        std::size_t n = lane.drain([&](int&& v) { in_order &= v == next++; }, 16);
+        within_quota &= n <= 16;
+        if (n == 0) std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(within_quota);
+    EXPECT_EQ(lane.drain([](int&&) {}, 16), 0u);
+}
@@ -5,6 +5,8 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
+#include <cstring>
+#include <tuple>
 
 using namespace cme::sim;
 
@@ -480,3 +482,473 @@ TEST_F(OrderBookTest, ModifyNonexistentOrder) {
     auto events = book->modifyOrder(999, Price::fromDouble(100.0), 10, "CL999");
     EXPECT_GE(countEvents<OrderCancelRejected>(events), 1);
 }
+
+// ---------------------------------------------------------------------------
+// 24. PriceLevelIndexTracksRank
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, PriceLevelIndexTracksRank) {
+    book->addOrder(makeOrder(1, Side::Buy, 100.0, 1));
+    book->addOrder(makeOrder(2, Side::Buy, 99.0, 1));
+    book->addOrder(makeOrder(3, Side::Buy, 98.0, 1));
+
+    // New level between 100 and 99 takes rank 2
+    auto events = book->addOrder(makeOrder(4, Side::Buy, 99.5, 1));
+    auto& bu = getEvent<BookUpdate>(events);
+    EXPECT_EQ(bu.update_action, MDUpdateAction::New);
+    EXPECT_EQ(bu.price_level_index, 2);
+
+    // 98 is now the fourth level
+    auto cancel_events = book->cancelOrder(3);
+    auto& del = getEvent<BookUpdate>(cancel_events);
+    EXPECT_EQ(del.update_action, MDUpdateAction::Delete);
+    EXPECT_EQ(del.price_level_index, 4);
+
+    // Sweeping the top ask always reports level 1
+    book->addOrder(makeOrder(5, Side::Sell, 101.0, 1));
+    book->addOrder(makeOrder(6, Side::Sell, 102.0, 1));
+    auto sweep = book->addOrder(makeOrder(7, Side::Buy, 102.0, 2));
+    ASSERT_EQ(countEvents<BookUpdate>(sweep), 2);
+    EXPECT_EQ(getEvent<BookUpdate>(sweep, 0).price_level_index, 1);
+    EXPECT_EQ(getEvent<BookUpdate>(sweep, 1).price_level_index, 1);
+}
+
+// ---------------------------------------------------------------------------
+// 25. DepthLimitSuppressesDeepBookUpdates
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, DepthLimitSuppressesDeepBookUpdates) {
+    BookConfig cfg;
+    cfg.max_published_depth = 2;
+    book = std::make_unique<OrderBook>(1, cfg);
+
+    EXPECT_EQ(countEvents<BookUpdate>(book->addOrder(makeOrder(1, Side::Buy, 100.0, 1))), 1);
+    EXPECT_EQ(countEvents<BookUpdate>(book->addOrder(makeOrder(2, Side::Buy, 99.0, 1))), 1);
+
+    // Third level is outside the published depth
+    auto deep = book->addOrder(makeOrder(3, Side::Buy, 98.0, 1));
+    EXPECT_EQ(countEvents<BookUpdate>(deep), 0);
+    EXPECT_EQ(book->bidLevelCount(), 3);
+
+    // A new best level is still published at rank 1
+    auto top = book->addOrder(makeOrder(4, Side::Buy, 101.0, 1));
+    ASSERT_EQ(countEvents<BookUpdate>(top), 1);
+    EXPECT_EQ(getEvent<BookUpdate>(top).price_level_index, 1);
+
+    // Deleting a published level moves 99 up into rank 2, where
+    // subscribers have never seen it: it goes out as a New
+    auto cxl = book->cancelOrder(4);
+    ASSERT_EQ(countEvents<BookUpdate>(cxl), 2);
+    EXPECT_EQ(getEvent<BookUpdate>(cxl, 0).update_action, MDUpdateAction::Delete);
+    EXPECT_EQ(getEvent<BookUpdate>(cxl, 0).price_level_index, 1);
+    EXPECT_EQ(getEvent<BookUpdate>(cxl, 1).update_action, MDUpdateAction::New);
+    EXPECT_EQ(getEvent<BookUpdate>(cxl, 1).price_level_index, 2);
+    EXPECT_EQ(getEvent<BookUpdate>(cxl, 1).price, Price::fromDouble(99.0));
+
+    // Same when a trade takes out the top level: 98 moves up
+    auto hit = book->addOrder(makeOrder(5, Side::Sell, 100.0, 1));
+    ASSERT_EQ(countEvents<BookUpdate>(hit), 2);
+    EXPECT_EQ(getEvent<BookUpdate>(hit, 1).update_action, MDUpdateAction::New);
+    EXPECT_EQ(getEvent<BookUpdate>(hit, 1).price, Price::fromDouble(98.0));
+    EXPECT_EQ(getEvent<BookUpdate>(hit, 1).new_qty, 1);
+
+    // With nothing left below, a Delete is all there is
+    auto last = book->cancelOrder(2);
+    EXPECT_EQ(countEvents<BookUpdate>(last), 1);
+}
+
+// ---------------------------------------------------------------------------
+// 26. EventSinkAppendsAcrossCommands
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, EventSinkAppendsAcrossCommands) {
+    EventSink sink;
+    book->addOrder(makeOrder(1, Side::Buy, 100.0, 10), sink);
+    std::size_t after_first = sink.size();
+    EXPECT_EQ(after_first, 2u); // OrderAccepted + BookUpdate
+
+    // The second command appends after the first one's events
+    book->addOrder(makeOrder(2, Side::Sell, 100.0, 4), sink);
+    auto second = sink.since(after_first);
+    ASSERT_FALSE(second.empty());
+    EXPECT_TRUE(std::holds_alternative<OrderAccepted>(second[0]));
+    int fills = 0;
+    for (const auto& e : second) fills += std::holds_alternative<OrderFilled>(e);
+    EXPECT_EQ(fills, 1);
+
+    // clear() keeps the buffer for the next command
+    sink.clear();
+    EXPECT_TRUE(sink.empty());
+    book->cancelOrder(1, sink);
+    ASSERT_EQ(sink.size(), 2u);
+    EXPECT_TRUE(std::holds_alternative<OrderCancelled>(sink[1]));
+}
+
+// ---------------------------------------------------------------------------
+// 27. RejectsCarryReasonCodes
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, RejectsCarryReasonCodes) {
+    auto fok = book->addOrder(makeOrder(1, Side::Buy, 100.0, 5,
+                                        OrderType::Limit, TimeInForce::FOK));
+    ASSERT_EQ(countEvents<OrderRejected>(fok), 1);
+    const auto& rej = getEvent<OrderRejected>(fok);
+    EXPECT_EQ(rej.reason, RejectReason::FokNotFillable);
+    EXPECT_EQ(rejectReasonText(rej.reason), "FOK order cannot be fully filled");
+    EXPECT_EQ(rej.cl_ord_id, ClOrdId("CLO1"));
+
+    auto cxl = book->cancelOrder(42);
+    ASSERT_EQ(countEvents<OrderCancelRejected>(cxl), 1);
+    EXPECT_EQ(getEvent<OrderCancelRejected>(cxl).reason, RejectReason::OrderNotFound);
+
+    // Events are plain records that survive a byte copy
+    EngineEvent copy;
+    std::memcpy(static_cast<void*>(&copy), &fok[0], sizeof(EngineEvent));
+    ASSERT_TRUE(std::holds_alternative<OrderRejected>(copy));
+    EXPECT_EQ(std::get<OrderRejected>(copy).cl_ord_id, rej.cl_ord_id);
+}
+
+// ---------------------------------------------------------------------------
+// 28. StopOrderRestsUntilElected
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, StopOrderRestsUntilElected) {
+    book->addOrder(makeOrder(1, Side::Sell, 101.0, 5));
+    book->addOrder(makeOrder(2, Side::Sell, 102.0, 5));
+
+    // Buy stop-limit: trigger at 101, limit 102. Not visible on the book.
+    Order* stop = makeOrder(3, Side::Buy, 102.0, 4, OrderType::StopLimit);
+    stop->stop_price = Price::fromDouble(101.0);
+    auto accepted = book->addOrder(stop);
+    EXPECT_EQ(countEvents<OrderAccepted>(accepted), 1);
+    EXPECT_EQ(countEvents<BookUpdate>(accepted), 0);
+    EXPECT_EQ(book->stopOrderCount(), 1u);
+    EXPECT_EQ(book->bestBid(), Price::null());
+
+    // A trade at 101 elects it; it then lifts the rest of 101 and part of 102
+    auto events = book->addOrder(makeOrder(4, Side::Buy, 101.0, 2));
+    ASSERT_EQ(countEvents<OrderTriggered>(events), 1);
+    const auto& trig = getEvent<OrderTriggered>(events);
+    EXPECT_EQ(trig.order_id, 3u);
+    EXPECT_EQ(trig.trigger_price, Price::fromDouble(101.0));
+    EXPECT_EQ(trig.order_type, OrderType::Limit);
+    ASSERT_EQ(countEvents<OrderFilled>(events), 3);
+    EXPECT_EQ(getEvent<OrderFilled>(events, 1).taker_order_id, 3u);
+    EXPECT_EQ(getEvent<OrderFilled>(events, 2).trade_price, Price::fromDouble(102.0));
+    EXPECT_TRUE(stop->isFullyFilled());
+    EXPECT_EQ(book->stopOrderCount(), 0u);
+    EXPECT_EQ(book->lastTradePrice(), Price::fromDouble(102.0));
+}
+
+// ---------------------------------------------------------------------------
+// 29. StopCascadeElectsIteratively
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, StopCascadeElectsIteratively) {
+    for (int i = 0; i < 5; ++i) {
+        book->addOrder(makeOrder(1 + i, Side::Buy, 100.0 - i, 1));
+    }
+    // Sell stop-markets at 100, 99, 98: each elected stop trades one level
+    // lower, which elects the next
+    for (int i = 0; i < 3; ++i) {
+        Order* stop = makeOrder(10 + i, Side::Sell, 0.0, 1, OrderType::StopMarket);
+        stop->stop_price = Price::fromDouble(100.0 - i);
+        book->addOrder(stop);
+    }
+    // Far stop stays put
+    Order* far = makeOrder(20, Side::Sell, 0.0, 1, OrderType::StopMarket);
+    far->stop_price = Price::fromDouble(90.0);
+    book->addOrder(far);
+
+    auto events = book->addOrder(makeOrder(30, Side::Sell, 100.0, 1));
+    EXPECT_EQ(countEvents<OrderTriggered>(events), 3);
+    ASSERT_EQ(countEvents<OrderFilled>(events), 4);
+    EXPECT_EQ(getEvent<OrderFilled>(events, 3).trade_price, Price::fromDouble(97.0));
+    EXPECT_EQ(getEvent<OrderFilled>(events, 3).taker_order_id, 12u);
+    EXPECT_EQ(book->lastTradePrice(), Price::fromDouble(97.0));
+    EXPECT_EQ(book->stopOrderCount(), 1u);
+    EXPECT_EQ(book->bestBid(), Price::fromDouble(96.0));
+}
+
+// ---------------------------------------------------------------------------
+// 30. StopOrderCancelAndReject
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, StopOrderCancelAndReject) {
+    book->addOrder(makeOrder(1, Side::Sell, 100.0, 1));
+    book->addOrder(makeOrder(2, Side::Buy, 100.0, 1));  // last trade 100
+
+    // Buy stop at or below the last trade would elect on entry: rejected
+    Order* through = makeOrder(3, Side::Buy, 101.0, 1, OrderType::StopLimit);
+    through->stop_price = Price::fromDouble(100.0);
+    auto rej = book->addOrder(through);
+    ASSERT_EQ(countEvents<OrderRejected>(rej), 1);
+    EXPECT_EQ(getEvent<OrderRejected>(rej).reason, RejectReason::InvalidStopPrice);
+
+    Order* stop = makeOrder(4, Side::Buy, 0.0, 1, OrderType::StopMarket);
+    stop->stop_price = Price::fromDouble(101.0);
+    book->addOrder(stop);
+    EXPECT_EQ(book->stopOrderCount(), 1u);
+
+    auto cxl = book->cancelOrder(4);
+    EXPECT_EQ(countEvents<OrderCancelled>(cxl), 1);
+    EXPECT_EQ(countEvents<BookUpdate>(cxl), 0);
+    EXPECT_EQ(book->stopOrderCount(), 0u);
+
+    // Trading through the old trigger no longer elects anything
+    book->addOrder(makeOrder(5, Side::Sell, 102.0, 1));
+    auto events = book->addOrder(makeOrder(6, Side::Buy, 102.0, 1));
+    EXPECT_EQ(countEvents<OrderTriggered>(events), 0);
+}
+
+// ---------------------------------------------------------------------------
+// 31. IcebergShowsOnlyDisplaySlice
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, IcebergShowsOnlyDisplaySlice) {
+    Order* ice = makeOrder(1, Side::Sell, 100.0, 50);
+    ice->display_qty = 10;
+    auto events = book->addOrder(ice);
+    ASSERT_EQ(countEvents<BookUpdate>(events), 1);
+    EXPECT_EQ(getEvent<BookUpdate>(events).new_qty, 10);
+
+    const PriceLevel& level = book->askLevels().begin()->second;
+    EXPECT_EQ(level.total_quantity, 10);
+    EXPECT_EQ(level.hidden_quantity, 40);
+
+    // A taker larger than the slice still reaches the reserve: the slice
+    // refreshes and trades again within the same sweep
+    auto fills = book->addOrder(makeOrder(2, Side::Buy, 100.0, 25));
+    ASSERT_EQ(countEvents<OrderFilled>(fills), 3);
+    EXPECT_EQ(getEvent<OrderFilled>(fills, 0).trade_qty, 10);
+    EXPECT_EQ(getEvent<OrderFilled>(fills, 2).trade_qty, 5);
+    EXPECT_EQ(getEvent<OrderFilled>(fills, 2).maker_leaves_qty, 25);
+    EXPECT_EQ(level.total_quantity, 5);
+    EXPECT_EQ(level.hidden_quantity, 20);
+
+    // The last book update shows the partly consumed slice only
+    const BookUpdate* last = nullptr;
+    for (const auto& e : fills) {
+        if (auto* bu = std::get_if<BookUpdate>(&e)) last = bu;
+    }
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(last->new_qty, 5);
+
+    // FOK sees the hidden reserve as executable
+    auto fok = book->addOrder(makeOrder(3, Side::Buy, 100.0, 25,
+                                        OrderType::Limit, TimeInForce::FOK));
+    EXPECT_EQ(countEvents<OrderRejected>(fok), 0);
+    EXPECT_TRUE(ice->isFullyFilled());
+    EXPECT_EQ(book->askLevelCount(), 0);
+}
+
+// ---------------------------------------------------------------------------
+// 32. IcebergReplenishLosesTimePriority
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, IcebergReplenishLosesTimePriority) {
+    Order* ice = makeOrder(1, Side::Buy, 100.0, 30);
+    ice->display_qty = 5;
+    book->addOrder(ice);
+    book->addOrder(makeOrder(2, Side::Buy, 100.0, 4));
+
+    // Exhausting the slice requeues the iceberg behind order 2
+    auto first = book->addOrder(makeOrder(3, Side::Sell, 100.0, 5));
+    ASSERT_EQ(countEvents<OrderFilled>(first), 1);
+    EXPECT_EQ(getEvent<OrderFilled>(first).maker_order_id, 1u);
+
+    auto second = book->addOrder(makeOrder(4, Side::Sell, 100.0, 6));
+    ASSERT_EQ(countEvents<OrderFilled>(second), 2);
+    EXPECT_EQ(getEvent<OrderFilled>(second, 0).maker_order_id, 2u);
+    EXPECT_EQ(getEvent<OrderFilled>(second, 1).maker_order_id, 1u);
+    EXPECT_EQ(getEvent<OrderFilled>(second, 1).trade_qty, 2);
+
+    const PriceLevel& level = book->bidLevels().begin()->second;
+    EXPECT_EQ(level.order_count, 1);
+    EXPECT_EQ(level.total_quantity, 3);
+    EXPECT_EQ(level.hidden_quantity, 20);
+}
+
+// ---------------------------------------------------------------------------
+// 33. MinQtyRequiresImmediateExecution
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, MinQtyRequiresImmediateExecution) {
+    book->addOrder(makeOrder(1, Side::Sell, 100.0, 3));
+    book->addOrder(makeOrder(2, Side::Sell, 101.0, 3));
+
+    // Only 3 available at or below 100: MinQty 4 is rejected outright
+    Order* strict = makeOrder(3, Side::Buy, 100.0, 10);
+    strict->min_qty = 4;
+    auto rej = book->addOrder(strict);
+    ASSERT_EQ(countEvents<OrderRejected>(rej), 1);
+    EXPECT_EQ(getEvent<OrderRejected>(rej).reason, RejectReason::MinQtyNotFillable);
+    EXPECT_EQ(book->askLevelCount(), 2);
+
+    // Up to 101 there are 6: fills them and rests the remainder
+    Order* ok = makeOrder(4, Side::Buy, 101.0, 10);
+    ok->min_qty = 6;
+    auto events = book->addOrder(ok);
+    EXPECT_EQ(countEvents<OrderFilled>(events), 2);
+    EXPECT_EQ(ok->filled_qty, 6);
+    EXPECT_EQ(book->bestBid(), Price::fromDouble(101.0));
+}
+
+// ---------------------------------------------------------------------------
+// 34. SelfMatchPreventionModes
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, SelfMatchPreventionModes) {
+    auto run = [&](SmpMode mode) {
+        BookConfig cfg;
+        cfg.smp_mode = mode;
+        book = std::make_unique<OrderBook>(1, cfg);
+        Order* own = makeOrder(1, Side::Sell, 100.0, 5);
+        own->smp_id = 7;
+        Order* other = makeOrder(2, Side::Sell, 100.0, 5);
+        other->smp_id = 8;
+        book->addOrder(own);
+        book->addOrder(other);
+        Order* taker = makeOrder(3, Side::Buy, 100.0, 4);
+        taker->smp_id = 7;
+        return std::make_tuple(book->addOrder(taker), own, taker);
+    };
+
+    {
+        auto [events, own, taker] = run(SmpMode::None);
+        ASSERT_EQ(countEvents<OrderFilled>(events), 1);
+        EXPECT_EQ(getEvent<OrderFilled>(events).maker_order_id, 1u);
+    }
+    {
+        // Resting order pulled; the aggressor trades with the next one
+        auto [events, own, taker] = run(SmpMode::CancelResting);
+        ASSERT_EQ(countEvents<OrderCancelled>(events), 1);
+        EXPECT_EQ(getEvent<OrderCancelled>(events).order_id, 1u);
+        ASSERT_EQ(countEvents<OrderFilled>(events), 1);
+        EXPECT_EQ(getEvent<OrderFilled>(events).maker_order_id, 2u);
+        EXPECT_EQ(own->status, OrdStatus::Canceled);
+        EXPECT_TRUE(taker->isFullyFilled());
+        EXPECT_EQ(book->askLevels().begin()->second.total_quantity, 1);
+    }
+    {
+        // Aggressor cancelled; the book is untouched and nothing rests
+        auto [events, own, taker] = run(SmpMode::CancelAggressor);
+        EXPECT_EQ(countEvents<OrderFilled>(events), 0);
+        ASSERT_EQ(countEvents<OrderCancelled>(events), 1);
+        EXPECT_EQ(getEvent<OrderCancelled>(events).order_id, 3u);
+        EXPECT_EQ(countEvents<BookUpdate>(events), 0);
+        EXPECT_EQ(book->askLevels().begin()->second.total_quantity, 10);
+        EXPECT_EQ(book->bestBid(), Price::null());
+    }
+    {
+        auto [events, own, taker] = run(SmpMode::CancelBoth);
+        EXPECT_EQ(countEvents<OrderFilled>(events), 0);
+        ASSERT_EQ(countEvents<OrderCancelled>(events), 2);
+        EXPECT_EQ(own->status, OrdStatus::Canceled);
+        EXPECT_EQ(taker->status, OrdStatus::Canceled);
+        EXPECT_EQ(book->askLevels().begin()->second.order_count, 1);
+        EXPECT_EQ(book->bestBid(), Price::null());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 35. SweepElectsStopsItTradedThrough
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, SweepElectsStopsItTradedThrough) {
+    book->addOrder(makeOrder(1, Side::Sell, 101.0, 1));
+    book->addOrder(makeOrder(2, Side::Buy, 101.0, 1));  // last trade 101
+
+    book->addOrder(makeOrder(3, Side::Buy, 99.0, 1));
+    book->addOrder(makeOrder(4, Side::Sell, 100.0, 1));
+    book->addOrder(makeOrder(5, Side::Sell, 102.0, 1));
+    Order* sell_stop = makeOrder(6, Side::Sell, 0.0, 1, OrderType::StopMarket);
+    sell_stop->stop_price = Price::fromDouble(100.5);
+    book->addOrder(sell_stop);
+
+    // A buy sweep prints 100 then 102: it ends above the sell stop but
+    // traded through it on the way
+    auto events = book->addOrder(makeOrder(7, Side::Buy, 102.0, 2));
+    ASSERT_EQ(countEvents<OrderTriggered>(events), 1);
+    EXPECT_EQ(getEvent<OrderTriggered>(events).order_id, 6u);
+    EXPECT_EQ(getEvent<OrderTriggered>(events).trigger_price, Price::fromDouble(100.0));
+    ASSERT_EQ(countEvents<OrderFilled>(events), 3);
+    EXPECT_EQ(getEvent<OrderFilled>(events, 2).trade_price, Price::fromDouble(99.0));
+    EXPECT_EQ(book->lastTradePrice(), Price::fromDouble(99.0));
+
+    // And the other way round: a sell sweep through 101 down to 98 elects
+    // a buy stop at 100.5
+    Order* buy_stop = makeOrder(8, Side::Buy, 0.0, 1, OrderType::StopMarket);
+    buy_stop->stop_price = Price::fromDouble(100.5);
+    book->addOrder(buy_stop);
+    book->addOrder(makeOrder(9, Side::Buy, 101.0, 1));
+    book->addOrder(makeOrder(10, Side::Buy, 98.0, 1));
+    book->addOrder(makeOrder(11, Side::Sell, 104.0, 1));
+
+    auto down = book->addOrder(makeOrder(12, Side::Sell, 98.0, 2));
+    ASSERT_EQ(countEvents<OrderTriggered>(down), 1);
+    EXPECT_EQ(getEvent<OrderTriggered>(down).order_id, 8u);
+    EXPECT_EQ(getEvent<OrderTriggered>(down).trigger_price, Price::fromDouble(101.0));
+    ASSERT_EQ(countEvents<OrderFilled>(down), 3);
+    EXPECT_EQ(getEvent<OrderFilled>(down, 2).trade_price, Price::fromDouble(104.0));
+    EXPECT_EQ(book->stopOrderCount(), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// 36. FillOrKillIgnoresSelfMatchedDepth
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, FillOrKillIgnoresSelfMatchedDepth) {
+    auto setup = [&](SmpMode mode) {
+        BookConfig cfg;
+        cfg.smp_mode = mode;
+        book = std::make_unique<OrderBook>(1, cfg);
+        Order* own = makeOrder(1, Side::Sell, 100.0, 5);
+        own->smp_id = 7;
+        Order* other = makeOrder(2, Side::Sell, 100.0, 5);
+        other->smp_id = 8;
+        book->addOrder(own);
+        book->addOrder(other);
+        return own;
+    };
+
+    {
+        // 10 rest at 100, but only the foreign 5 can trade with smp_id 7
+        Order* own = setup(SmpMode::CancelResting);
+        Order* fok = makeOrder(3, Side::Buy, 100.0, 10, OrderType::Limit, TimeInForce::FOK);
+        fok->smp_id = 7;
+        auto rej = book->addOrder(fok);
+        ASSERT_EQ(countEvents<OrderRejected>(rej), 1);
+        EXPECT_EQ(getEvent<OrderRejected>(rej).reason, RejectReason::FokNotFillable);
+        EXPECT_EQ(countEvents<OrderFilled>(rej), 0);
+        EXPECT_EQ(own->status, OrdStatus::New);
+        EXPECT_EQ(book->askLevels().begin()->second.total_quantity, 10);
+
+        Order* fits = makeOrder(4, Side::Buy, 100.0, 5, OrderType::Limit, TimeInForce::FOK);
+        fits->smp_id = 7;
+        auto events = book->addOrder(fits);
+        EXPECT_EQ(countEvents<OrderFilled>(events), 1);
+        EXPECT_TRUE(fits->isFullyFilled());
+    }
+    {
+        // The own order is first in the queue and would cancel the
+        // aggressor: nothing is executable, so MinQty 1 is rejected
+        setup(SmpMode::CancelAggressor);
+        Order* taker = makeOrder(3, Side::Buy, 100.0, 5);
+        taker->smp_id = 7;
+        taker->min_qty = 1;
+        auto rej = book->addOrder(taker);
+        ASSERT_EQ(countEvents<OrderRejected>(rej), 1);
+        EXPECT_EQ(getEvent<OrderRejected>(rej).reason, RejectReason::MinQtyNotFillable);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 37. ElectedStopRechecksMinQty
+// ---------------------------------------------------------------------------
+TEST_F(OrderBookTest, ElectedStopRechecksMinQty) {
+    book->addOrder(makeOrder(1, Side::Sell, 100.0, 1));
+    book->addOrder(makeOrder(2, Side::Buy, 100.0, 1));  // last trade 100
+    book->addOrder(makeOrder(3, Side::Sell, 101.0, 2));
+
+    Order* stop = makeOrder(4, Side::Buy, 101.0, 5, OrderType::StopLimit);
+    stop->stop_price = Price::fromDouble(100.5);
+    stop->min_qty = 4;
+    book->addOrder(stop);
+
+    // A trade at 101 elects it with only 1 left at its limit: cancelled
+    auto events = book->addOrder(makeOrder(5, Side::Buy, 101.0, 1));
+    ASSERT_EQ(countEvents<OrderTriggered>(events), 1);
+    ASSERT_EQ(countEvents<OrderCancelled>(events), 1);
+    EXPECT_EQ(getEvent<OrderCancelled>(events).order_id, 4u);
+    EXPECT_EQ(countEvents<OrderFilled>(events), 1);
+    EXPECT_EQ(stop->status, OrdStatus::Canceled);
+    EXPECT_EQ(book->askLevels().begin()->second.total_quantity, 1);
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include "gateway/order_entry_gateway.h"
+#include "common/io_thread.h"
+#include "engine/full_matching_engine.h"
+#include "instruments/instrument_manager.h"
+#include "sbe/ilink3_messages.h"
+#include "sbe/message_header.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace cme::sim;
+using namespace cme::sim::gateway;
+using namespace cme::sim::sbe;
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// The gateway between decoded SBE requests and two engine shards: ESH5
+// (security 1) on shard 0 and NQH5 (security 2) on shard 1. Requests go in
+// through onApplicationMessage() on the test thread; each shard's engine
+// pass is one processCommands() call.
+// ---------------------------------------------------------------------------
+class OrderEntryGatewayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config::InstrumentConfig es;
+        es.symbol = "ESH5";
+        es.security_id = 1;
+        es.channel_id = 310;
+        es.tick_size = 0.25;
+        es.max_position = 10;
+        config::InstrumentConfig nq = es;
+        nq.symbol = "NQH5";
+        nq.security_id = 2;
+        nq.channel_id = 320;
+        nq.max_position = 0;   // the risk default
+        instruments_.loadFromConfig({es, nq}, {});
+        makeGateway(config::EngineConfig{});
+    }
+
+    void TearDown() override { setIoThreadIndex(-1); }
+
+    void makeGateway(const config::EngineConfig& engine_config) {
+        gateway_ = std::make_unique<OrderEntryGateway>(instruments_, risk_, engine_config);
+        gateway_->configureShards(2, {{1, 0}, {2, 1}});
+        engines_.clear();
+        for (uint8_t shard = 0; shard < 2; ++shard) {
+            EngineLayout layout;
+            layout.shard_id = shard;
+            layout.instruments = {{static_cast<SecurityId>(shard + 1), {}}};
+            engines_.push_back(std::make_unique<FullMatchingEngine>(layout));
+        }
+        buckets_.clear();
+    }
+
+    void deliver(uint64_t session, uint16_t template_id, const char* data, size_t len) {
+        auto it = buckets_.try_emplace(session, gateway_->makeRateLimit()).first;
+        gateway_->onApplicationMessage(session, template_id, data, len, it->second);
+    }
+
+    void newOrder(uint64_t session, SecurityId security_id, Side side, double price,
+                  uint32_t qty, const char* cl_ord_id = "GW") {
+        NewOrderSingle514 msg;
+        msg.price = Price::fromDouble(price).mantissa;
+        msg.orderQty = qty;
+        msg.securityID = security_id;
+        msg.side = static_cast<uint8_t>(side);
+        writeFixedString(msg.clOrdID, cl_ord_id, 20);
+        msg.ordType = static_cast<uint8_t>(OrderType::Limit);
+        msg.timeInForce = static_cast<uint8_t>(TimeInForce::Day);
+        char buf[256];
+        deliver(session, NewOrderSingle514::TEMPLATE_ID, buf, msg.encode(buf, 0));
+    }
+
+    void cancel(uint64_t session, SecurityId security_id, OrderId order_id) {
+        OrderCancelRequest516 msg;
+        msg.orderID = order_id;
+        msg.securityID = security_id;
+        writeFixedString(msg.clOrdID, "GWCXL", 20);
+        char buf[256];
+        deliver(session, OrderCancelRequest516::TEMPLATE_ID, buf, msg.encode(buf, 0));
+    }
+
+    void modify(uint64_t session, SecurityId security_id, OrderId order_id, Side side,
+                double price, uint32_t qty) {
+        OrderCancelReplaceRequest515 msg;
+        msg.price = Price::fromDouble(price).mantissa;
+        msg.orderQty = qty;
+        msg.securityID = security_id;
+        msg.side = static_cast<uint8_t>(side);
+        msg.orderID = order_id;
+        writeFixedString(msg.clOrdID, "GWMOD", 20);
+        msg.ordType = static_cast<uint8_t>(OrderType::Limit);
+        msg.timeInForce = static_cast<uint8_t>(TimeInForce::Day);
+        char buf[256];
+        deliver(session, OrderCancelReplaceRequest515::TEMPLATE_ID, buf, msg.encode(buf, 0));
+    }
+
+    // Mass cancel of every instrument the session trades
+    void massCancel(uint64_t session, uint64_t order_request_id) {
+        OrderMassActionRequest529 msg;
+        msg.orderRequestID = order_request_id;
+        msg.massActionScope = OrderMassActionRequest529::SCOPE_MARKET_SEGMENT;
+        char buf[256];
+        deliver(session, OrderMassActionRequest529::TEMPLATE_ID, buf, msg.encode(buf, 0));
+    }
+
+    std::vector<OrderResponse> run(std::size_t shard) {
+        return gateway_->processCommands(*engines_[shard], nullptr, shard);
+    }
+
+    static uint16_t templateOf(const OrderResponse& resp) {
+        return MessageHeader::decodeTemplateId(resp.sbe_message.data());
+    }
+
+    template <typename Msg>
+    static Msg decode(const OrderResponse& resp) {
+        EXPECT_EQ(templateOf(resp), Msg::TEMPLATE_ID);
+        Msg msg;
+        msg.decode(resp.sbe_message.data(), 0);
+        return msg;
+    }
+
+    // Rests one order and returns its ID from the ack
+    OrderId rest(uint64_t session, SecurityId security_id, Side side, double price,
+                 uint32_t qty) {
+        newOrder(session, security_id, side, price, qty);
+        auto responses = run(security_id == 2 ? 1 : 0);
+        if (responses.size() != 1) {
+            ADD_FAILURE() << "expected one ack, got " << responses.size();
+            return 0;
+        }
+        return decode<ExecutionReportNew522>(responses[0]).orderID;
+    }
+
+    InstrumentManager instruments_;
+    config::RiskConfig risk_;
+    std::unique_ptr<OrderEntryGateway> gateway_;
+    std::vector<std::unique_ptr<FullMatchingEngine>> engines_;
+    std::unordered_map<uint64_t, TokenBucket> buckets_;
+};
+
+} // namespace
+
+TEST_F(OrderEntryGatewayTest, RoutesEachSecurityToItsShard) {
+    newOrder(1, 1, Side::Buy, 100.0, 1);
+    newOrder(1, 2, Side::Buy, 200.0, 1);
+    newOrder(1, 99, Side::Buy, 100.0, 1);   // unknown: shard 0 rejects it
+
+    auto shard0 = run(0);
+    ASSERT_EQ(shard0.size(), 2u);
+    EXPECT_EQ(decode<ExecutionReportNew522>(shard0[0]).securityID, 1);
+    EXPECT_EQ(templateOf(shard0[1]), ExecutionReportReject523::TEMPLATE_ID);
+
+    auto shard1 = run(1);
+    ASSERT_EQ(shard1.size(), 1u);
+    EXPECT_EQ(decode<ExecutionReportNew522>(shard1[0]).securityID, 2);
+    EXPECT_TRUE(run(0).empty());
+}
+
+TEST_F(OrderEntryGatewayTest, AllInstrumentMassCancelReportsOnce) {
+    rest(1, 1, Side::Buy, 100.0, 1);
+    rest(1, 1, Side::Sell, 101.0, 1);
+    rest(1, 2, Side::Buy, 200.0, 1);
+    rest(2, 2, Side::Buy, 199.0, 1);   // another session's order stays
+    massCancel(1, 77);
+
+    // The first shard to run it sends only its cancels
+    auto shard0 = run(0);
+    ASSERT_EQ(shard0.size(), 2u);
+    EXPECT_EQ(templateOf(shard0[0]), ExecutionReportCancel534::TEMPLATE_ID);
+    EXPECT_EQ(templateOf(shard0[1]), ExecutionReportCancel534::TEMPLATE_ID);
+
+    // The last one adds the report, counting both shards
+    auto shard1 = run(1);
+    ASSERT_EQ(shard1.size(), 2u);
+    EXPECT_EQ(templateOf(shard1[0]), ExecutionReportCancel534::TEMPLATE_ID);
+    auto report = decode<OrderMassActionReport562>(shard1[1]);
+    EXPECT_EQ(shard1[1].session_uuid, 1u);
+    EXPECT_EQ(report.orderRequestID, 77u);
+    EXPECT_EQ(report.massActionResponse, OrderMassActionReport562::RESPONSE_ACCEPTED);
+    EXPECT_EQ(report.totalAffectedOrders, 3u);
+}
+
+TEST_F(OrderEntryGatewayTest, DisconnectCancelsOnEveryShard) {
+    rest(1, 1, Side::Buy, 100.0, 1);
+    rest(1, 2, Side::Buy, 200.0, 1);
+    rest(2, 1, Side::Buy, 99.0, 1);
+    gateway_->onSessionDisconnected(1);
+
+    for (std::size_t shard = 0; shard < 2; ++shard) {
+        auto responses = run(shard);
+        ASSERT_EQ(responses.size(), 1u) << "shard " << shard;   // no mass action report
+        EXPECT_EQ(responses[0].session_uuid, 1u);
+        EXPECT_EQ(templateOf(responses[0]), ExecutionReportCancel534::TEMPLATE_ID);
+    }
+    EXPECT_EQ(engines_[0]->getOrderBook(1)->bidLevelCount(), 1);   // session 2's 99 bid
+}
+
+TEST_F(OrderEntryGatewayTest, IoLanesTakeTurnsUpToTheQuota) {
+    gateway_->configureIoLanes(2);
+
+    setIoThreadIndex(0);
+    for (int i = 0; i < 300; ++i) newOrder(1, 2, Side::Buy, 200.0, 1);
+    setIoThreadIndex(1);
+    for (int i = 0; i < 10; ++i) newOrder(2, 2, Side::Buy, 199.0, 1);
+    setIoThreadIndex(-1);
+    newOrder(3, 2, Side::Buy, 198.0, 1);   // not an IO thread: the shared ring
+
+    // One pass takes at most 256 from each lane, then the shared ring
+    auto first = run(1);
+    EXPECT_EQ(first.size(), 256u + 10u + 1u);
+    EXPECT_EQ(gateway_->laneCounts(1), (std::vector<uint64_t>{256, 10, 1}));
+    EXPECT_EQ(first.front().session_uuid, 1u);
+    EXPECT_EQ(first.back().session_uuid, 3u);
+
+    // The next pass starts at lane 1
+    setIoThreadIndex(1);
+    for (int i = 0; i < 5; ++i) newOrder(2, 2, Side::Buy, 199.0, 1);
+    setIoThreadIndex(-1);
+    auto second = run(1);
+    ASSERT_EQ(second.size(), 5u + 44u);
+    EXPECT_EQ(second.front().session_uuid, 2u);
+    EXPECT_EQ(second.back().session_uuid, 1u);
+    EXPECT_EQ(gateway_->laneCounts(1), (std::vector<uint64_t>{300, 15, 1}));
+}
+
+TEST_F(OrderEntryGatewayTest, FullRingThrottlesUnderRejectPolicy) {
+    config::EngineConfig small;
+    small.command_queue_capacity = 4;
+    small.queue_full_policy = "reject";
+    makeGateway(small);
+    std::vector<OrderResponse> throttled;
+    gateway_->setThrottleHandler([&](OrderResponse&& resp) {
+        throttled.push_back(std::move(resp));
+    });
+
+    for (int i = 0; i < 6; ++i) newOrder(1, 1, Side::Buy, 100.0, 1);
+    cancel(1, 1, 12345);
+    ASSERT_EQ(throttled.size(), 3u);
+    EXPECT_EQ(gateway_->throttledCount(), 3u);
+    EXPECT_EQ(decode<ExecutionReportReject523>(throttled[0]).ordRejReason, 3u);   // exceeds limit
+    EXPECT_EQ(decode<OrderCancelReject535>(throttled[2]).cxlRejReason, 99u);      // other
+
+    // What fit in the ring still runs; the other shard's ring is its own
+    EXPECT_EQ(run(0).size(), 4u);
+    newOrder(1, 2, Side::Buy, 200.0, 1);
+    EXPECT_EQ(run(1).size(), 1u);
+    EXPECT_EQ(gateway_->throttledCount(), 3u);
+}
+
+TEST_F(OrderEntryGatewayTest, ModifyHoldCoversTheRestOfTheBatch) {
+    OrderId first = rest(1, 1, Side::Buy, 100.0, 2);
+    OrderId second = rest(1, 1, Side::Buy, 99.0, 2);
+
+    // Both in one batch: the first one's added 4 counts against the second
+    modify(1, 1, first, Side::Buy, 100.0, 6);
+    modify(1, 1, second, Side::Buy, 99.0, 8);   // adds 6 to the 8 held
+    auto responses = run(0);
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(templateOf(responses[0]), ExecutionReportModify531::TEMPLATE_ID);
+    EXPECT_EQ(decode<OrderCancelReject535>(responses[1]).cxlRejReason, 3u);   // exceeds limit
+    EXPECT_EQ(gateway_->riskStage(0).openQty(1, 1, Side::Buy), 8);
+
+    // Released after the batch: the engine's leaves are what is held now
+    modify(1, 1, second, Side::Buy, 99.0, 4);   // 8 + 2 = 10
+    responses = run(0);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(templateOf(responses[0]), ExecutionReportModify531::TEMPLATE_ID);
+    EXPECT_EQ(gateway_->riskStage(0).openQty(1, 1, Side::Buy), 10);
+}
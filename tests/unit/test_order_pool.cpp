@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include "engine/order_pool.h"
+#include "engine/full_matching_engine.h"
+#include "engine/order.h"
+#include "common/types.h"
+#include <span>
+#include <vector>
+
+using namespace cme::sim;
+
+// ---------------------------------------------------------------------------
+// OrderPool
+// ---------------------------------------------------------------------------
+
+TEST(OrderPoolTest, ReusesReleasedSlotsBeforeGrowing) {
+    OrderPool pool(4);
+    std::vector<OrderHandle> handles;
+    for (int i = 0; i < 4; ++i) handles.push_back(pool.acquire());
+    EXPECT_EQ(pool.capacity(), 4u);
+    EXPECT_EQ(pool.live(), 4u);
+    EXPECT_EQ(handles.front(), 0u);
+
+    Order* stable = pool.get(handles[1]);
+    pool.release(handles[2]);
+    EXPECT_EQ(pool.acquire(), handles[2]);
+    EXPECT_EQ(pool.capacity(), 4u);
+
+    // Growing adds a slab without moving existing orders
+    OrderHandle fifth = pool.acquire();
+    EXPECT_EQ(fifth, 4u);
+    EXPECT_EQ(pool.capacity(), 8u);
+    EXPECT_EQ(pool.get(handles[1]), stable);
+}
+
+TEST(OrderPoolTest, FindRejectsStaleIds) {
+    OrderPool pool(4);
+    OrderHandle h = pool.acquire();
+    OrderId first = OrderPool::makeOrderId(1, h);
+    pool.get(h)->order_id = first;
+    EXPECT_EQ(OrderPool::handleOf(first), h);
+    EXPECT_EQ(pool.find(first), pool.get(h));
+
+    pool.release(h);
+    EXPECT_EQ(pool.find(first), nullptr);
+
+    // Slot reused by a later order: the old ID must not resolve to it
+    OrderHandle again = pool.acquire();
+    ASSERT_EQ(again, h);
+    OrderId second = OrderPool::makeOrderId(2, again);
+    pool.get(again)->order_id = second;
+    EXPECT_EQ(pool.find(first), nullptr);
+    EXPECT_EQ(pool.find(second), pool.get(again));
+    EXPECT_EQ(pool.find(OrderPool::makeOrderId(3, 1000)), nullptr);
+}
+
+// ---------------------------------------------------------------------------
+// FullMatchingEngine on the pool
+// ---------------------------------------------------------------------------
+
+namespace {
+
+Order limitOrder(Side side, double price, Quantity qty,
+                 TimeInForce tif = TimeInForce::Day) {
+    Order o;
+    o.security_id = 1;
+    o.session_uuid = 100;
+    o.side = side;
+    o.price = Price::fromDouble(price);
+    o.quantity = qty;
+    o.time_in_force = tif;
+    o.cl_ord_id = "CL";
+    return o;
+}
+
+OrderId acceptedId(const std::vector<EngineEvent>& events) {
+    for (const auto& e : events) {
+        if (auto* a = std::get_if<OrderAccepted>(&e)) return a->order_id;
+    }
+    return 0;
+}
+
+} // anonymous namespace
+
+TEST(PooledEngineTest, RestingOrdersHoldSlotsUntilDone) {
+    FullMatchingEngine engine;
+    engine.addInstrument(1);
+
+    OrderId bid = acceptedId(engine.submitOrder(limitOrder(Side::Buy, 100.0, 5)));
+    OrderId bid2 = acceptedId(engine.submitOrder(limitOrder(Side::Buy, 99.0, 5)));
+    ASSERT_NE(bid, 0u);
+    EXPECT_NE(bid, bid2);
+    EXPECT_EQ(engine.restingOrderCount(), 2u);
+
+    // IOC remainder never rests; fully filled maker is released
+    auto events = engine.submitOrder(limitOrder(Side::Sell, 100.0, 8, TimeInForce::IOC));
+    EXPECT_EQ(engine.restingOrderCount(), 1u);
+
+    // Cancel by ID resolves through the handle
+    auto cancel = engine.cancelOrder(bid2, 1, 100);
+    ASSERT_FALSE(cancel.empty());
+    EXPECT_TRUE(std::holds_alternative<OrderCancelled>(cancel.back()));
+    EXPECT_EQ(engine.restingOrderCount(), 0u);
+
+    // Filled and cancelled IDs are stale even after their slots are reused
+    engine.submitOrder(limitOrder(Side::Buy, 98.0, 1));
+    engine.submitOrder(limitOrder(Side::Buy, 97.0, 1));
+    for (OrderId stale : {bid, bid2}) {
+        auto rej = engine.cancelOrder(stale, 1, 100);
+        ASSERT_EQ(rej.size(), 1u);
+        EXPECT_TRUE(std::holds_alternative<OrderCancelRejected>(rej[0]));
+    }
+    EXPECT_EQ(engine.restingOrderCount(), 2u);
+}
+
+TEST(PooledEngineTest, ModifyResolvesThroughHandle) {
+    FullMatchingEngine engine;
+    engine.addInstrument(1);
+
+    OrderId ask = acceptedId(engine.submitOrder(limitOrder(Side::Sell, 101.0, 3)));
+    OrderId bid = acceptedId(engine.submitOrder(limitOrder(Side::Buy, 99.0, 3)));
+
+    // Reprice the bid through the ask: both fill and both slots return
+    auto events = engine.modifyOrder(bid, 1, Price::fromDouble(101.0), 3, "CL2");
+    bool filled = false;
+    for (const auto& e : events) {
+        if (auto* f = std::get_if<OrderFilled>(&e)) {
+            filled = true;
+            EXPECT_EQ(f->maker_order_id, ask);
+            EXPECT_EQ(f->taker_order_id, bid);
+        }
+    }
+    EXPECT_TRUE(filled);
+    EXPECT_EQ(engine.restingOrderCount(), 0u);
+}
+
+TEST(PooledEngineTest, RejectedOrdersDoNotLeakSlots) {
+    FullMatchingEngine engine;
+    engine.addInstrument(1);
+
+    auto unknown = limitOrder(Side::Buy, 100.0, 1);
+    unknown.security_id = 2;
+    engine.submitOrder(unknown);
+    engine.submitOrder(limitOrder(Side::Buy, 100.0, 1, TimeInForce::FOK));
+    EXPECT_EQ(engine.restingOrderCount(), 0u);
+}
+
+TEST(PooledEngineTest, ShardIdKeepsOrderIdsDistinctAcrossEngines) {
+    FullMatchingEngine shard0(0);
+    FullMatchingEngine shard3(3);
+    shard0.addInstrument(1);
+    shard3.addInstrument(1);
+
+    // Same sequence and slot in both engines; only the shard bits differ
+    OrderId a = acceptedId(shard0.submitOrder(limitOrder(Side::Buy, 100.0, 1)));
+    OrderId b = acceptedId(shard3.submitOrder(limitOrder(Side::Buy, 100.0, 1)));
+    ASSERT_NE(a, 0u);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(OrderPool::handleOf(a), OrderPool::handleOf(b));
+    EXPECT_EQ((b >> 24) & 0xFF, 3u);
+
+    // Each engine still resolves its own IDs and rejects the other's
+    auto rej = shard0.cancelOrder(b, 1, 100);
+    ASSERT_EQ(rej.size(), 1u);
+    EXPECT_TRUE(std::holds_alternative<OrderCancelRejected>(rej[0]));
+    auto ok = shard3.cancelOrder(b, 1, 100);
+    ASSERT_FALSE(ok.empty());
+    EXPECT_TRUE(std::holds_alternative<OrderCancelled>(ok.back()));
+}
+
+TEST(PooledEngineTest, ElectedStopsReleaseSlotsWhenDone) {
+    FullMatchingEngine engine;
+    engine.addInstrument(1);
+
+    engine.submitOrder(limitOrder(Side::Sell, 100.0, 1));
+    engine.submitOrder(limitOrder(Side::Sell, 101.0, 1));
+    auto stop = limitOrder(Side::Buy, 0.0, 3);
+    stop.order_type = OrderType::StopMarket;
+    stop.stop_price = Price::fromDouble(100.0);
+    engine.submitOrder(stop);
+    EXPECT_EQ(engine.restingOrderCount(), 3u);
+
+    // Trade at 100 elects the stop; it takes 101 and its remainder cancels.
+    // Only the other command's order was submitted, yet every slot returns.
+    engine.submitOrder(limitOrder(Side::Buy, 100.0, 1));
+    EXPECT_EQ(engine.restingOrderCount(), 0u);
+}
+
+TEST(PooledEngineTest, BatchGroupsByBookAndMatchesOneByOne) {
+    FullMatchingEngine batched;
+    FullMatchingEngine sequential;
+    std::vector<OrderId> asks;
+    for (FullMatchingEngine* engine : {&batched, &sequential}) {
+        engine->addInstrument(1);
+        engine->addInstrument(2);
+        asks.clear();
+        for (SecurityId sec : {1, 2}) {
+            auto ask = limitOrder(Side::Sell, 100.0, 5);
+            ask.security_id = sec;
+            asks.push_back(acceptedId(engine->submitOrder(ask)));
+        }
+    }
+
+    auto newOrder = [](SecurityId sec, Side side, double price, Quantity qty) {
+        EngineCommand cmd;
+        cmd.order = limitOrder(side, price, qty);
+        cmd.order.security_id = sec;
+        return cmd;
+    };
+    auto cancel = [](OrderId id, SecurityId sec) {
+        EngineCommand cmd;
+        cmd.type = EngineCommand::Type::CancelOrder;
+        cmd.order_id = id;
+        cmd.security_id = sec;
+        cmd.session_uuid = 100;
+        return cmd;
+    };
+    std::vector<EngineCommand> commands = {
+        newOrder(2, Side::Buy, 100.0, 2),
+        newOrder(1, Side::Buy, 100.0, 3),
+        cancel(asks[0], 2),               // wrong security: still book 1, after the buy
+        newOrder(9, Side::Buy, 100.0, 1), // unknown security
+        newOrder(2, Side::Buy, 100.0, 3),
+        cancel(asks[0], 1),               // already cancelled
+    };
+
+    EventSink events;
+    std::vector<EventRange> ranges;
+    batched.processBatch(commands, events, ranges);
+    ASSERT_EQ(ranges.size(), commands.size());
+
+    // Same events per command as running them one at a time in order
+    // (IDs aside: grouping reorders the sequence numbers)
+    EventSink one;
+    std::vector<EventRange> one_range;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        one.clear();
+        sequential.IMatchingEngine::processBatch(std::span(&commands[i], 1), one, one_range);
+        auto got = events.range(ranges[i].first, ranges[i].count);
+        ASSERT_EQ(got.size(), one.size()) << "command " << i;
+        for (std::size_t k = 0; k < got.size(); ++k) {
+            EXPECT_EQ(got[k].index(), one[k].index()) << "command " << i;
+        }
+    }
+
+    // Book 1's commands ran together, before book 2's; unknown (9) last
+    EXPECT_LT(ranges[1].first, ranges[2].first);
+    EXPECT_LT(ranges[2].first, ranges[5].first);
+    EXPECT_LT(ranges[5].first, ranges[0].first);
+    EXPECT_LT(ranges[0].first, ranges[4].first);
+    EXPECT_LT(ranges[4].first, ranges[3].first);
+    auto cancelled = events.range(ranges[2].first, ranges[2].count);
+    EXPECT_TRUE(std::holds_alternative<OrderCancelled>(cancelled.back()));
+    EXPECT_EQ(batched.restingOrderCount(), sequential.restingOrderCount());
+}
+
+TEST(PooledEngineTest, MassCancelTouchesOnlyTheSessionsOrders) {
+    FullMatchingEngine engine;
+    engine.addInstrument(1);
+    engine.addInstrument(2);
+
+    auto order = [](uint64_t session, SecurityId sec, Side side, double price, Quantity qty) {
+        Order o = limitOrder(side, price, qty);
+        o.session_uuid = session;
+        o.smp_id = 0;
+        o.security_id = sec;
+        return o;
+    };
+    engine.submitOrder(order(100, 1, Side::Buy, 99.0, 5));
+    engine.submitOrder(order(100, 1, Side::Sell, 101.0, 5));
+    engine.submitOrder(order(100, 2, Side::Buy, 99.0, 5));
+    OrderId filled = acceptedId(engine.submitOrder(order(100, 2, Side::Sell, 101.0, 2)));
+    engine.submitOrder(order(200, 1, Side::Buy, 99.0, 7));
+    EXPECT_EQ(engine.sessionOrderCount(100), 4u);
+
+    // A maker filled by another session leaves its owner's list
+    engine.submitOrder(order(200, 2, Side::Buy, 101.0, 2));
+    EXPECT_EQ(engine.sessionOrderCount(100), 3u);
+    EXPECT_EQ(engine.cancelOrder(filled, 2, 100).size(), 1u);  // reject only
+
+    // One instrument, one side
+    auto events = engine.massCancel(100, 1, Side::Sell);
+    ASSERT_EQ(events.size(), 2u);  // level delete + cancel
+    EXPECT_TRUE(std::holds_alternative<BookUpdate>(events[0]));
+    EXPECT_EQ(std::get<OrderCancelled>(events[1]).security_id, 1);
+    EXPECT_EQ(engine.sessionOrderCount(100), 2u);
+
+    // Everything else of session 100, book by book; session 200 untouched
+    events = engine.massCancel(100);
+    std::vector<SecurityId> cancelled;
+    for (const auto& e : events) {
+        if (auto* c = std::get_if<OrderCancelled>(&e)) {
+            EXPECT_EQ(c->session_uuid, 100u);
+            cancelled.push_back(c->security_id);
+        }
+    }
+    EXPECT_EQ(cancelled, (std::vector<SecurityId>{1, 2}));
+    EXPECT_EQ(engine.sessionOrderCount(100), 0u);
+    EXPECT_EQ(engine.sessionOrderCount(200), 1u);
+    EXPECT_EQ(engine.restingOrderCount(), 1u);
+    EXPECT_TRUE(engine.massCancel(100).empty());
+
+    // In a batch an all-instrument mass cancel sees exactly the commands
+    // before it, whatever their book
+    EngineCommand add;
+    add.order = order(100, 2, Side::Buy, 98.0, 1);
+    EngineCommand mass;
+    mass.type = EngineCommand::Type::MassCancel;
+    mass.session_uuid = 100;
+    EngineCommand add_after;
+    add_after.order = order(100, 1, Side::Buy, 98.0, 1);
+    std::vector<EngineCommand> commands = {add, mass, add_after};
+
+    EventSink sink;
+    std::vector<EventRange> ranges;
+    engine.processBatch(commands, sink, ranges);
+    auto mass_events = sink.range(ranges[1].first, ranges[1].count);
+    ASSERT_EQ(mass_events.size(), 2u);
+    EXPECT_EQ(std::get<OrderCancelled>(mass_events[1]).security_id, 2);
+    EXPECT_EQ(engine.sessionOrderCount(100), 1u);
+}
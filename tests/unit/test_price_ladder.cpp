@@ -0,0 +1,337 @@
+#include <gtest/gtest.h>
+#include "engine/price_ladder.h"
+#include "engine/order_book.h"
+#include "engine/order.h"
+#include "common/types.h"
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cme::sim;
+
+namespace {
+
+constexpr int64_t TICK = 250'000'000; // 0.25
+
+Price ticks(int64_t n) { return Price{n * TICK}; }
+
+BookConfig ladderConfig(std::size_t window = 64) {
+    BookConfig cfg;
+    cfg.backend = BookBackend::TickLadder;
+    cfg.tick_mantissa = TICK;
+    cfg.ladder_ticks = window;
+    return cfg;
+}
+
+// Event stream as text, for comparing two books event by event
+std::string describeEvents(const std::vector<EngineEvent>& events) {
+    std::ostringstream os;
+    for (const auto& ev : events) {
+        std::visit([&](const auto& e) {
+            using T = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<T, BookUpdate>) {
+                os << "BU " << int(e.side) << ' ' << e.price.mantissa << ' ' << e.new_qty
+                   << ' ' << e.new_order_count << ' ' << int(e.update_action)
+                   << ' ' << e.price_level_index << ' ' << e.rpt_seq << '\n';
+            } else if constexpr (std::is_same_v<T, OrderFilled>) {
+                os << "FILL " << e.maker_order_id << ' ' << e.taker_order_id << ' '
+                   << e.trade_price.mantissa << ' ' << e.trade_qty << '\n';
+            } else if constexpr (std::is_same_v<T, OrderRejected>) {
+                os << "REJ " << int(e.reason) << '\n';
+            } else {
+                os << "EV " << ev.index() << '\n';
+            }
+        }, ev);
+    }
+    return os.str();
+}
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// PriceLadder
+// ---------------------------------------------------------------------------
+
+TEST(PriceLadderTest, BidBestCursorTracksHighestLevel) {
+    PriceLadder<Side::Buy> ladder(TICK, 64);
+    EXPECT_EQ(ladder.best(), nullptr);
+
+    auto [l1, c1] = ladder.insert(ticks(400));
+    auto [l2, c2] = ladder.insert(ticks(402));
+    auto [l3, c3] = ladder.insert(ticks(401));
+    EXPECT_TRUE(c1 && c2 && c3);
+    EXPECT_EQ(ladder.size(), 3);
+    ASSERT_NE(ladder.best(), nullptr);
+    EXPECT_EQ(ladder.best()->price, ticks(402));
+
+    auto [again, created] = ladder.insert(ticks(401));
+    EXPECT_FALSE(created);
+    EXPECT_EQ(again->price, ticks(401));
+
+    ladder.erase(ladder.find(ticks(402)));
+    EXPECT_EQ(ladder.best()->price, ticks(401));
+    ladder.erase(ladder.find(ticks(401)));
+    EXPECT_EQ(ladder.best()->price, ticks(400));
+    ladder.erase(ladder.find(ticks(400)));
+    EXPECT_EQ(ladder.best(), nullptr);
+    EXPECT_TRUE(ladder.empty());
+}
+
+TEST(PriceLadderTest, AskBestCursorTracksLowestLevel) {
+    PriceLadder<Side::Sell> ladder(TICK, 64);
+    ladder.insert(ticks(500));
+    ladder.insert(ticks(503));
+    ladder.insert(ticks(501));
+    EXPECT_EQ(ladder.best()->price, ticks(500));
+
+    ladder.erase(ladder.find(ticks(500)));
+    EXPECT_EQ(ladder.best()->price, ticks(501));
+    EXPECT_EQ(ladder.find(ticks(502)), nullptr);
+}
+
+TEST(PriceLadderTest, RejectsOffTickPrices) {
+    PriceLadder<Side::Buy> ladder(TICK, 64);
+    EXPECT_TRUE(ladder.accepts(ticks(10)));
+    EXPECT_FALSE(ladder.accepts(Price{ticks(10).mantissa + 1}));
+}
+
+TEST(PriceLadderTest, ReanchorsAndGrowsWhilePreservingLevels) {
+    PriceLadder<Side::Sell> ladder(TICK, 64);
+    Order resting;
+    resting.quantity = 7;
+    ladder.insert(ticks(1000)).first->addOrder(&resting);
+
+    // Far outside the initial 64-tick window on both sides
+    ladder.insert(ticks(1300));
+    ladder.insert(ticks(900));
+    EXPECT_GE(ladder.windowTicks(), 401u);
+    EXPECT_EQ(ladder.size(), 3);
+    EXPECT_EQ(ladder.best()->price, ticks(900));
+
+    PriceLevel* kept = ladder.find(ticks(1000));
+    ASSERT_NE(kept, nullptr);
+    EXPECT_EQ(kept->total_quantity, 7);
+    EXPECT_EQ(kept->front(), &resting);
+
+    // Walk in priority order across word boundaries
+    std::vector<int64_t> seen;
+    for (int idx = ladder.bestIndex(); idx != PriceLadder<Side::Sell>::NONE;
+         idx = ladder.nextWorse(idx)) {
+        seen.push_back(ladder.slot(idx).first.mantissa / TICK);
+    }
+    EXPECT_EQ(seen, (std::vector<int64_t>{900, 1000, 1300}));
+}
+
+TEST(PriceLadderTest, DepthThroughSumsReachableLevels) {
+    PriceLadder<Side::Sell> asks(TICK, 64);
+    PriceLadder<Side::Buy> bids(TICK, 64);
+    // Depth reported through addDepth() must match what the levels hold,
+    // since a re-anchor rebuilds the tree from the levels
+    std::vector<std::unique_ptr<Order>> orders;
+    auto rest = [&](auto& ladder, int64_t t, Quantity qty) {
+        auto order = std::make_unique<Order>();
+        order->quantity = qty;
+        ladder.insert(ticks(t)).first->addOrder(order.get());
+        ladder.addDepth(ticks(t), qty);
+        orders.push_back(std::move(order));
+    };
+    for (auto [t, qty] : {std::pair<int64_t, Quantity>{10, 5}, {12, 7}, {15, 1}}) {
+        rest(asks, t, qty);
+        rest(bids, t, qty);
+    }
+    // Asks at or below the limit
+    EXPECT_EQ(asks.depthThrough(ticks(9)), 0);
+    EXPECT_EQ(asks.depthThrough(ticks(10)), 5);
+    EXPECT_EQ(asks.depthThrough(ticks(14)), 12);
+    EXPECT_EQ(asks.depthThrough(ticks(5000)), 13);
+    // Bids at or above the limit
+    EXPECT_EQ(bids.depthThrough(ticks(16)), 0);
+    EXPECT_EQ(bids.depthThrough(ticks(12)), 8);
+    EXPECT_EQ(bids.depthThrough(ticks(-5000)), 13);
+
+    // Depth survives a re-anchor far outside the window
+    rest(asks, 2000, 4);
+    EXPECT_EQ(asks.depthThrough(ticks(14)), 12);
+    EXPECT_EQ(asks.depthTotal(), 17);
+    asks.addDepth(ticks(12), -7);
+    asks.erase(asks.find(ticks(12)));
+    EXPECT_EQ(asks.depthThrough(ticks(1999)), 6);
+}
+
+TEST(PriceLadderTest, CountBetterUsesOccupancyOnly) {
+    PriceLadder<Side::Buy> bids(TICK, 64);
+    PriceLadder<Side::Sell> asks(TICK, 64);
+    for (int64_t t : {10, 12, 15, 40}) {
+        bids.insert(ticks(t));
+        asks.insert(ticks(t));
+    }
+    EXPECT_EQ(bids.countBetter(ticks(40)), 0);
+    EXPECT_EQ(bids.countBetter(ticks(15)), 1);
+    EXPECT_EQ(bids.countBetter(ticks(13)), 2);  // empty tick between levels
+    EXPECT_EQ(asks.countBetter(ticks(10)), 0);
+    EXPECT_EQ(asks.countBetter(ticks(40)), 3);
+
+    bids.erase(bids.find(ticks(40)));
+    EXPECT_EQ(bids.countBetter(ticks(10)), 2);
+}
+
+// ---------------------------------------------------------------------------
+// OrderBook on the ladder backend
+// ---------------------------------------------------------------------------
+
+TEST(LadderOrderBookTest, LevelIterationMatchesMapShape) {
+    OrderBook book(1, ladderConfig());
+    std::vector<std::unique_ptr<Order>> orders;
+    auto add = [&](OrderId id, Side side, int64_t t, Quantity qty) {
+        auto o = std::make_unique<Order>();
+        o->order_id = id;
+        o->security_id = 1;
+        o->side = side;
+        o->price = ticks(t);
+        o->quantity = qty;
+        book.addOrder(o.get());
+        orders.push_back(std::move(o));
+    };
+    add(1, Side::Buy, 100, 5);
+    add(2, Side::Buy, 98, 3);
+    add(3, Side::Buy, 100, 2);
+    add(4, Side::Sell, 103, 4);
+
+    EXPECT_EQ(book.backend(), BookBackend::TickLadder);
+    EXPECT_EQ(book.bestBid(), ticks(100));
+    EXPECT_EQ(book.bestAsk(), ticks(103));
+
+    std::vector<std::pair<Price, Quantity>> bids;
+    for (const auto& [price, level] : book.bidLevels()) {
+        bids.emplace_back(price, level.total_quantity);
+    }
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_EQ(bids[0], std::make_pair(ticks(100), Quantity{7}));
+    EXPECT_EQ(bids[1], std::make_pair(ticks(98), Quantity{3}));
+}
+
+TEST(LadderOrderBookTest, OffTickOrderRejected) {
+    OrderBook book(1, ladderConfig());
+    Order o;
+    o.order_id = 1;
+    o.side = Side::Buy;
+    o.price = Price{ticks(100).mantissa + 1};
+    o.quantity = 1;
+    auto events = book.addOrder(&o);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_TRUE(std::holds_alternative<OrderRejected>(events[0]));
+    EXPECT_EQ(book.bidLevelCount(), 0);
+}
+
+// Drive identical random order flow through a map-backed and a ladder-backed
+// book and require byte-for-byte identical event streams.
+TEST(LadderOrderBookTest, MatchesMapBackendOnRandomFlow) {
+    OrderBook map_book(1);
+    OrderBook ladder_book(1, ladderConfig(64));
+    std::vector<std::unique_ptr<Order>> owned;
+    std::vector<OrderId> live;
+
+    const auto& describe = describeEvents;
+    std::mt19937 rng(12345);
+    for (OrderId id = 1; id <= 4000; ++id) {
+        int action = static_cast<int>(rng() % 10);
+        if (action < 2 && !live.empty()) {
+            OrderId victim = live[rng() % live.size()];
+            ASSERT_EQ(describe(map_book.cancelOrder(victim)),
+                      describe(ladder_book.cancelOrder(victim)));
+            continue;
+        }
+        if (action < 3 && !live.empty()) {
+            OrderId target = live[rng() % live.size()];
+            Price px = ticks(2000 + static_cast<int>(rng() % 300) - 150);
+            Quantity qty = 1 + static_cast<Quantity>(rng() % 20);
+            ASSERT_EQ(describe(map_book.modifyOrder(target, px, qty, "MOD")),
+                      describe(ladder_book.modifyOrder(target, px, qty, "MOD")));
+            continue;
+        }
+
+        Side side = (rng() & 1) ? Side::Buy : Side::Sell;
+        int64_t center = side == Side::Buy ? 1995 : 2005;
+        Price px = ticks(center + static_cast<int>(rng() % 200) - 100);
+        Quantity qty = 1 + static_cast<Quantity>(rng() % 20);
+        TimeInForce tif = (rng() % 8 == 0) ? TimeInForce::IOC : TimeInForce::Day;
+
+        Order* pair[2];
+        for (Order*& o : pair) {
+            auto order = std::make_unique<Order>();
+            order->order_id = id;
+            order->security_id = 1;
+            order->side = side;
+            order->price = px;
+            order->quantity = qty;
+            order->time_in_force = tif;
+            o = order.get();
+            owned.push_back(std::move(order));
+        }
+        ASSERT_EQ(describe(map_book.addOrder(pair[0])),
+                  describe(ladder_book.addOrder(pair[1])));
+        live.push_back(id);
+    }
+
+    EXPECT_EQ(map_book.bestBid(), ladder_book.bestBid());
+    EXPECT_EQ(map_book.bestAsk(), ladder_book.bestAsk());
+    EXPECT_EQ(map_book.bidLevelCount(), ladder_book.bidLevelCount());
+    EXPECT_EQ(map_book.askLevelCount(), ladder_book.askLevelCount());
+}
+
+// FOK and MinQty pre-checks use the depth tree on the ladder and a level
+// walk on the map; both must accept and reject exactly the same orders,
+// including with iceberg reserve resting.
+TEST(LadderOrderBookTest, FillabilityChecksMatchMapBackend) {
+    OrderBook map_book(1);
+    OrderBook ladder_book(1, ladderConfig(64));
+    std::vector<std::unique_ptr<Order>> owned;
+    std::vector<OrderId> live;
+    int fok_rejects = 0;
+    int min_qty_rejects = 0;
+
+    std::mt19937 rng(777);
+    for (OrderId id = 1; id <= 4000; ++id) {
+        if (rng() % 10 == 0 && !live.empty()) {
+            OrderId victim = live[rng() % live.size()];
+            ASSERT_EQ(describeEvents(map_book.cancelOrder(victim)),
+                      describeEvents(ladder_book.cancelOrder(victim)));
+            continue;
+        }
+
+        Side side = (rng() & 1) ? Side::Buy : Side::Sell;
+        int64_t center = side == Side::Buy ? 1995 : 2005;
+        Price px = ticks(center + static_cast<int>(rng() % 120) - 60);
+        Quantity qty = 1 + static_cast<Quantity>(rng() % 60);
+        int kind = static_cast<int>(rng() % 8);
+
+        Order* pair[2];
+        for (Order*& o : pair) {
+            auto order = std::make_unique<Order>();
+            order->order_id = id;
+            order->security_id = 1;
+            order->side = side;
+            order->price = px;
+            order->quantity = qty;
+            if (kind == 0) order->time_in_force = TimeInForce::FOK;
+            if (kind == 1) order->min_qty = 1 + qty / 2;
+            if (kind == 2) order->display_qty = 1 + qty / 4;
+            o = order.get();
+            owned.push_back(std::move(order));
+        }
+        std::string map_events = describeEvents(map_book.addOrder(pair[0]));
+        ASSERT_EQ(map_events, describeEvents(ladder_book.addOrder(pair[1])));
+        if (map_events.starts_with("REJ " + std::to_string(int(RejectReason::FokNotFillable)))) {
+            ++fok_rejects;
+        }
+        if (map_events.starts_with("REJ " + std::to_string(int(RejectReason::MinQtyNotFillable)))) {
+            ++min_qty_rejects;
+        }
+        live.push_back(id);
+    }
+    // The flow exercises both outcomes of both checks
+    EXPECT_GT(fok_rejects, 0);
+    EXPECT_GT(min_qty_rejects, 0);
+}
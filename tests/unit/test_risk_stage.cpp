@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "gateway/risk_stage.h"
+#include "engine/full_matching_engine.h"
+#include "instruments/instrument_manager.h"
+#include <memory>
+#include <vector>
+
+using namespace cme::sim;
+using namespace cme::sim::gateway;
+
+namespace {
+
+class RiskStageTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config::InstrumentConfig es;
+        es.symbol = "ESH5";
+        es.security_id = 1;
+        es.channel_id = 310;
+        es.tick_size = 0.25;
+        es.max_position = 10;
+        instruments_.loadFromConfig({es}, {});
+
+        risk_.max_price_deviation_pct = 10.0;
+        risk_.max_position_per_session = 50000;
+        stage_ = std::make_unique<RiskStage>(risk_, instruments_);
+
+        EngineLayout layout;
+        layout.instruments = {{1, {}}};
+        engine_ = std::make_unique<FullMatchingEngine>(layout);
+    }
+
+    static Order makeOrder(uint64_t session, Side side, double price, Quantity qty,
+                           TimeInForce tif = TimeInForce::Day) {
+        Order o;
+        o.security_id = 1;
+        o.session_uuid = session;
+        o.side = side;
+        o.price = Price::fromDouble(price);
+        o.quantity = qty;
+        o.time_in_force = tif;
+        o.cl_ord_id = "RISK";
+        return o;
+    }
+
+    // One new order through the risk checks and the engine, the way an
+    // engine shard runs it
+    RejectReason submit(uint64_t session, Side side, double price, Quantity qty,
+                        TimeInForce tif = TimeInForce::Day) {
+        EngineCommand cmd;
+        cmd.session_uuid = session;
+        cmd.order = makeOrder(session, side, price, qty, tif);
+
+        RejectReason reason = stage_->checkNewOrder(cmd.order);
+        if (reason != RejectReason::None) return reason;
+        run({cmd});
+        stage_->releaseNewOrder(cmd.order);
+        return RejectReason::None;
+    }
+
+    void run(std::vector<EngineCommand> batch) {
+        EventSink events;
+        std::vector<EventRange> ranges;
+        engine_->processBatch(batch, events, ranges);
+        stage_->apply(events.since(0));
+        for (const auto& event : events.events()) {
+            if (const auto* accepted = std::get_if<OrderAccepted>(&event)) {
+                last_order_id_ = accepted->order_id;
+            }
+        }
+    }
+
+    InstrumentManager instruments_;
+    config::RiskConfig risk_;
+    std::unique_ptr<RiskStage> stage_;
+    std::unique_ptr<FullMatchingEngine> engine_;
+    OrderId last_order_id_ = 0;
+};
+
+} // namespace
+
+TEST_F(RiskStageTest, WorstCasePositionCountsOpenOrdersAndFills) {
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 6), RejectReason::None);
+    EXPECT_EQ(stage_->openQty(1, 1, Side::Buy), 6);
+    EXPECT_EQ(submit(1, Side::Buy, 99.0, 5), RejectReason::PositionLimit);
+    EXPECT_EQ(submit(1, Side::Sell, 105.0, 8), RejectReason::None);  // other side
+
+    // Session 2 sells into the bid: session 1 is now long 6, nothing open
+    EXPECT_EQ(submit(2, Side::Sell, 100.0, 6, TimeInForce::IOC), RejectReason::None);
+    EXPECT_EQ(stage_->position(1, 1), 6);
+    EXPECT_EQ(stage_->position(2, 1), -6);
+    EXPECT_EQ(stage_->openQty(1, 1, Side::Buy), 0);
+    EXPECT_EQ(stage_->openQty(2, 1, Side::Sell), 0);   // IOC remainder released
+
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 4), RejectReason::None);
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 1), RejectReason::PositionLimit);
+    // Being long makes room on the sell side: -6 + 8 open + 8 more = 10
+    EXPECT_EQ(submit(1, Side::Sell, 106.0, 8), RejectReason::None);
+
+    // Cancelling that sell releases its hold
+    EngineCommand cancel;
+    cancel.type = EngineCommand::Type::CancelOrder;
+    cancel.session_uuid = 1;
+    cancel.security_id = 1;
+    cancel.order_id = last_order_id_;
+    run({cancel});
+    EXPECT_EQ(stage_->openQty(1, 1, Side::Sell), 8);
+}
+
+TEST_F(RiskStageTest, PriceBandFollowsTheLastTrade) {
+    // No band before the first trade
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 1), RejectReason::None);
+    EXPECT_EQ(submit(2, Side::Sell, 100.0, 1), RejectReason::None);   // trades at 100
+
+    EXPECT_EQ(submit(1, Side::Buy, 111.0, 1), RejectReason::PriceBand);
+    EXPECT_EQ(submit(1, Side::Sell, 89.0, 1), RejectReason::PriceBand);
+    EXPECT_EQ(submit(1, Side::Buy, 90.0, 2), RejectReason::None);
+    OrderId resting = last_order_id_;
+
+    RiskStage::ModifyHold hold;
+    EXPECT_EQ(stage_->checkModify(1, resting, Price::fromDouble(120.0), 2, hold),
+              RejectReason::PriceBand);
+    EXPECT_EQ(stage_->checkModify(1, resting, Price::fromDouble(91.0), 2, hold),
+              RejectReason::None);
+    EXPECT_EQ(hold.qty, 0);                   // adds nothing
+    EXPECT_EQ(stage_->checkModify(1, resting, Price::fromDouble(91.0), 11, hold),
+              RejectReason::PositionLimit);   // long 1, 2 open, 9 more
+    EXPECT_EQ(stage_->checkModify(2, resting, Price::fromDouble(120.0), 2, hold),
+              RejectReason::None);            // not session 2's order: the engine decides
+}
+
+TEST_F(RiskStageTest, ModifiesInOneBatchShareTheLimit) {
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 1), RejectReason::None);
+    EXPECT_EQ(submit(2, Side::Sell, 100.0, 1), RejectReason::None);   // long 1
+    EXPECT_EQ(submit(1, Side::Buy, 95.0, 2), RejectReason::None);
+    OrderId first = last_order_id_;
+    EXPECT_EQ(submit(1, Side::Buy, 96.0, 2), RejectReason::None);
+    OrderId second = last_order_id_;
+
+    // Checked back to back, as one batch drains them: the first one's
+    // added 2 counts against the second
+    RiskStage::ModifyHold first_hold, second_hold;
+    EXPECT_EQ(stage_->checkModify(1, first, Price::fromDouble(95.0), 4, first_hold),
+              RejectReason::None);
+    EXPECT_EQ(first_hold.qty, 2);
+    EXPECT_EQ(stage_->openQty(1, 1, Side::Buy), 6);
+    EXPECT_EQ(stage_->checkModify(1, second, Price::fromDouble(96.0), 6, second_hold),
+              RejectReason::PositionLimit);   // 1 + 6 + 4 more
+    EXPECT_EQ(second_hold.qty, 0);
+
+    EngineCommand modify;
+    modify.type = EngineCommand::Type::ModifyOrder;
+    modify.session_uuid = 1;
+    modify.security_id = 1;
+    modify.order_id = first;
+    modify.new_price = Price::fromDouble(95.0);
+    modify.new_qty = 4;
+    modify.new_cl_ord_id = "RISKMOD";
+    run({modify});
+    stage_->releaseModify(first_hold);
+    EXPECT_EQ(stage_->openQty(1, 1, Side::Buy), 6);   // the engine's leaves now
+
+    EXPECT_EQ(stage_->checkModify(1, second, Price::fromDouble(96.0), 5, second_hold),
+              RejectReason::None);            // 1 + 6 + 3 = 10
+}
+
+TEST_F(RiskStageTest, PositionsAndLimitsSurviveACheckpoint) {
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 6), RejectReason::None);
+    EXPECT_EQ(submit(2, Side::Sell, 100.0, 6, TimeInForce::IOC), RejectReason::None);
+    EXPECT_EQ(submit(1, Side::Buy, 99.0, 3), RejectReason::None);   // rests
+
+    std::vector<checkpoint::Position> positions = stage_->positions();
+    EXPECT_EQ(positions, (std::vector<checkpoint::Position>{{1, 1, 6}, {2, 1, -6}}));
+
+    // A fresh stage seeded the way a warm restart does it
+    RiskStage restored(risk_, instruments_);
+    restored.restore(engine_->snapshot(), positions);
+    EXPECT_EQ(restored.position(1, 1), 6);
+    EXPECT_EQ(restored.position(2, 1), -6);
+    EXPECT_EQ(restored.openQty(1, 1, Side::Buy), 3);
+
+    // Still at 9 of 10 on the buy side, and the band still set by the 100 trade
+    EXPECT_EQ(restored.checkNewOrder(makeOrder(1, Side::Buy, 99.0, 2)),
+              RejectReason::PositionLimit);
+    EXPECT_EQ(restored.checkNewOrder(makeOrder(2, Side::Sell, 101.0, 5)),
+              RejectReason::PositionLimit);
+    EXPECT_EQ(restored.checkNewOrder(makeOrder(2, Side::Buy, 89.0, 1)),
+              RejectReason::PriceBand);
+    EXPECT_EQ(restored.checkNewOrder(makeOrder(1, Side::Buy, 99.0, 1)), RejectReason::None);
+}
+
+TEST_F(RiskStageTest, SessionRowsAreRecycledOnceFlat) {
+    EXPECT_EQ(submit(1, Side::Buy, 100.0, 2), RejectReason::None);
+    EXPECT_EQ(submit(2, Side::Sell, 100.0, 2, TimeInForce::IOC), RejectReason::None);
+    EXPECT_EQ(stage_->trackedSessions(), 2u);
+
+    // Trade back to flat: neither session has anything left to track
+    EXPECT_EQ(submit(2, Side::Buy, 100.0, 2), RejectReason::None);
+    EXPECT_EQ(submit(1, Side::Sell, 100.0, 2, TimeInForce::IOC), RejectReason::None);
+    EXPECT_EQ(stage_->position(1, 1), 0);
+    EXPECT_EQ(stage_->trackedSessions(), 0u);
+
+    // A run of sessions whose orders never rest keeps no rows
+    for (uint64_t session = 10; session < 1010; ++session) {
+        EXPECT_EQ(submit(session, Side::Buy, 100.0, 1, TimeInForce::IOC), RejectReason::None);
+    }
+    EXPECT_EQ(stage_->trackedSessions(), 0u);
+
+    // UUIDs are not row numbers: a large one is still limited
+    EXPECT_EQ(submit(uint64_t{1} << 40, Side::Buy, 100.0, 11), RejectReason::PositionLimit);
+    EXPECT_EQ(submit(uint64_t{1} << 40, Side::Buy, 100.0, 10), RejectReason::None);
+    EXPECT_EQ(stage_->openQty(uint64_t{1} << 40, 1, Side::Buy), 10);
+
+    // Only the liquidity provider goes unchecked
+    EXPECT_EQ(submit(LiquidityProvider::SESSION_UUID, Side::Sell, 101.0, 1000),
+              RejectReason::None);
+    EXPECT_EQ(stage_->trackedSessions(), 1u);
+}
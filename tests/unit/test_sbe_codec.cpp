@@ -442,6 +442,126 @@ TEST(SBECodec, OrderCancelRequest516Roundtrip) {
     EXPECT_EQ(len, orig.encodedLength());
 }
 
+TEST(SBECodec, OrderMassActionRequest529Roundtrip) {
+    OrderMassActionRequest529 orig;
+    orig.orderRequestID = 12;
+    orig.seqNum = 9;
+    orig.securityID = 888;
+    orig.massActionScope = OrderMassActionRequest529::SCOPE_INSTRUMENT;
+    orig.side = 2;
+
+    char buf[256];
+    size_t len = orig.encode(buf, 0);
+
+    OrderMassActionRequest529 decoded;
+    decoded.decode(buf, 0);
+
+    EXPECT_EQ(decoded.orderRequestID, 12u);
+    EXPECT_EQ(decoded.seqNum, 9u);
+    EXPECT_EQ(decoded.securityID, 888);
+    EXPECT_EQ(decoded.massActionScope, OrderMassActionRequest529::SCOPE_INSTRUMENT);
+    EXPECT_EQ(decoded.side, 2u);
+    EXPECT_EQ(len, orig.encodedLength());
+}
+
+TEST(SBECodec, RequestViewsReadInPlaceAndRejectTruncatedMessages) {
+    NewOrderSingle514 nos;
+    nos.price = 500025000000LL;
+    nos.orderQty = 7;
+    nos.securityID = 17;
+    nos.side = 2;
+    nos.seqNum = 3;
+    writeFixedString(nos.clOrdID, "VIEW01", 20);
+    nos.orderRequestID = 55;
+    nos.stopPx = 499900000000LL;
+    nos.minQty = 2;
+    nos.displayQty = 5;
+    nos.ordType = 4;
+    nos.timeInForce = 3;
+
+    char buf[256];
+    size_t len = nos.encode(buf, 0);
+
+    NewOrderSingle514View view;
+    ASSERT_TRUE(view.wrap(buf, len));
+    EXPECT_EQ(view.price(), nos.price);
+    EXPECT_EQ(view.orderQty(), 7u);
+    EXPECT_EQ(view.securityID(), 17);
+    EXPECT_EQ(view.side(), 2u);
+    EXPECT_EQ(view.seqNum(), 3u);
+    EXPECT_EQ(view.clOrdID(), buf + MessageHeader::SIZE + 41);  // no copy
+    EXPECT_EQ(view.orderRequestID(), 55u);
+    EXPECT_EQ(view.stopPx(), nos.stopPx);
+    EXPECT_EQ(view.minQty(), 2u);
+    EXPECT_EQ(view.displayQty(), 5u);
+    EXPECT_EQ(view.ordType(), 4u);
+    EXPECT_EQ(view.timeInForce(), 3u);
+    EXPECT_FALSE(view.wrap(buf, len - 1));
+
+    OrderCancelReplaceRequest515 modify;
+    modify.price = 123;
+    modify.orderQty = 4;
+    modify.orderID = 77;
+    modify.orderRequestID = 66;
+    len = modify.encode(buf, 0);
+    OrderCancelReplaceRequest515View modify_view;
+    ASSERT_TRUE(modify_view.wrap(buf, len));
+    EXPECT_EQ(modify_view.price(), 123);
+    EXPECT_EQ(modify_view.orderQty(), 4u);
+    EXPECT_EQ(modify_view.orderID(), 77u);
+    EXPECT_EQ(modify_view.orderRequestID(), 66u);
+    EXPECT_FALSE(modify_view.wrap(buf, MessageHeader::SIZE));
+
+    OrderCancelRequest516 cancel;
+    cancel.orderID = 300;
+    cancel.securityID = 888;
+    cancel.orderRequestID = 44;
+    len = cancel.encode(buf, 0);
+    OrderCancelRequest516View cancel_view;
+    ASSERT_TRUE(cancel_view.wrap(buf, len));
+    EXPECT_EQ(cancel_view.orderID(), 300u);
+    EXPECT_EQ(cancel_view.securityID(), 888);
+    EXPECT_EQ(cancel_view.orderRequestID(), 44u);
+
+    OrderMassActionRequest529 mass;
+    mass.orderRequestID = 12;
+    mass.securityID = 888;
+    mass.massActionScope = OrderMassActionRequest529::SCOPE_INSTRUMENT;
+    mass.side = 1;
+    len = mass.encode(buf, 0);
+    OrderMassActionRequest529View mass_view;
+    ASSERT_TRUE(mass_view.wrap(buf, len));
+    EXPECT_EQ(mass_view.orderRequestID(), 12u);
+    EXPECT_EQ(mass_view.securityID(), 888);
+    EXPECT_EQ(mass_view.massActionScope(), OrderMassActionRequest529::SCOPE_INSTRUMENT);
+    EXPECT_EQ(mass_view.side(), 1u);
+    EXPECT_FALSE(mass_view.wrap(buf, len - 1));
+}
+
+TEST(SBECodec, OrderMassActionReport562Roundtrip) {
+    OrderMassActionReport562 orig;
+    orig.seqNum = 4;
+    orig.uuid = 42;
+    orig.orderRequestID = 12;
+    orig.securityID = 888;
+    orig.massActionScope = 1;
+    orig.totalAffectedOrders = 37;
+
+    char buf[256];
+    size_t len = orig.encode(buf, 0);
+
+    OrderMassActionReport562 decoded;
+    decoded.decode(buf, 0);
+
+    EXPECT_EQ(decoded.uuid, 42u);
+    EXPECT_EQ(decoded.orderRequestID, 12u);
+    EXPECT_EQ(decoded.securityID, 888);
+    EXPECT_EQ(decoded.massActionType, OrderMassActionReport562::TYPE_CANCEL);
+    EXPECT_EQ(decoded.massActionResponse, OrderMassActionReport562::RESPONSE_ACCEPTED);
+    EXPECT_EQ(decoded.totalAffectedOrders, 37u);
+    EXPECT_EQ(len, orig.encodedLength());
+}
+
 TEST(SBECodec, ExecutionReportCancel534Roundtrip) {
     ExecutionReportCancel534 orig;
     orig.seqNum = 3;
@@ -749,6 +869,42 @@ TEST(SBECodec, PriceComparison) {
     EXPECT_TRUE(p101 >= p100);
 }
 
+// ===========================================================================
+// ClOrdId Tests
+// ===========================================================================
+
+TEST(SBECodec, ClOrdIdFixedFieldRoundtrip) {
+    using cme::sim::ClOrdId;
+
+    ClOrdId id = "ORD-42";
+    EXPECT_EQ(id.view(), "ORD-42");
+    EXPECT_FALSE(id.empty());
+    EXPECT_TRUE(ClOrdId{}.empty());
+
+    NewOrderSingle514 orig;
+    writeFixedString(orig.clOrdID, id, 20);
+    char buf[256];
+    orig.encode(buf, 0);
+
+    NewOrderSingle514 decoded;
+    decoded.decode(buf, 0);
+    ClOrdId back;
+    readFixedString(back, decoded.clOrdID, 20);
+    EXPECT_EQ(back, id);
+
+    // A full 20-byte ID has no terminator on the wire
+    ClOrdId full = std::string(25, 'X');
+    EXPECT_EQ(full.size(), 20u);
+    char field[20];
+    writeFixedString(field, full, 20);
+    readFixedString(back, field, 20);
+    EXPECT_EQ(back, full);
+
+    // Bytes after the first NUL do not affect equality
+    char padded[20]{'A', 'B', '\0', 'Z'};
+    EXPECT_EQ(ClOrdId::fromWire(padded), ClOrdId("AB"));
+}
+
 // ===========================================================================
 // GroupSize Tests
 // ===========================================================================
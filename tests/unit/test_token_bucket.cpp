@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "gateway/token_bucket.h"
+#include "gateway/risk_manager.h"
+
+using namespace cme::sim;
+using namespace cme::sim::gateway;
+
+TEST(TokenBucketTest, BurstThenSustainedRate) {
+    TokenBucket bucket(100, 5, 1000);  // 100/s sustained, 5 back to back
+
+    for (int i = 0; i < 5; ++i) EXPECT_TRUE(bucket.tryTake(1000));
+    EXPECT_FALSE(bucket.tryTake(1000));
+    EXPECT_FALSE(bucket.tryTake(1009));   // 0.9 of a token after 9 ms
+    EXPECT_TRUE(bucket.tryTake(1010));    // the 10th ms completes it
+    EXPECT_FALSE(bucket.tryTake(1010));
+
+    EXPECT_FALSE(bucket.tryTake(1005));   // a clock step back refills nothing
+    EXPECT_TRUE(bucket.tryTake(1030));    // 2 tokens accrued, 1 taken
+    EXPECT_EQ(bucket.available(), 1u);
+
+    EXPECT_TRUE(bucket.tryTake(60'000));  // a long idle refills only to the burst
+    EXPECT_EQ(bucket.available(), 4u);
+}
+
+TEST(TokenBucketTest, RiskManagerBurstDefaultsToOneSecond) {
+    config::RiskConfig cfg;
+    cfg.max_orders_per_second = 3;
+    RiskManager risk(cfg);
+
+    TokenBucket bucket = risk.makeRateLimit();
+    EXPECT_EQ(bucket.available(), 3u);
+    for (int i = 0; i < 3; ++i) EXPECT_TRUE(risk.checkRate(bucket).passed);
+    auto result = risk.checkRate(bucket);
+    EXPECT_FALSE(result.passed);
+    EXPECT_FALSE(result.reason.empty());
+
+    cfg.max_order_burst = 1;
+    EXPECT_EQ(RiskManager(cfg).makeRateLimit().available(), 1u);
+}
@@ -273,6 +273,29 @@ static void sendCancel(tcp::socket& sock, ClientSession& session,
     tprint("[CLIENT] Sent OrderCancelRequest516: OrderID=", orderID, "\n");
 }
 
+// ---------------------------------------------------------------------------
+// Send OrderMassActionRequest529 (securityID 0 = all instruments)
+// ---------------------------------------------------------------------------
+static void sendMassCancel(tcp::socket& sock, ClientSession& session,
+                           int32_t securityID) {
+    char buf[4096];
+    OrderMassActionRequest529 mar;
+    mar.orderRequestID = session.nextOrderRequestID++;
+    mar.seqNum = session.nextOutSeqNo++;
+    mar.sendingTimeEpoch = nowNanos();
+    mar.securityID = securityID;
+    mar.massActionScope = securityID != 0
+        ? OrderMassActionRequest529::SCOPE_INSTRUMENT
+        : OrderMassActionRequest529::SCOPE_MARKET_SEGMENT;
+    writeFixedString(mar.senderID, "TestClient", 20);
+    writeFixedString(mar.location, "US,NY", 5);
+
+    size_t sbeLen = mar.encode(buf, 0);
+    sendFramed(sock, buf, sbeLen);
+
+    tprint("[CLIENT] Sent OrderMassActionRequest529: SecurityID=", securityID, "\n");
+}
+
 // ---------------------------------------------------------------------------
 // Send OrderCancelReplaceRequest515
 // ---------------------------------------------------------------------------
@@ -417,6 +440,18 @@ static void processMessage(const char* data, size_t len, ClientSession& session)
                " Reason=", cr.cxlRejReason, "\n");
         break;
     }
+    case OrderMassActionReport562::TEMPLATE_ID: {
+        OrderMassActionReport562 mr;
+        mr.decode(data, 0);
+        if (mr.massActionResponse == OrderMassActionReport562::RESPONSE_ACCEPTED) {
+            tprint("[CLIENT] << Mass cancel done: ", mr.totalAffectedOrders,
+                   " order(s) cancelled\n");
+        } else {
+            tprint("[CLIENT] << Mass cancel rejected: Reason=",
+                   static_cast<int>(mr.massActionRejectReason), "\n");
+        }
+        break;
+    }
     case Sequence506::TEMPLATE_ID: {
         Sequence506 seq;
         seq.decode(data, 0);
@@ -513,6 +548,7 @@ static void interactiveLoop(tcp::socket& sock, ClientSession& session) {
     tprint("  sell SECURITY_ID QTY PRICE  - Send sell order\n");
     tprint("  cancel ORDER_ID             - Cancel an order\n");
     tprint("  modify ORDER_ID QTY PRICE   - Modify an order\n");
+    tprint("  masscancel [SECURITY_ID]    - Cancel all own orders (in one instrument)\n");
     tprint("  status                      - Show session state\n");
     tprint("  orders                      - Show tracked orders\n");
     tprint("  quit                        - Terminate session\n\n");
@@ -547,6 +583,10 @@ static void interactiveLoop(tcp::socket& sock, ClientSession& session) {
                 continue;
             }
             sendCancel(sock, session, orderId);
+        } else if (cmd == "masscancel") {
+            int32_t secId = 0;
+            iss >> secId;
+            sendMassCancel(sock, session, secId);
         } else if (cmd == "modify") {
             uint64_t orderId;
             uint32_t qty;
@@ -0,0 +1,155 @@
+// journal_replay - replay an engine journal into a fresh matching engine
+// Usage: journal_replay JOURNAL_FILE [--repeat N] [--checkpoint FILE]
+//
+// Rebuilds the engine the journal was written by (same books, spreads and
+// implied depth), decodes every batch into memory up front and then runs
+// them through processBatch() back to back, as fast as the engine goes.
+// Each replay checks that new orders get the OrderIds they were given when
+// the journal was recorded, and reports the first batch that diverges.
+// A journal recorded after a warm start replays on top of the checkpoint
+// the exchange started from (--checkpoint).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "checkpoint/checkpoint.h"
+#include "engine/engine_event.h"
+#include "engine/event_sink.h"
+#include "engine/full_matching_engine.h"
+#include "engine/matching_engine.h"
+#include "journal/journal_format.h"
+#include "journal/journal_reader.h"
+
+using namespace cme::sim;
+
+namespace {
+
+struct ReplayResult {
+    std::size_t commands = 0;
+    std::size_t events = 0;
+    std::chrono::nanoseconds elapsed{0};
+    bool diverged = false;
+};
+
+ReplayResult replay(const EngineLayout& layout, const EngineSnapshot* start,
+                    const std::vector<journal::JournalBatch>& batches) {
+    ReplayResult result;
+    auto engine = std::make_unique<FullMatchingEngine>(layout);
+    if (start && !engine->restore(*start)) {
+        std::cerr << "Checkpoint does not fit the journal's books\n";
+        result.diverged = true;
+        return result;
+    }
+    EventSink events(4096);
+    std::vector<EventRange> ranges;
+
+    for (const auto& batch : batches) {
+        events.clear();
+        auto start = std::chrono::steady_clock::now();
+        engine->processBatch(batch.commands, events, ranges);
+        result.elapsed += std::chrono::steady_clock::now() - start;
+        result.commands += batch.commands.size();
+        result.events += events.size();
+
+        if (result.diverged) continue;
+        for (std::size_t i = 0; i < batch.commands.size(); ++i) {
+            if (batch.commands[i].type != EngineCommand::Type::NewOrder) continue;
+            OrderId got = journal::assignedOrderId(events.range(ranges[i].first, ranges[i].count));
+            if (got != batch.expected_ids[i]) {
+                std::cerr << "Divergence in batch " << batch.batch_seq << ", command " << i
+                          << ": journal has OrderId " << batch.expected_ids[i]
+                          << ", replay assigned " << got << "\n";
+                result.diverged = true;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string checkpoint_path;
+    int repeat = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpoint_path = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: journal_replay JOURNAL_FILE [OPTIONS]\n"
+                      << "  --repeat N        Replay N times, each into a fresh engine"
+                      << " (default: 1)\n"
+                      << "  --checkpoint FILE Start from this checkpoint's state of the"
+                      << " journal's shard\n"
+                      << "  --help            Show this help\n";
+            return 0;
+        } else {
+            path = arg;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: journal_replay JOURNAL_FILE [--repeat N] [--checkpoint FILE]\n";
+        return EXIT_FAILURE;
+    }
+
+    journal::JournalReader reader(path);
+    if (!reader.open()) {
+        std::cerr << path << ": not a readable engine journal\n";
+        return EXIT_FAILURE;
+    }
+
+    // Decode everything first so only the engine is timed
+    std::vector<journal::JournalBatch> batches;
+    journal::JournalBatch batch;
+    while (reader.nextBatch(batch)) batches.push_back(batch);
+
+    const EngineLayout& layout = reader.layout();
+
+    // The journal's shard as the exchange started from the checkpoint
+    std::optional<EngineSnapshot> start;
+    if (!checkpoint_path.empty()) {
+        checkpoint::Checkpoint ckpt;
+        std::string error;
+        if (!checkpoint::loadCheckpoint(checkpoint_path, ckpt, error)) {
+            std::cerr << error << "\n";
+            return EXIT_FAILURE;
+        }
+        for (auto& snap : ckpt.engines) {
+            if (snap.shard_id == layout.shard_id) start = std::move(snap);
+        }
+        if (!start) {
+            std::cerr << checkpoint_path << ": no engine shard "
+                      << static_cast<int>(layout.shard_id) << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << path << ": shard " << static_cast<int>(layout.shard_id) << ", "
+              << layout.instruments.size() << " instruments, " << layout.spreads.size()
+              << " spreads, " << reader.recordCount() << " commands in " << batches.size()
+              << " batches\n";
+
+    bool diverged = false;
+    for (int run = 1; run <= repeat; ++run) {
+        ReplayResult result = replay(layout, start ? &*start : nullptr, batches);
+        double secs = std::chrono::duration<double>(result.elapsed).count();
+        double rate = secs > 0 ? static_cast<double>(result.commands) / secs : 0.0;
+        std::cout << "Run " << run << ": " << result.commands << " commands, " << result.events
+                  << " events in " << secs * 1e3 << " ms (" << static_cast<uint64_t>(rate)
+                  << " commands/sec)" << (result.diverged ? " DIVERGED" : "") << "\n";
+        diverged = diverged || result.diverged;
+    }
+    return diverged ? EXIT_FAILURE : EXIT_SUCCESS;
+}